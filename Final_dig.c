@@ -5,7 +5,7 @@
  * Este archivo contiene la lógica principal para controlar una máquina bobinadora de hilo
  * utilizando una Raspberry Pi Pico. Integra una pantalla OLED, un encoder óptico,
  * un servomotor, un motor de corriente continua, un encoder rotatorio con un botón,
- * y una celda de carga simulada (HX711) para monitoreo de tensión.
+ * y una celda de carga (HX711) para monitoreo de tensión.
  *
  * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
  * @date 17 de julio de 2025
@@ -17,7 +17,39 @@
 #include "hardware/gpio.h"
 #include "hardware/pwm.h"
 #include "hardware/i2c.h"
+#include "hardware/watchdog.h"
+#include "hardware/sync.h"
 #include "ssd1306.h"    // Librería de la pantalla OLED
+#include "traslado.h"   // Planificador del traslado del hilo
+#include "servo_pio.h"  // Salida de servo generada por PIO
+#include "stepper.h"    // Traslado con motor paso a paso
+#include "interpolador.h" // Interpoladores por hardware del RP2040
+#include "analogico.h"  // Adquisición analógica por ADC y DMA
+#include "material.h"   // Perfiles de material
+#include "corriente.h"  // Protección del motor por corriente
+#include "rotura.h"     // Sensor de rotura del hilo
+#include "fallas.h"     // Gestor central de fallas
+#include "tension.h"    // Estimador de la tensión del hilo
+#include "motor.h"      // Velocidad del motor del tambor por PWM
+#include "anomalia.h"   // Detección temprana de degradación del hilo
+#include "velocidad.h"  // Planificador de velocidad del tambor
+#include "resonancia.h" // Bandas de velocidad resonantes
+#include "pid.h"        // Regulador PID de los lazos
+#include "autoajuste.h" // Autoajuste de PID por relé
+#include "trabajo.h"    // Descripción de los trabajos de bobinado
+#include "aprendizaje.h" // Aprendizaje de la velocidad máxima por material
+#include "almacen.h"    // Almacén de registros en flash
+#include "persistencia.h" // Escrituras en flash diferidas al reposo
+#include "respaldo.h"   // Punto de control del bobinado ante un apagón
+#include "lote.h"       // Cola de producción por lotes
+#include "hx711.h"      // Conversor de la celda de carga principal
+#include "hx711_pio.h"  // Celdas de carga de los hilos en paralelo, leídas por PIO
+#include "hilos.h"      // Tensión de cada hilo en el bobinado multifilar
+#include "telemetria.h" // Telemetría binaria por USB
+#include "registro.h"   // Registro diferido de mensajes
+#include "remoto.h"     // Órdenes del PC por USB
+#include "traza.h"      // Traza de los sensores para reproducirla en el banco
+#include "control.h"    // Parámetros y cálculos del tick de control comunes con tools/
 #include <string.h>
 
 // --- Definiciones de Pines ---
@@ -26,11 +58,18 @@
  */
 #define HX711_DT    16  ///< Pin GPIO para el Dato del HX711
 #define HX711_SCK   17  ///< Pin GPIO para el Reloj Serial del HX711
+#define HX711_HILOS_DT  2 ///< Pin DT de la celda del primer hilo en paralelo (los demás en 3, 4 y 5)
+#define HX711_HILOS_SCK 6 ///< Pin del reloj común de las celdas de los hilos en paralelo
 
 #define SERVO_PWM   18  ///< Pin GPIO para la salida PWM del Servo
 
+#define STEPPER_STEP 19 ///< Pin GPIO para la señal STEP del driver del traslado paso a paso
+#define STEPPER_DIR  20 ///< Pin GPIO para la señal DIR del driver del traslado paso a paso
+
 #define OPT_ENCODER_DT 15 ///< Pin GPIO para el Dato del Encoder Óptico
 
+#define SENSOR_ROTURA 14 ///< Pin GPIO del fotointerruptor de rotura/atasco del hilo (1 = hilo roto)
+
 #define OLED_SCL 13     ///< Pin GPIO para el Reloj Serial I2C del OLED
 #define OLED_SDA 12     ///< Pin GPIO para el Dato Serial I2C del OLED
 
@@ -38,36 +77,266 @@
 #define ROT_DT   10     ///< Pin GPIO para el Dato (DT) del Encoder Rotatorio
 #define ROT_CLK  9      ///< Pin GPIO para el Reloj (CLK) del Encoder Rotatorio
 
-#define MOTOR_EN  0     ///< Pin GPIO para Habilitar el Motor (control de Puente H)
+#define MOTOR_EN  0     ///< Pin GPIO para Habilitar el Motor (control de Puente H, PWM de velocidad)
 /** @} */ // fin de PinDefinitions
 
 // --- Constantes de Calibración y Conversión ---
 /** @defgroup Constantes Constantes
  * @{
  */
-#define PULSOS_POR_VUELTA 100         ///< Número de pulsos por vuelta del encoder óptico.
-#define DIAMETRO_TAMBOR_CM 1.4        ///< Diámetro del tambor de bobinado en centímetros.
-#define CM_POR_VUELTA (3.1416 * DIAMETRO_TAMBOR_CM) ///< Centímetros de hilo bobinados por vuelta del tambor.
-#define PULSOS_POR_CM (PULSOS_POR_VUELTA / CM_POR_VUELTA) ///< Pulsos requeridos por centímetro de hilo.
+#define PULSOS_POR_VUELTA 100         ///< Número de pulsos por vuelta del encoder óptico (valor de fábrica).
+#define DIAMETRO_TAMBOR_CM 1.4        ///< Diámetro del tambor de bobinado en centímetros (valor de fábrica).
+#define CM_POR_VUELTA (3.1416 * calibracion.diametro_tambor_cm) ///< Centímetros de hilo bobinados por vuelta del tambor.
+#define PULSOS_POR_CM (calibracion.pulsos_por_vuelta / CM_POR_VUELTA) ///< Pulsos requeridos por centímetro de hilo.
 #define PULSOS_POR_METRO (PULSOS_POR_CM * 100) ///< Pulsos requeridos por metro de hilo.
 #define I2C_PORT i2c0                 ///< Instancia del periférico I2C utilizado para el OLED.
+#define ENROLLEX_BENCH 0              ///< 1: imprime al arrancar el banco de pruebas de los interpoladores.
 #define PWM_DUTY_CYCLE 30             ///< No se usa explícitamente en la configuración del servo, pero es una constante PWM común.
+#define SERVO_BACKEND_PIO 1           ///< 1: pulso del servo generado por PIO (8 ns); 0: PWM por hardware (0.5 us).
+#define SERVO_FRECUENCIA_HZ 50        ///< Frecuencia de marco del servo con PIO (hasta ~300 Hz para servos digitales).
+#define SERVO_CUENTAS_POR_MGRAD_Q20 ((1953u << 20) / 180000) ///< Pendiente PWM: 1953 cuentas por 180000 mgrad, en Q20.
+#define SERVO_NS_POR_MGRAD 5                                 ///< Pendiente PIO (1 ms por 180000 mgrad): parte entera, en ns.
+#define SERVO_NS_POR_MGRAD_FRAC_Q15 ((uint32_t)((1000000ull << 15) / 180000 - (SERVO_NS_POR_MGRAD << 15))) ///< Pendiente PIO: parte fraccionaria en Q15 (error < 3 ns a 180 grados).
+#define TRASLADO_MIN_GRADOS 50        ///< Borde inferior del traslado en grados del servo.
+#define TRASLADO_MAX_GRADOS 130       ///< Borde superior del traslado en grados del servo.
+#define TRASLADO_PASO_MGRAD 2000      ///< Avance del traslado por vuelta del tambor en miligrados (paso del hilo).
+#define TRASLADO_PAUSA_PULSOS 25      ///< Pausa en cada borde en pulsos del encoder (1/4 de vuelta del tambor).
+#define TRASLADO_RETARDO_SERVO_US 60000 ///< Retardo mecánico del servo compensado por adelanto.
+#define TRASLADO_JUEGO_MGRAD 1500     ///< Juego mecánico del servo recuperado en cada inversión.
+#define ADC_MUESTRAS_POR_S 96000      ///< Muestreo total del ADC (32 kS/s por canal en round-robin).
+#define CORRIENTE_MV_POR_A 185        ///< Sensibilidad del sensor de corriente en el pin del ADC (mV/A).
+#define CORRIENTE_CERO_MV 1650        ///< Salida del sensor de corriente a 0 A (mV).
+#define CORRIENTE_ARRANQUE_MS 300     ///< Tiempo tras encender el motor en que se ignora el pico de arranque.
+#define ENCODER_DETENIDO_MS 1000      ///< Tiempo sin pulsos del encoder con el motor encendido que indica tambor bloqueado.
+#define WATCHDOG_MS 8000              ///< Tiempo del watchdog; debe superar la pausa más larga del programa (2 s).
+#define TELEMETRIA_PERIODO_US 1000    ///< Periodo de muestreo de la telemetría por USB (1 kHz).
+#define TRAZA_ARRANQUE_US 1000        ///< Espera entre el inicio de un trabajo y el primer evento reproducido de la traza.
+#define ROTURA_FILTRO_US 2000         ///< Tiempo que debe mantenerse la señal de rotura para confirmarla.
+#define TRASLADO_BACKEND_STEPPER 0    ///< 1: traslado con motor paso a paso (STEP/DIR); 0: servo.
+#define STEPPER_PASOS_POR_GRADO 40    ///< Pasos del motor por grado equivalente del traslado.
+#define STEPPER_VEL_MIN 200           ///< Velocidad de arranque del paso a paso en pasos/s.
+#define STEPPER_VEL_MAX 20000         ///< Velocidad máxima del paso a paso en pasos/s.
+#define STEPPER_ACCEL 200000          ///< Aceleración de las rampas del paso a paso en pasos/s².
+#define MOTOR_PWM_HZ 20000            ///< Frecuencia del PWM de velocidad del motor (inaudible).
+#define MOTOR_VELOCIDAD_NOMINAL 1000  ///< Velocidad de bobinado en milésimas del PWM (1000 = motor siempre habilitado).
+#define MOTOR_VELOCIDAD_MIN 400       ///< Velocidad mínima a la que puede ralentizar la detección de anomalías.
+#define VELOCIDAD_ARRANQUE 300        ///< Velocidad de arranque de la rampa (mínima que mueve el tambor).
+#define VELOCIDAD_RAMPA 500           ///< Rampa normal de velocidad (milésimas/s: 2 s hasta la nominal).
+#define VELOCIDAD_RAMPA_RAPIDA 5000   ///< Rampa dentro de una banda resonante (milésimas/s).
+#define RESONANCIA_PASO 50            ///< Paso entre escalones del barrido de calibración de resonancias.
+#define RESONANCIA_ASENTAMIENTO_MS 300 ///< Espera en cada escalón antes de capturar la vibración.
+#define CLAVE_CALIBRACION 1           ///< Registro del almacén con la calibración del tambor.
+#define CLAVE_RECETA 2                ///< Registro del almacén con los últimos valores introducidos.
+#define CLAVE_CONTADORES 3            ///< Registro del almacén con los contadores de producción.
+#define CLAVE_BANDAS 4                ///< Registro del almacén con las bandas resonantes.
+#define CLAVE_MATERIAL 5              ///< Primer registro del almacén con lo aprendido de cada material.
+#define ALIMENTACION_DIVISOR_Q8 1459  ///< Relación del divisor de 12 V (47k/10k = 5.7) en Q8.
+#define ALIMENTACION_MIN_MV 9000      ///< Alimentación por debajo de la cual se guarda el trabajo y se corta el motor.
+#define ALIMENTACION_PULSOS_PUNTO (calibracion.pulsos_por_vuelta / 2) ///< Pulsos entre puntos de control durante una caída (media vuelta).
+#define PUNTO_CONTROL_MAGICO 0x544E5550u ///< Marca del punto de control en RAM.
+#define PERSISTENCIA_ESPERA_MS 500    ///< Espera desde el último cambio antes de guardar (agrupa escrituras).
+#define PERSISTENCIA_REPOSO_MS 500    ///< Tiempo sin pulsos del encoder para dar el tambor por quieto.
+#define TECHO_PASO_SUBIDA 25          ///< Subida del techo de velocidad tras un trabajo con holgura de tensión.
+#define TECHO_PASO_BAJADA 75          ///< Bajada del techo de velocidad tras una falla o anomalía.
+#define TECHO_MARGEN_PCT 25           ///< Holgura de tensión (% del límite del material) necesaria para subir el techo.
+#define TECHO_REGIMEN_MS 10000        ///< Tiempo mínimo bobinando en el techo para poder subirlo.
+#define VELOCIDAD_CORRECCION_MAX 300  ///< Corrección máxima del lazo de velocidad sobre la referencia (milésimas).
+#define AUTOAJUSTE_U0 700             ///< Punto de operación del ensayo del relé (milésimas del PWM).
+#define AUTOAJUSTE_RELE 100           ///< Amplitud del relé alrededor del punto de operación (milésimas).
+#define AUTOAJUSTE_HISTERESIS_RPM 20  ///< Histéresis del relé; mayor que el ruido de la medida de rpm.
+#define AUTOAJUSTE_EXCURSION_RPM 600  ///< Desvío máximo de velocidad admitido durante el ensayo.
+#define AUTOAJUSTE_PLAZO_MS 20000     ///< Duración máxima del ensayo.
+#define AUTOAJUSTE_REGLA AUTOAJUSTE_TYREUS_LUYBEN ///< Regla de sintonía (ver autoajuste.h): conservadora a propósito.
+#define ANOMALIA_RALENTIZAR_PCT 80    ///< Velocidad que se conserva (%) con cada anomalía detectada.
+#define SW_REBOTE_MS 30               ///< Pulsación mínima del interruptor del encoder rotatorio (rebotes).
+#define SW_LARGO_MS 1500              ///< Pulsación mantenida que termina un trabajo (la corta lo pausa).
+#define LOTE_MAX_BOBINAS 999          ///< Bobinas máximas de un lote.
+#define LOTE_VARIACION_MAX 99         ///< Variación máxima por bobina de un lote (metros o mH).
+#define SECUENCIA_MAX_SEGMENTOS 8     ///< Segmentos máximos de la secuencia guardada.
+#define CLAVE_SECUENCIA (CLAVE_MATERIAL + MATERIAL_NUM) ///< Registro del almacén con la secuencia de segmentos.
+#define CLAVE_MULTIFILAR (CLAVE_SECUENCIA + 1) ///< Registro del almacén con la configuración multifilar.
+#define TRASLADO_MGRAD_POR_MM 4000    ///< Giro del traslado por mm de avance del hilo (el paso de fábrica es 0.5 mm).
+#define MULTIFILAR_TARA_MUESTRAS 16   ///< Lecturas promediadas para la tara de las celdas de los hilos.
 /** @} */ // fin de Constantes
 
 // --- Variables Globales ---
+/**
+ * @brief Calibración del tambor, guardada en flash.
+ */
+typedef struct {
+    uint16_t pulsos_por_vuelta; ///< Pulsos del encoder óptico por vuelta.
+    float diametro_tambor_cm;   ///< Diámetro del tambor.
+} calibracion_t;
+
+/**
+ * @brief Últimos valores introducidos por el operario, guardados en flash.
+ */
+typedef struct {
+    int32_t metros;      ///< Último largo de hilo manual.
+    int32_t milihenrios; ///< Última inductancia de cobre manual.
+    uint16_t lote_cantidad;  ///< Bobinas del último lote.
+    int16_t lote_variacion;  ///< Variación por bobina del último lote.
+} receta_t;
+
+/**
+ * @brief Contadores de producción, guardados en flash al terminar cada bobinado.
+ */
+typedef struct {
+    uint32_t trabajos;  ///< Bobinados empezados.
+    uint32_t completos; ///< Bobinados que alcanzaron el objetivo.
+    uint32_t fallas;    ///< Bobinados terminados por una falla.
+    uint32_t pulsos;    ///< Pulsos del encoder bobinados en total.
+} contadores_t;
+
+/**
+ * @brief Lo aprendido de un material, guardado en flash.
+ */
+typedef struct {
+    pid_ganancias_t pid_velocidad;
+    int32_t rpm_por_milesima_q8;
+    uint16_t velocidad_techo;
+} material_guardado_t;
+
+/**
+ * @brief Estado de un bobinado en curso, para reanudarlo tras un apagón o un reinicio.
+ */
+typedef struct {
+    uint8_t material;            ///< Perfil de material.
+    uint8_t unidad;              ///< `trabajo_unidad_t`.
+    uint8_t detenible;           ///< El trabajo se puede detener con SW.
+    uint8_t secuencia;           ///< Trabajo de la secuencia guardada (segmentos).
+    uint16_t velocidad;          ///< Velocidad pedida por el trabajo.
+    int32_t objetivo_pulsos;     ///< Objetivo del trabajo (0 = continuo).
+    int32_t pulsos;              ///< Pulsos bobinados (los ya procesados por el traslado).
+    traslado_posicion_t posicion; ///< Posición del traslado en la capa.
+    int32_t comando_mgrad;       ///< Última posición comandada al actuador del traslado.
+} punto_control_t;
+
+/**
+ * @brief Punto de control en RAM no inicializada: sobrevive a un reinicio por watchdog.
+ */
+typedef struct {
+    uint32_t magico;    ///< `PUNTO_CONTROL_MAGICO`.
+    punto_control_t p;  ///< Punto de control.
+    uint32_t crc;       ///< CRC-32 de `p`.
+} punto_ram_t;
+
+/**
+ * @brief Bandas resonantes, guardadas en flash.
+ */
+typedef struct {
+    int32_t n;
+    resonancia_banda_t bandas[RESONANCIA_MAX_BANDAS];
+} bandas_guardadas_t;
+
+/**
+ * @brief Bobinado de varios hilos en paralelo, guardado en flash.
+ */
+typedef struct {
+    uint8_t hilos;        ///< Hilos en paralelo; 1 = un solo hilo con la celda principal.
+    uint8_t reservado;
+    uint16_t diametro_um; ///< Diámetro de cada hilo: el paso del traslado es el ancho del haz.
+} multifilar_t;
+
+/**
+ * @brief Secuencia de segmentos (transformador, inductancia con tomas), guardada en flash.
+ */
+typedef struct {
+    uint8_t n;
+    uint8_t reservado[3];
+    trabajo_segmento_t segmentos[SECUENCIA_MAX_SEGMENTOS];
+} secuencia_t;
+
 /** @defgroup GlobalVariables Variables Globales
  * @{
  */
-volatile int menu_state = 0;    ///< Estado actual del menú principal (0: Hilo, 1: Cobre).
+volatile int menu_state = 0;    ///< Estado actual del menú principal (0: Hilo, 1: Cobre, 2: Calibrar, 3: Secuencia).
 volatile int sub_state = 0;     ///< Estado actual del submenú (0: Manual, 1: Auto, 2: Volver).
 volatile int pulsos_encoder = 0; ///< Contador de pulsos del encoder óptico.
+volatile uint32_t ultimo_pulso_us = 0; ///< Instante del último pulso del encoder óptico.
+volatile uint32_t periodo_pulso_us = 0; ///< Tiempo entre los dos últimos pulsos del encoder óptico.
+static traslado_t traslado;      ///< Estado del planificador de traslado del bobinado en curso.
+static control_vigilancia_t vigilancia; ///< Detectores de anomalías sobre la tensión y la velocidad.
+static uint32_t proximo_control_us; ///< Instante del próximo tick de control.
+static bool calibrando = false;     ///< Barrido de calibración en curso (sin reacción a anomalías).
+static const trabajo_t *trabajo_actual = NULL; ///< Trabajo en ejecución, o `NULL`.
+static int material_activo = MATERIAL_HILO; ///< Perfil de material del trabajo en curso.
+static pid_lazo_t lazo_velocidad;   ///< Lazo de velocidad del tambor.
+static autoajuste_t autoajuste;     ///< Ensayo de autoajuste en curso.
+static int32_t rpm_filtrada = 0;    ///< Velocidad del tambor filtrada en el tick de control (rpm).
+static aprendizaje_t aprendizaje;   ///< Holgura de tensión observada en el trabajo en curso.
+static calibracion_t calibracion = { PULSOS_POR_VUELTA, DIAMETRO_TAMBOR_CM }; ///< Calibración vigente del tambor.
+static receta_t receta = { 1, 100, 1, 0 }; ///< Valores iniciales de los selectores.
+static contadores_t contadores;     ///< Contadores de producción.
+static material_guardado_t guardado_material[MATERIAL_NUM]; ///< Copia en RAM de lo aprendido de cada material.
+static bandas_guardadas_t bandas_guardadas; ///< Copia en RAM de las bandas del último barrido completo.
+static secuencia_t secuencia = {    ///< Secuencia de segmentos vigente.
+    .n = 1,
+    .segmentos = { { .material = MATERIAL_COBRE, .pulsos = 100 * PULSOS_POR_VUELTA, .paso_mgrad = TRASLADO_PASO_MGRAD } },
+};
+static uint32_t control_retraso_max_us = 0; ///< Mayor retraso medido de un tick de control.
+static punto_ram_t __uninitialized_ram(punto_ram); ///< Último punto de control (no se borra al reiniciar).
+static volatile bool caida_alimentacion = false; ///< Se detectó una caída de la alimentación en este trabajo.
+static bool caida_respaldada = false; ///< Ya se escribió en flash un punto de control de la caída en curso.
+static int32_t pulsos_respaldados = 0; ///< Pulsos del último punto de control escrito durante la caída.
+static bool pausado = false;        ///< Trabajo en pausa: el tambor se detiene sin terminarlo.
+static uint16_t velocidad_pausa;    ///< Velocidad objetivo al pausar, para reanudar con ella.
+static bool sw_abajo = false;       ///< Interruptor del encoder rotatorio presionado (última lectura).
+static bool sw_ignorar = false;     ///< La pulsación en curso ya se atendió o venía del menú.
+static uint32_t sw_desde_us;        ///< Instante en que se presionó el interruptor.
+static lote_t lote;                 ///< Lote de producción en curso.
+static const char *motivo_pausa = NULL; ///< Título de la pausa en curso; `NULL` = pausa del operario.
+static multifilar_t multifilar = { 1, 0, 500 }; ///< Configuración multifilar vigente.
+static hilos_t hilos;               ///< Tensión de cada hilo en paralelo.
+static int hilo_falla = -1;         ///< Hilo que provocó la última falla de tensión, o -1.
+static remoto_t remoto;             ///< Analizador de las órdenes del PC.
+static bool en_menu = false;        ///< Esperando en el menú principal: se aceptan trabajos del PC.
+static bool en_relevo = false;      ///< Esperando SW entre bobinas de un lote o al terminarlo.
+static bool inicio_remoto = false;  ///< El PC pidió un trabajo; lo arranca el menú principal.
+static uint8_t inicio_material;     ///< Material del trabajo pedido por el PC.
+static uint8_t inicio_modo;         ///< Modo del trabajo pedido por el PC (`remoto_modo_t`).
+static bool traza_pedida = false;   ///< El próximo trabajo reproduce la traza (orden del PC).
+static volatile alarm_id_t alarma_traza = 0; ///< Alarma del próximo evento reproducido; 0 = ninguna.
+static volatile int32_t celda_traza[1 + HILOS_MAX]; ///< Última lectura reproducida de cada celda (canal 0 = principal).
+static volatile uint32_t celda_traza_us[1 + HILOS_MAX]; ///< Instante de esa lectura, en el reloj del equipo.
+static uint32_t desfase_traza_us = 0; ///< Suma a los instantes grabados para llevarlos al reloj del equipo.
+static volatile uint32_t celdas_traza_nuevas = 0; ///< Celdas con una lectura reproducida sin procesar (bit = canal).
+static volatile bool sw_traza = false; ///< Estado de SW reproducido.
+static bool sw_trazado = false;     ///< Último estado de SW grabado en la traza.
 /** @} */ // fin de GlobalVariables
 
 // --- Prototipos de Funciones ---
 void init_gpio();
 void setup_servo();
 void set_servo_angle(int angle);
-void mover_servo_oscilando(int min_angle, int max_angle, int pause_ms);
+void set_servo_mgrados(int32_t mgrad);
+void iniciar_traslado(const traslado_posicion_t *posicion);
+void setup_stepper();
+void setup_analogico();
+bool setup_tension();
+void setup_hilos();
+void detener_por_falla(falla_t falla);
+bool verificar_fallas();
+void armar_protecciones();
+void reiniciar_anomalias(uint32_t ahora);
+void vigilar_anomalias(uint32_t ahora);
+void tick_control(uint32_t ahora);
+void calibrar_resonancias();
+void mostrar_bandas();
+void calibrar_tambor();
+void configurar_multifilar();
+void cargar_ajustes();
+void guardar_material(int material);
+void atender_persistencia();
+void atender_remoto();
+void vigilar_alimentacion(uint16_t valor);
+void ofrecer_reanudar();
+void reanudar_trabajo(const punto_control_t *p);
+trabajo_resultado_t ejecutar_trabajo(const trabajo_t *t);
+void autoajustar_velocidad(int material);
+void enrollar_lote(int material);
+void editar_secuencia();
+void bobinar_secuencia();
 int leer_fuerza();
 void enrollar_auto();
 int seleccionar_mHenrios();
@@ -79,18 +348,153 @@ void enrollar_cobre_auto();
 void mostrar_menu();
 void mostrar_submenu();
 
+// --- Traza de los sensores ---
+/**
+ * @brief Graba un evento de un sensor en la traza.
+ *
+ * Graban la interrupción del encoder y el bucle principal: se escribe con las
+ * interrupciones desactivadas, como el registro diferido.
+ * @param tipo Sensor.
+ * @param canal Canal del sensor.
+ * @param valor Valor leído.
+ * @param ahora Instante de la lectura.
+ */
+static void trazar(traza_tipo_t tipo, uint8_t canal, int32_t valor, uint32_t ahora) {
+    uint32_t estado = save_and_disable_interrupts();
+    traza_anotar(tipo, canal, valor, ahora);
+    restore_interrupts(estado);
+}
+
+/**
+ * @brief Vacía la traza y empieza a grabar, con la tara y la escala actuales en la cabecera.
+ */
+static void grabar_traza() {
+    traza_cabecera_t cabecera = { tension_tara(), calibracion.pulsos_por_vuelta };
+    traza_iniciar(&cabecera);
+}
+
 // --- Rutinas de Servicio de Interrupción (ISR) ---
+/**
+ * @brief Cuenta un pulso del encoder óptico, del sensor o de la traza reproducida.
+ *
+ * Incrementa el contador `pulsos_encoder` y guarda el instante y el periodo del pulso
+ * para detectar el tambor bloqueado y medir la velocidad.
+ * @param ahora Instante del pulso.
+ */
+static void contar_pulso(uint32_t ahora) {
+    pulsos_encoder++;
+    periodo_pulso_us = ahora - ultimo_pulso_us;
+    ultimo_pulso_us = ahora;
+}
+
 /**
  * @brief Rutina de Servicio de Interrupción (ISR) GPIO para el encoder óptico.
  *
  * Esta función es llamada cuando se detecta un flanco de bajada en el pin de datos
- * del encoder óptico. Incrementa el contador `pulsos_encoder`.
+ * del encoder óptico. Graba el flanco en la traza y cuenta el pulso; mientras se
+ * reproduce una traza el sensor se ignora.
  * @param gpio El pin GPIO que activó la interrupción.
  * @param events El tipo de evento que activó la interrupción.
  */
 void gpio_callback(uint gpio, uint32_t events) {
     if (gpio == OPT_ENCODER_DT && (events & GPIO_IRQ_EDGE_FALL)) {
-        pulsos_encoder++;
+        uint32_t ahora = time_us_32();
+        if (traza_reproduciendo()) return; // Los pulsos los da la traza
+        trazar(TRAZA_ENCODER, 0, 0, ahora);
+        contar_pulso(ahora);
+    }
+}
+
+/**
+ * @brief Entrega un evento de la traza reproducida en lugar de su sensor.
+ *
+ * El evento lleva su instante grabado trasladado al reloj del equipo, no el de la alarma
+ * que lo entrega: los periodos del encoder y los intervalos entre lecturas son los de la
+ * planta aunque la alarma se atrase.
+ * @param e Evento.
+ */
+static void aplicar_traza(const traza_evento_t *e) {
+    uint8_t canal = traza_canal(e);
+    uint32_t t = e->t_us + desfase_traza_us;
+    switch (traza_tipo(e)) {
+    case TRAZA_ENCODER:
+        contar_pulso(t);
+        break;
+    case TRAZA_CELDA:
+        if (canal <= HILOS_MAX) {
+            celda_traza[canal] = traza_valor(e);
+            celda_traza_us[canal] = t;
+            celdas_traza_nuevas |= 1u << canal;
+        }
+        break;
+    case TRAZA_SW:
+        sw_traza = traza_valor(e) != 0;
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Alarma de la reproducción: entrega los eventos de este instante y programa el siguiente.
+ *
+ * La alarma se reprograma respecto del instante en que debía sonar, no del que sonó: los
+ * intervalos entre eventos son los grabados y los retrasos no se acumulan. Al acabarse
+ * la traza vuelven los sensores reales.
+ * @return Espera hasta el próximo evento (negativa, ver `add_alarm_in_us()`), o 0 al terminar.
+ */
+static int64_t paso_traza(alarm_id_t id, void *datos) {
+    (void)id;
+    (void)datos;
+    traza_evento_t e, proximo;
+    if (traza_siguiente(&e)) {
+        aplicar_traza(&e);
+        while (traza_proximo(&proximo) && proximo.t_us == e.t_us) { // Eventos simultáneos
+            traza_siguiente(&e);
+            aplicar_traza(&e);
+        }
+        if (traza_proximo(&proximo)) {
+            int32_t espera = (int32_t)(proximo.t_us - e.t_us);
+            return -(int64_t)(espera > 0 ? espera : 1);
+        }
+    }
+    alarma_traza = 0;
+    traza_terminar();
+    REGISTRO(REG_TRAZA_FIN, pulsos_encoder);
+    return 0;
+}
+
+/**
+ * @brief Empieza a reproducir la traza pedida por el PC, al iniciar un trabajo.
+ *
+ * Desde aquí el encoder, las celdas de carga y SW se toman de la traza; el motor, el
+ * traslado y las demás protecciones siguen con el hardware real.
+ */
+static void iniciar_reproduccion() {
+    traza_pedida = false;
+    if (!traza_reproducir()) return;
+    traza_evento_t primero;
+    traza_proximo(&primero);
+    desfase_traza_us = time_us_32() + TRAZA_ARRANQUE_US - primero.t_us;
+    celdas_traza_nuevas = 0;
+    sw_traza = false;
+    REGISTRO(REG_TRAZA_REPRODUCCION, traza_cantidad());
+    alarma_traza = add_alarm_in_us(TRAZA_ARRANQUE_US, paso_traza, NULL, true);
+    if (alarma_traza <= 0) { // Sin alarmas libres: el trabajo sigue con los sensores reales
+        alarma_traza = 0;
+        traza_terminar();
+    }
+}
+
+/**
+ * @brief Termina la reproducción en curso, si la hay, al terminar el trabajo.
+ */
+static void terminar_reproduccion() {
+    if (alarma_traza > 0) cancel_alarm(alarma_traza);
+    alarma_traza = 0;
+    if (traza_reproduciendo()) {
+        traza_terminar();
+        REGISTRO(REG_TRAZA_FIN, pulsos_encoder);
     }
 }
 
@@ -98,19 +502,11 @@ void gpio_callback(uint gpio, uint32_t events) {
 /**
  * @brief Inicializa todos los pines GPIO necesarios.
  *
- * Configura los pines para el HX711, habilitación del motor, encoder óptico (con interrupción),
+ * Configura los pines del encoder óptico (con interrupción)
  * y encoder rotatorio. Establece las direcciones de entrada/salida y las resistencias pull-up
  * donde sea necesario.
  */
 void init_gpio() {
-    gpio_init(HX711_DT);
-    gpio_set_dir(HX711_DT, GPIO_IN);
-    gpio_init(HX711_SCK);
-    gpio_set_dir(HX711_SCK, GPIO_OUT);
-
-    gpio_init(MOTOR_EN);
-    gpio_set_dir(MOTOR_EN, GPIO_OUT);
-
     // Configura la interrupción para el encoder óptico
     gpio_set_irq_enabled_with_callback(OPT_ENCODER_DT, GPIO_IRQ_EDGE_FALL, true, gpio_callback);
     irq_set_enabled(IO_IRQ_BANK0, true);
@@ -129,8 +525,14 @@ void init_gpio() {
  *
  * Configura el pin PWM del servo especificado para una operación PWM de 50 Hz.
  * El valor de 'wrap' se calcula para lograr 50 Hz con un divisor de reloj de 64.
+ * Con `SERVO_BACKEND_PIO` el pulso lo genera una máquina de estados PIO a
+ * `SERVO_FRECUENCIA_HZ` y el slice PWM del pin queda libre.
  */
 void setup_servo() {
+#if SERVO_BACKEND_PIO
+    servo_pio_iniciar(pio0, SERVO_PWM, SERVO_FRECUENCIA_HZ);
+    interp_lerp_config(1000000, SERVO_NS_POR_MGRAD_FRAC_Q15, 15);
+#else
     gpio_set_function(SERVO_PWM, GPIO_FUNC_PWM);
     uint slice_num = pwm_gpio_to_slice_num(SERVO_PWM);
 
@@ -138,6 +540,8 @@ void setup_servo() {
     pwm_config_set_clkdiv(&config, 64.0f);     // Divisor de reloj para PWM
     pwm_config_set_wrap(&config, 39062);        // Valor de 'wrap' para 50 Hz (125MHz / 64 / 50Hz = 39062.5)
     pwm_init(slice_num, &config, true);         // Inicializa y habilita el PWM
+    interp_lerp_config(1953, SERVO_CUENTAS_POR_MGRAD_Q20, 20);
+#endif
 }
 
 /**
@@ -148,112 +552,589 @@ void setup_servo() {
  * @param angle El ángulo deseado en grados (0-180).
  */
 void set_servo_angle(int angle) {
+    set_servo_mgrados(angle * 1000);
+}
+
+/**
+ * @brief Establece la posición del servomotor con resolución de miligrados.
+ *
+ * Es la salida usada por el planificador de traslado, que trabaja con fracciones de grado
+ * para aplicar el engranaje electrónico y las compensaciones sin perder resolución.
+ * @param mgrad La posición deseada en miligrados (0-180000).
+ */
+void set_servo_mgrados(int32_t mgrad) {
+    if (mgrad < 0) mgrad = 0;
+    if (mgrad > 180000) mgrad = 180000;
+#if SERVO_BACKEND_PIO
+    // 1 ms a 0 grados y 2 ms a 180 grados (lerp en interp0, base 1 ms). El producto del
+    // lerp es de 32 bits: la parte entera de la pendiente va aparte para que la fracción
+    // pueda llevar 15 bits y no se pierda la resolución de 8 ns del PIO
+    servo_pio_set_ancho_ns((uint32_t)mgrad * SERVO_NS_POR_MGRAD
+                           + interp_lerp((uint32_t)mgrad, SERVO_NS_POR_MGRAD_FRAC_Q15));
+#else
     // Ancho de pulso para 0 grados (mínimo) y 180 grados (máximo)
     // Correspondiendo a un ancho de pulso de 1ms y 2ms a 50Hz (39062.5 cuentas totales)
     // 1ms = 39062.5 / 20 = 1953 cuentas
     // 2ms = 39062.5 / 10 = 3906 cuentas
-    uint16_t pulse = 1953 + ((angle * (3906 - 1953)) / 180);
+    // La interpolación lineal la hace interp0 (base 1953 cuentas)
+    uint16_t pulse = (uint16_t)interp_lerp((uint32_t)mgrad, SERVO_CUENTAS_POR_MGRAD_Q20);
     pwm_set_gpio_level(SERVO_PWM, pulse);
+#endif
 }
 
 /**
- * @brief Hace que el servomotor oscile entre dos ángulos.
+ * @brief Inicia el planificador de traslado para un nuevo bobinado.
  *
- * El servo se mueve de `min_angle` a `max_angle` y luego regresa, con una pausa
- * entre cada cambio de ángulo incremental. Esto simula la distribución del hilo.
- * @param min_angle El ángulo mínimo para la oscilación.
- * @param max_angle El ángulo máximo para la oscilación.
- * @param pause_ms La pausa en milisegundos entre cada paso de ángulo.
+ * Debe llamarse después de reiniciar `pulsos_encoder`. El traslado arranca en el borde
+ * inferior (o en la posición guardada, al reanudar) y desde ese momento sigue el giro del tambor.
+ * @param posicion Posición en la capa al reanudar, o `NULL` para un bobinado nuevo.
  */
-void mover_servo_oscilando(int min_angle, int max_angle, int pause_ms) {
-    for (int angle = min_angle; angle <= max_angle; angle++) {
-        set_servo_angle(angle);
-        sleep_ms(pause_ms);
+void iniciar_traslado(const traslado_posicion_t *posicion) {
+    static const traslado_config_t cfg = {
+        .min_mgrad = TRASLADO_MIN_GRADOS * 1000,
+        .max_mgrad = TRASLADO_MAX_GRADOS * 1000,
+        .paso_mgrad_vuelta = TRASLADO_PASO_MGRAD,
+        .pulsos_por_vuelta = 0, // Se toma de la calibración vigente
+        .pausa_borde_pulsos = TRASLADO_PAUSA_PULSOS,
+#if TRASLADO_BACKEND_STEPPER
+        // El paso a paso sigue el comando sin retardo apreciable ni juego del servo
+        .retardo_servo_us = 0,
+        .juego_mgrad = 0,
+        .salida = stepper_mover_mgrados,
+#else
+        .retardo_servo_us = TRASLADO_RETARDO_SERVO_US,
+        .juego_mgrad = TRASLADO_JUEGO_MGRAD,
+        .salida = set_servo_mgrados,
+#endif
+    };
+    traslado_config_t c = cfg;
+    c.pulsos_por_vuelta = calibracion.pulsos_por_vuelta;
+    if (posicion) {
+        traslado_reanudar(&traslado, &c, pulsos_encoder, posicion);
+    } else {
+        traslado_iniciar(&traslado, &c, pulsos_encoder);
     }
-    for (int angle = max_angle; angle >= min_angle; angle--) {
-        set_servo_angle(angle);
-        sleep_ms(pause_ms);
+}
+
+/**
+ * @brief Inicializa el traslado con motor paso a paso.
+ *
+ * El carro debe estar colocado en el borde inferior del traslado al encender,
+ * ya que no hay final de carrera para referenciarlo.
+ */
+void setup_stepper() {
+    static const stepper_config_t cfg = {
+        .pin_step = STEPPER_STEP,
+        .pin_dir = STEPPER_DIR,
+        .pasos_por_grado = STEPPER_PASOS_POR_GRADO,
+        .vel_min = STEPPER_VEL_MIN,
+        .vel_max = STEPPER_VEL_MAX,
+        .accel = STEPPER_ACCEL,
+    };
+    stepper_iniciar(pio0, &cfg);
+    stepper_fijar_origen(TRASLADO_MIN_GRADOS * 1000);
+}
+
+/**
+ * @brief Inicia la adquisición analógica continua.
+ *
+ * Con 32 kS/s por canal: la tensión sale a 1 kHz (CIC orden 2, R = 32, promedio de 4),
+ * la corriente a 4 kHz con poco retardo para protecciones rápidas (CIC orden 1, R = 8,
+ * promedio de 2) y la alimentación a 500 Hz muy suavizada (CIC orden 2, R = 64, promedio de 16).
+ */
+void setup_analogico() {
+    static const analog_filtro_t filtros[ANALOG_NUM_CANALES] = {
+        [ANALOG_TENSION]   = { .orden_cic = 2, .log2_decimacion = 5, .log2_promedio = 2 },
+        [ANALOG_CORRIENTE] = { .orden_cic = 1, .log2_decimacion = 3, .log2_promedio = 1 },
+        [ANALOG_VOLTAJE]   = { .orden_cic = 2, .log2_decimacion = 6, .log2_promedio = 4 },
+    };
+    analog_iniciar(ADC_MUESTRAS_POR_S, filtros);
+
+    static const corriente_config_t cfg_corriente = {
+        .mv_por_amperio = CORRIENTE_MV_POR_A,
+        .cero_mv = CORRIENTE_CERO_MV,
+        .arranque_ms = CORRIENTE_ARRANQUE_MS,
+    };
+    corriente_iniciar(&cfg_corriente); // Protección de atasco/sobrecarga sobre el canal de corriente
+    resonancia_iniciar();  // Captura del canal de tensión para el análisis de vibraciones
+    analog_set_callback(ANALOG_VOLTAJE, vigilar_alimentacion); // Caída de la alimentación
+}
+
+/**
+ * @brief Toma la tara de la celda principal promediando 16 lecturas (80 muestras/s), sin hilo tensado.
+ *
+ * @return `false` si el HX711 no respondió en 500 ms (se conserva la tara anterior).
+ */
+static bool tarar_celda() {
+    int64_t suma = 0;
+    uint32_t n = 0;
+    uint32_t inicio = time_us_32();
+    while (n < 16) {
+        if (time_us_32() - inicio > 500000) return false;
+        if (hx711_listo()) {
+            suma += hx711_leer();
+            n++;
+        }
     }
+    tension_tarar(suma, n);
+    return true;
 }
 
-// --- Funciones de Lectura de Sensores ---
 /**
- * @brief Lee la fuerza simulada de la celda de carga (HX711).
+ * @brief Inicia la celda de carga y el estimador de tensión, y toma la tara.
  *
- * Actualmente, esta función es una simulación y siempre devuelve 0.
- * En una implementación real, leería datos del sensor HX711.
- * @return Un valor de fuerza simulado (0 en esta versión).
+ * La tara se toma al arrancar, sin hilo tensado. Si el HX711 no responde a tiempo la tara
+ * queda en 0: la tensión medida incluye el peso del soporte y `main()` lo avisa en el OLED.
+ * @return `false` si no se pudo tomar la tara.
  */
-int leer_fuerza() {
-    // Simulación: Aún no conectado al HX711.
-    // En un escenario real, esto implicaría leer datos del HX711.
-    return 0;
+bool setup_tension() {
+    hx711_iniciar(HX711_DT, HX711_SCK);
+    tension_iniciar(&control_tension_cfg);
+    return tarar_celda();
 }
 
-// --- Funciones de Bobinado (Hilo) ---
 /**
- * @brief Realiza el bobinado automático de hilo.
+ * @brief Toma la tara de las celdas de los hilos en paralelo, sin hilo tensado.
  *
- * El motor funciona continuamente y el servo oscila para distribuir el hilo.
- * El bobinado puede detenerse presionando el interruptor del encoder rotatorio o
- * si se detecta una tensión excesiva (simulado con `leer_fuerza() > 3000`).
- * Muestra los metros actuales bobinados en el OLED.
+ * @return `false` si alguna celda no respondió en 500 ms (se conserva la tara anterior).
  */
-void enrollar_auto() {
-    pulsos_encoder = 0; // Reinicia el contador del encoder
+static bool tarar_hilos() {
+    int64_t suma[HILOS_MAX] = { 0 };
+    int32_t crudas[HILOS_MAX];
+    uint32_t n = 0;
+    uint32_t inicio = time_us_32();
+    while (n < MULTIFILAR_TARA_MUESTRAS) {
+        if (time_us_32() - inicio > 500000) return false;
+        if (hx711_pio_sondear(crudas, multifilar.hilos)) {
+            for (int i = 0; i < multifilar.hilos; i++) suma[i] += crudas[i];
+            n++;
+        }
+    }
+    hilos_tarar(&hilos, suma, n);
+    return true;
+}
 
-    ssd1306_clear();
-    ssd1306_draw_string(0, 0, "Auto Enrollando...");
-    ssd1306_draw_string(0, 10, "Presiona SW para");
-    ssd1306_draw_string(0, 20, "detener.");
-    ssd1306_show();
+/**
+ * @brief Inicia la lectura por PIO de las celdas de los hilos en paralelo.
+ *
+ * Se usa `pio1`: `pio0` ya lleva el servo o el paso a paso y el sensor de rotura. Con
+ * varios hilos configurados se toma la tara al arrancar, como la de la celda principal.
+ */
+void setup_hilos() {
+    hx711_pio_iniciar(pio1, HX711_HILOS_DT, HX711_HILOS_SCK);
+    hilos_iniciar(&hilos, multifilar.hilos, HX711_CUENTAS_POR_G);
+    if (multifilar.hilos > 1) {
+        tarar_hilos();
+    }
+}
+
+/**
+ * @brief Devuelve la última tensión estimada, sin leer las celdas.
+ *
+ * En el bobinado multifilar es la del hilo más tenso. Segura desde interrupciones.
+ * @return Tensión en gramos.
+ */
+static int32_t tension_actual() {
+    return multifilar.hilos > 1 ? hilos_max(&hilos) : tension_gramos();
+}
 
-    gpio_put(MOTOR_EN, 1); // Activa el motor
+/**
+ * @brief Arma todas las protecciones al empezar un trabajo.
+ *
+ * Borra las fallas enclavadas del trabajo anterior, arma la vigilancia de corriente,
+ * rotura y encoder y reinicia la cinemática del estimador de tensión. Debe llamarse justo
+ * antes de encender el motor, con `pulsos_encoder` ya puesto para el trabajo.
+ */
+void armar_protecciones() {
+    fallas_rearmar();
+    hilo_falla = -1;
+    ultimo_pulso_us = time_us_32(); // El plazo del encoder empieza al encender el motor
+    periodo_pulso_us = 0; // El periodo del trabajo anterior no es la velocidad de este
+    tension_reiniciar(); // El conteo del encoder acaba de cambiar
+    corriente_armar(material_perfil(material_activo)); // Límites de corriente del material
+    rotura_armar();        // Vigilancia de rotura del hilo
+    reiniciar_anomalias(ultimo_pulso_us);
+}
 
-    int ultimo_pulso_mostrado = 0; // Rastrea el último conteo de pulsos mostrado
+/**
+ * @brief Reinicia los detectores de anomalías para un nuevo punto de operación.
+ *
+ * La línea base se vuelve a aprender tras el transitorio de `ANOMALIA_ESPERA_MS`.
+ * @param ahora Instante actual.
+ */
+void reiniciar_anomalias(uint32_t ahora) {
+    control_vigilancia_reiniciar(&vigilancia, ahora); // Ajuste en control.c
+    proximo_control_us = ahora;
+}
 
-    while (1) {
-        int pulsos_actuales = pulsos_encoder;
+/**
+ * @brief Mide la velocidad del tambor a partir del periodo entre pulsos del encoder.
+ *
+ * @return Velocidad en rpm (0 si aún no hubo dos pulsos).
+ */
+static int32_t medir_rpm() {
+    return control_rpm(periodo_pulso_us, calibracion.pulsos_por_vuelta);
+}
 
-        // Actualiza la pantalla cada 100 pulsos nuevos
-        if (pulsos_actuales - ultimo_pulso_mostrado >= 100) {
-            ultimo_pulso_mostrado = pulsos_actuales;
+/**
+ * @brief Lazo de velocidad: corrige la referencia del planificador con la velocidad medida.
+ *
+ * Sin ganancias ajustadas para el material (ver `autoajustar_velocidad()`), o durante la
+ * calibración de resonancias, la referencia se aplica tal cual (lazo abierto).
+ * @param referencia Velocidad de referencia en milésimas del PWM.
+ * @return Velocidad a aplicar al motor.
+ */
+static uint16_t regular_velocidad(uint16_t referencia) {
+    const material_perfil_t *perfil = material_perfil(material_activo);
+    if (calibrando || !pid_ajustado(&perfil->pid_velocidad)) return referencia;
+
+    int32_t rpm_ref = (int32_t)((referencia * perfil->rpm_por_milesima_q8) >> 8);
+    int32_t u = referencia + pid_actualizar(&lazo_velocidad, rpm_ref - rpm_filtrada, CONTROL_PERIODO_US);
+    if (u < 0) u = 0;
+    if (u > MOTOR_VELOCIDAD_MAX) u = MOTOR_VELOCIDAD_MAX;
+    return (uint16_t)u;
+}
 
-            float metros_actuales = (float)pulsos_actuales / PULSOS_POR_METRO;
-            ssd1306_clear();
-            char msg[32];
-            sprintf(msg, "Metros: %.2f", metros_actuales);
-            ssd1306_draw_string(0, 0, "Enrollando (Auto)...");
-            ssd1306_draw_string(0, 10, msg);
-            ssd1306_draw_string(0, 20, "Presiona SW");
-            ssd1306_show();
+/**
+ * @brief Vigila la degradación del hilo y ralentiza el tambor.
+ *
+ * Pasa la tensión medida y la velocidad del tambor por sus detectores EWMA + CUSUM. Ante
+ * una anomalía (varianza de la tensión en aumento, velocidad irregular) reduce la
+ * velocidad antes de que el hilo se rompa, deja el aviso en el historial de fallas y
+ * vuelve a aprender la línea base a la nueva velocidad.
+ * @param ahora Instante actual.
+ */
+void vigilar_anomalias(uint32_t ahora) {
+    if (control_vigilar(&vigilancia, ahora, tension_medida_gramos(), medir_rpm()) == ANOMALIA_NINGUNA) return;
+
+    falla_reportar(FALLA_ANOMALIA, ahora); // Solo aviso: queda en el historial
+    aprendizaje_incidente(&aprendizaje);   // El techo de velocidad del material bajará
+    uint16_t velocidad = (uint16_t)(velocidad_objetivo_actual() * ANOMALIA_RALENTIZAR_PCT / 100);
+    if (velocidad < MOTOR_VELOCIDAD_MIN) velocidad = MOTOR_VELOCIDAD_MIN;
+    velocidad_objetivo(velocidad); // Los detectores ya aprenden de nuevo (control_vigilar())
+}
+
+/**
+ * @brief Copia el estado del bobinado en curso para poder reanudarlo.
+ *
+ * Solo desde el bucle principal, que es quien actualiza el traslado: la interrupción de
+ * alimentación usa la copia de `punto_ram`.
+ * @param p Recibe el punto de control.
+ * @return `false` si no hay un bobinado en curso.
+ */
+static bool capturar_punto_control(punto_control_t *p) {
+    const trabajo_t *t = trabajo_actual;
+    if (!t || t->tipo != TRABAJO_BOBINADO) return false;
+    p->material = (uint8_t)t->material;
+    p->unidad = (uint8_t)t->unidad;
+    p->detenible = t->detenible;
+    p->secuencia = t->segmentos != NULL; // Solo la secuencia guardada tiene segmentos
+    p->velocidad = t->velocidad;
+    p->objetivo_pulsos = t->objetivo_pulsos;
+    p->pulsos = traslado.ultimo_pulso; // Coherente con la posición del traslado
+    traslado_posicion(&traslado, &p->posicion);
+    p->comando_mgrad = traslado.comando_mgrad;
+    return true;
+}
+
+/**
+ * @brief Guarda un punto de control en la RAM que no se inicializa al reiniciar.
+ */
+static void guardar_punto_ram(const punto_control_t *p) {
+    punto_ram.magico = 0; // Inválido mientras se escribe
+    __compiler_memory_barrier(); // La interrupción de alimentación lo lee
+    punto_ram.p = *p;
+    punto_ram.crc = almacen_crc32(p, sizeof(*p));
+    __compiler_memory_barrier();
+    punto_ram.magico = PUNTO_CONTROL_MAGICO;
+}
+
+/**
+ * @brief Indica si el punto de control en RAM está completo y sin corromper.
+ */
+static bool punto_ram_valido() {
+    return punto_ram.magico == PUNTO_CONTROL_MAGICO
+        && punto_ram.crc == almacen_crc32(&punto_ram.p, sizeof(punto_ram.p));
+}
+
+/**
+ * @brief Vigila la alimentación de 12 V y guarda el trabajo si cae.
+ *
+ * Callback del canal `ANALOG_VOLTAJE` (500 Hz, en interrupción). Durante un bobinado, al
+ * bajar de `ALIMENTACION_MIN_MV` corta el motor (`FALLA_ALIMENTACION`) para ahorrar la
+ * energía que queda en los condensadores y escribe un punto de control en flash; mientras
+ * el equipo siga vivo vuelve a escribirlo cada `ALIMENTACION_PULSOS_PUNTO` pulsos, de
+ * modo que se conservan también las vueltas que da el tambor por inercia sin gastar las
+ * páginas del sector con el tambor ya casi parado.
+ *
+ * Se escribe la copia que deja el tick de control en `punto_ram`: aquí el traslado podría
+ * estar a medio actualizar por el bucle principal, y los pulsos no coincidirían con la
+ * posición en la capa.
+ * @param valor Lectura filtrada del canal.
+ */
+void vigilar_alimentacion(uint16_t valor) {
+    if (!trabajo_actual || trabajo_actual->tipo != TRABAJO_BOBINADO) return;
+    if (!caida_alimentacion) {
+        uint32_t mv = (analog_a_mv(valor) * ALIMENTACION_DIVISOR_Q8) >> 8;
+        if (mv >= ALIMENTACION_MIN_MV) return;
+        caida_alimentacion = true;
+        falla_reportar(FALLA_ALIMENTACION, time_us_32());
+    }
+    if (!punto_ram_valido()) return; // El tick lo está reescribiendo: en la próxima muestra
+    int32_t pulsos = punto_ram.p.pulsos;
+    if (caida_respaldada && pulsos - pulsos_respaldados < ALIMENTACION_PULSOS_PUNTO) return;
+    if (respaldo_guardar(&punto_ram.p, sizeof(punto_ram.p))) { // < 1 ms; para con el sector lleno
+        caida_respaldada = true;
+        pulsos_respaldados = pulsos;
+    }
+}
+
+/**
+ * @brief Tick de control del bobinado: rampa y lazo de velocidad, vigilancia de anomalías.
+ *
+ * Se ejecuta cada `CONTROL_PERIODO_US` desde `verificar_fallas()`. Mientras la velocidad
+ * cambia o el trabajo está en pausa no se vigilan anomalías ni se aprende el techo: el
+ * punto de operación aún no es estable. Durante un
+ * autoajuste, una vez alcanzado el punto de operación, el relé manda sobre el motor.
+ * @param ahora Instante actual.
+ */
+void tick_control(uint32_t ahora) {
+    if ((int32_t)(ahora - proximo_control_us) < 0) return;
+    uint32_t retraso = ahora - proximo_control_us;
+    if (retraso > control_retraso_max_us) control_retraso_max_us = retraso;
+    proximo_control_us += CONTROL_PERIODO_US;
+    if ((int32_t)(ahora - proximo_control_us) > 0) {
+        proximo_control_us = ahora + CONTROL_PERIODO_US; // Bucle retrasado: no se recuperan ticks
+    }
+
+    rpm_filtrada += (medir_rpm() - rpm_filtrada) / 4;
+    uint16_t referencia = velocidad_actualizar(CONTROL_PERIODO_US);
+    if (trabajo_actual && trabajo_actual->tipo == TRABAJO_AUTOAJUSTE && !velocidad_en_rampa()) {
+        motor_fijar_velocidad((uint16_t)autoajuste_paso(&autoajuste, rpm_filtrada, CONTROL_PERIODO_US));
+        return;
+    }
+    motor_fijar_velocidad(regular_velocidad(referencia));
+    punto_control_t p;
+    if (capturar_punto_control(&p)) {
+        guardar_punto_ram(&p); // Cuesta unos µs: sobrevive a un reinicio por watchdog
+    }
+    if (pausado || velocidad_en_rampa()) {
+        control_vigilancia_esperar(&vigilancia, ahora);
+        return;
+    }
+    if (!calibrando) {
+        vigilar_anomalias(ahora);
+    }
+    if (trabajo_actual && trabajo_actual->tipo == TRABAJO_BOBINADO) {
+        aprendizaje_observar(&aprendizaje, velocidad_objetivo_actual(), tension_actual());
+    }
+}
+
+/**
+ * @brief Indica si una falla pausa el bobinado en curso en lugar de terminarlo.
+ *
+ * Las fallas `FALLA_PAUSAR` de un bobinado lo dejan en pausa, salvo la caída de la
+ * alimentación: esa termina el trabajo dejando su punto de control para reanudarlo.
+ */
+static bool falla_pausa(falla_t falla) {
+    return falla_accion(falla) == FALLA_PAUSAR && falla != FALLA_ALIMENTACION
+        && trabajo_actual && trabajo_actual->tipo == TRABAJO_BOBINADO;
+}
+
+/**
+ * @brief Sondea las fallas que no se detectan por interrupción y evalúa la falla activa.
+ *
+ * Se llama en cada vuelta de los bucles de bobinado. Las fallas detectadas en
+ * interrupción (rotura, corriente) ya se reportaron; aquí se añaden la tensión (de cada
+ * hilo en el bobinado multifilar; no en pausa; sin mínimo si el material lo tiene en 0),
+ * el encoder detenido con el motor encendido y el bus de la pantalla. Además se ejecuta
+ * el tick de control, se alimenta el watchdog, se envía la telemetría y se atienden las
+ * órdenes del PC.
+ * @return `true` si el bobinado debe terminar (la falla ya se mostró en el OLED).
+ */
+bool verificar_fallas() {
+    uint32_t ahora = time_us_32();
+    const material_perfil_t *perfil = material_perfil(material_activo);
+
+    int fuerza = leer_fuerza();
+    if (pausado) {
+        // El operario está manipulando el hilo: la tensión no significa nada
+    } else if (multifilar.hilos > 1) {
+        bool alta = false;
+        int hilo = hilos_fuera_de_rango(&hilos, perfil->tension_min, perfil->tension_max, &alta);
+        if (hilo >= 0) { // Un solo tambor: la falla de un hilo para todos a la vez
+            hilo_falla = hilo;
+            falla_reportar(alta ? FALLA_TENSION_ALTA : FALLA_TENSION_BAJA, ahora);
         }
+    } else if (fuerza > perfil->tension_max) {
+        falla_reportar(FALLA_TENSION_ALTA, ahora);
+    } else if (perfil->tension_min > 0 && fuerza < perfil->tension_min) { // 0 = desactivada
+        falla_reportar(FALLA_TENSION_BAJA, ahora);
+    }
+    tick_control(ahora);
+    if (motor_encendido() && ahora - ultimo_pulso_us > ENCODER_DETENIDO_MS * 1000) {
+        falla_reportar(FALLA_ENCODER_DETENIDO, ahora);
+    }
+    if (!ssd1306_ok()) {
+        falla_reportar(FALLA_BUS_PANTALLA, ahora);
+    }
+    watchdog_update();
+    telemetria_atender();
+    atender_remoto();
 
-        mover_servo_oscilando(50, 130, 15); // Oscila el servo para la distribución del hilo
+    falla_t falla = falla_activa();
+    if (falla == FALLA_NINGUNA || falla_accion(falla) == FALLA_AVISAR || falla_pausa(falla)) {
+        return false; // Los avisos no detienen el bobinado; las pausas las aplica ejecutar_trabajo()
+    }
+    detener_por_falla(falla);
+    return true;
+}
 
-        if (leer_fuerza() > 3000) { // Verifica si hay tensión excesiva (simulada)
-            gpio_put(MOTOR_EN, 0); // Detiene el motor
-            ssd1306_clear();
-            ssd1306_draw_string(0, 0, "TENSION EXCESIVA!");
-            ssd1306_draw_string(0, 10, "Motor detenido.");
-            ssd1306_show();
-            return; // Sale del bobinado
+/**
+ * @brief Completa la detención por una falla y la muestra en el OLED.
+ *
+ * Camino común de todas las protecciones. El gestor de fallas ya cortó el motor al
+ * reportarla; con las acciones que no son parada inmediata el traslado sigue al tambor
+ * mientras se detiene por inercia, para no amontonar hilo en el borde.
+ * @param falla Falla activa.
+ */
+void detener_por_falla(falla_t falla) {
+    motor_cortar(); // Detiene el motor
+    if (!traza_congelada()) { // Se conservan los sensores que llevaron a la falla
+        traza_congelar();
+        REGISTRO(REG_TRAZA_CONGELADA, traza_cantidad(), falla);
+    }
+    if (falla_accion(falla) != FALLA_PARAR) {
+        int anterior;
+        do {
+            anterior = pulsos_encoder;
+            traslado_actualizar(&traslado, anterior);
+            punto_control_t p;
+            if (capturar_punto_control(&p)) {
+                guardar_punto_ram(&p); // Lo que escribe la interrupción de alimentación mientras gira
+            }
+            sleep_ms(50);
+        } while (pulsos_encoder != anterior);
+    }
+
+    ssd1306_clear();
+    ssd1306_draw_string(0, 0, falla_nombre(falla));
+    ssd1306_draw_string(0, 10, "Motor detenido.");
+    const falla_registro_t *r = falla_registro(falla);
+    if (r) {
+        char msg[32];
+        sprintf(msg, "Reaccion: %lu us", (unsigned long)r->reaccion_us);
+        ssd1306_draw_string(0, 20, msg);
+    }
+    if (hilo_falla >= 0 && (falla == FALLA_TENSION_ALTA || falla == FALLA_TENSION_BAJA)) {
+        char msg[32];
+        sprintf(msg, "Hilo %d de %d", hilo_falla + 1, multifilar.hilos);
+        ssd1306_draw_string(0, 30, msg);
+    }
+    ssd1306_show();
+}
+
+// --- Funciones de Lectura de Sensores ---
+/**
+ * @brief Toma las lecturas reproducidas de varias celdas, si son nuevas todas.
+ *
+ * @param mascara Canales pedidos (bit = canal).
+ * @param crudas Recibe las lecturas, en orden de canal.
+ * @param t_us Si no es nulo, recibe el instante de la lectura del primer canal pedido.
+ * @return `false` si falta la lectura de algún canal.
+ */
+static bool tomar_celdas_traza(uint32_t mascara, int32_t *crudas, uint32_t *t_us) {
+    uint32_t estado = save_and_disable_interrupts();
+    bool listas = (celdas_traza_nuevas & mascara) == mascara;
+    if (listas) {
+        celdas_traza_nuevas &= ~mascara;
+        if (t_us) *t_us = celda_traza_us[__builtin_ctz(mascara)];
+        for (int canal = 0; canal <= HILOS_MAX; canal++) {
+            if (mascara & (1u << canal)) *crudas++ = celda_traza[canal];
         }
+    }
+    restore_interrupts(estado);
+    return listas;
+}
 
-        if (!gpio_get(ROT_SW)) { // Verifica si se presiona el interruptor del encoder rotatorio
-            sleep_ms(200); // Debounce
-            gpio_put(MOTOR_EN, 0); // Detiene el motor
-            ssd1306_clear();
-            ssd1306_draw_string(0, 0, "Enrollado detenido.");
-            float metros_finales = (float)pulsos_encoder / PULSOS_POR_METRO;
-            char final_msg[32];
-            sprintf(final_msg, "Total: %.2f m", metros_finales);
-            ssd1306_draw_string(0, 10, final_msg);
-            ssd1306_show();
-            sleep_ms(2000);
-            return; // Sale del bobinado
+/**
+ * @brief Lee la celda principal si hay una conversión lista (no bloquea) y la graba en la traza.
+ *
+ * Mientras se reproduce una traza la lectura sale de ella.
+ * @param crudo Recibe la lectura cruda.
+ * @param t_us Recibe el instante de la lectura (el grabado, si viene de la traza).
+ * @return `true` si hay una lectura nueva.
+ */
+static bool leer_celda(int32_t *crudo, uint32_t *t_us) {
+    if (traza_reproduciendo()) return tomar_celdas_traza(1u, crudo, t_us);
+    if (!hx711_listo()) return false;
+    *crudo = hx711_leer();
+    *t_us = time_us_32();
+    trazar(TRAZA_CELDA, 0, *crudo, *t_us);
+    return true;
+}
+
+/**
+ * @brief Lee las celdas de los hilos en paralelo si hay lecturas listas y las graba en la traza.
+ *
+ * Mientras se reproduce una traza las lecturas salen de ella.
+ * @param crudas Recibe una lectura cruda por hilo.
+ * @return `true` si hay lecturas nuevas.
+ */
+static bool leer_celdas_hilos(int32_t *crudas) {
+    if (traza_reproduciendo()) return tomar_celdas_traza(((1u << multifilar.hilos) - 1) << 1, crudas, NULL);
+    if (!hx711_pio_sondear(crudas, multifilar.hilos)) return false;
+    uint32_t ahora = time_us_32();
+    for (int i = 0; i < multifilar.hilos; i++) {
+        trazar(TRAZA_CELDA, (uint8_t)(i + 1), crudas[i], ahora);
+    }
+    return true;
+}
+
+/**
+ * @brief Lee la tensión del hilo estimada a partir de la celda de carga (HX711).
+ *
+ * Procesa la lectura del HX711 si hay una nueva (no bloquea), o la de la traza que se
+ * reproduce, y devuelve el estimado del filtro, ya compensado por la aceleración del
+ * tambor (ver tension.h). En el bobinado multifilar procesa además la lectura simultánea
+ * de las celdas de los hilos y devuelve la tensión del hilo más tenso.
+ * @return Tensión estimada en gramos.
+ */
+int leer_fuerza() {
+    int32_t crudo;
+    uint32_t t_us;
+    if (leer_celda(&crudo, &t_us)) {
+        tension_procesar(crudo, pulsos_encoder, t_us);
+    }
+    if (multifilar.hilos > 1) {
+        int32_t crudas[HILOS_MAX];
+        if (leer_celdas_hilos(crudas)) {
+            hilos_actualizar(&hilos, crudas);
         }
     }
+    return tension_actual();
+}
+
+// --- Funciones de Bobinado (Hilo) ---
+/**
+ * @brief Realiza el bobinado automático de hilo.
+ *
+ * El motor funciona continuamente y el traslado sigue el giro del tambor para distribuir el hilo.
+ * El interruptor del encoder rotatorio pausa y reanuda el bobinado; mantenido lo termina.
+ * También lo detiene cualquier falla del gestor (tensión, rotura, corriente; ver `verificar_fallas()`).
+ * Muestra los metros actuales bobinados en el OLED.
+ */
+void enrollar_auto() {
+    static const trabajo_t t = {
+        .tipo = TRABAJO_BOBINADO,
+        .titulo = "Enrollando (Auto)...",
+        .material = MATERIAL_HILO,
+        .objetivo_pulsos = 0, // Continuo hasta mantener SW
+        .unidad = TRABAJO_METROS,
+        .velocidad = MOTOR_VELOCIDAD_NOMINAL,
+        .detenible = true,
+    };
+    ejecutar_trabajo(&t);
 }
 
 /**
@@ -264,10 +1145,12 @@ void enrollar_auto() {
  * @return La longitud seleccionada en metros.
  */
 int seleccionar_metros() {
-    int metros = 1; // Valor inicial en metros
+    int metros = receta.metros; // Valor inicial: el último usado
     int last_clk = gpio_get(ROT_CLK); // Estado inicial del pin CLK
+    bool redibujar = true; // Muestra el valor inicial antes del primer giro
 
     while (1) {
+        watchdog_update(); // Mantiene vivo el watchdog mientras se espera al usuario
         int clk = gpio_get(ROT_CLK);
         int dt = gpio_get(ROT_DT);
         if (clk != last_clk) { // Encoder rotatorio girado
@@ -280,7 +1163,13 @@ int seleccionar_metros() {
             if (metros < 1) metros = 1; // Asegura valor mínimo
             if (metros > 999) metros = 999; // Asegura valor máximo
 
-            // Muestra los metros en el OLED
+            last_clk = clk;
+            redibujar = true;
+            sleep_ms(100); // Debounce para el encoder rotatorio
+        }
+
+        if (redibujar) { // Muestra los metros en el OLED
+            redibujar = false;
             ssd1306_clear();
             char buffer[32];
             sprintf(buffer, "Metros: %d", metros);
@@ -288,13 +1177,12 @@ int seleccionar_metros() {
             ssd1306_draw_string(0, 10, buffer);
             ssd1306_draw_string(0, 20, "Presiona SW");
             ssd1306_show();
-
-            last_clk = clk;
-            sleep_ms(100); // Debounce para el encoder rotatorio
         }
 
         if (!gpio_get(ROT_SW)) { // Interruptor del encoder rotatorio presionado
             sleep_ms(200); // Debounce
+            receta.metros = metros;
+            persistencia_marcar(CLAVE_RECETA); // Se recuerda tras apagar
             return metros; // Devuelve los metros seleccionados
         }
 
@@ -305,60 +1193,25 @@ int seleccionar_metros() {
 /**
  * @brief Bobina hilo hasta un número específico de metros.
  *
- * El motor funciona hasta que `pulsos_encoder` alcanza el `pulsos_deseados` objetivo.
- * El servo oscila para la distribución del hilo. El bobinado se detiene si se detecta
- * una tensión excesiva. Muestra el progreso del bobinado en el OLED.
+ * El motor funciona hasta que `pulsos_encoder` alcanza los pulsos de los metros deseados.
+ * El traslado sigue el giro del tambor para distribuir el hilo. El bobinado se puede pausar con
+ * el interruptor del encoder rotatorio y se detiene si se detecta una falla. Muestra el progreso
+ * del bobinado en el OLED.
  * @param metros_deseados La longitud objetivo de hilo a bobinar en metros.
  */
 void enrollar_hasta(int metros_deseados) {
-    int pulsos_deseados = metros_deseados * PULSOS_POR_METRO;
-    pulsos_encoder = 0; // Reinicia el contador global del encoder
-
-    int ultimo_pulso_mostrado = 0;
-
-    ssd1306_clear();
-    ssd1306_draw_string(0, 0, "Enrollando...");
-    ssd1306_show();
-
-    gpio_put(MOTOR_EN, 1); // Activa el motor
-
-    while (pulsos_encoder < pulsos_deseados) {
-        // Actualiza la pantalla solo si hay un cambio significativo (cada 100 pulsos)
-        if (pulsos_encoder - ultimo_pulso_mostrado >= 100) {
-            ultimo_pulso_mostrado = pulsos_encoder;
-
-            float metros_actuales = (float)pulsos_encoder / PULSOS_POR_METRO;
-            char msg[32];
-            sprintf(msg, "Metros: %.2f", metros_actuales);
-
-            ssd1306_clear();
-            ssd1306_draw_string(0, 0, "Enrollando...");
-            ssd1306_draw_string(0, 10, msg);
-            ssd1306_show();
-        }
-
-        mover_servo_oscilando(50, 130, 15); // Oscila el servo
-
-        if (leer_fuerza() > 3000) { // Verifica si hay tensión excesiva (simulada)
-            gpio_put(MOTOR_EN, 0); // Detiene el motor
-            ssd1306_clear();
-            ssd1306_draw_string(0, 0, "TENSION EXCESIVA!");
-            ssd1306_draw_string(0, 10, "Motor detenido.");
-            ssd1306_show();
-            return; // Sale del bobinado
-        }
-    }
-
-    gpio_put(MOTOR_EN, 0); // Detiene el motor cuando se alcanza el objetivo
-    ssd1306_clear();
-    ssd1306_draw_string(0, 0, "Enrollado completo!");
-    float metros_finales = (float)pulsos_encoder / PULSOS_POR_METRO;
-    char final_msg[32];
-    sprintf(final_msg, "Total: %.2f m", metros_finales);
-    ssd1306_draw_string(0, 10, final_msg);
-    ssd1306_show();
-    sleep_ms(2000);
-}
+    trabajo_t t = {
+        .tipo = TRABAJO_BOBINADO,
+        .titulo = "Enrollando...",
+        .material = MATERIAL_HILO,
+        .objetivo_pulsos = metros_deseados * PULSOS_POR_METRO,
+        .unidad = TRABAJO_METROS,
+        .velocidad = MOTOR_VELOCIDAD_NOMINAL,
+        .detenible = true,
+        .fin_titulo = "Enrollado completo!",
+    };
+    ejecutar_trabajo(&t);
+}
 
 // --- Funciones de Bobinado (Cobre) ---
 /**
@@ -401,10 +1254,12 @@ int calcular_vueltas_para_mH(int milihenrios) {
  * @return La inductancia seleccionada en milihenrios.
  */
 int seleccionar_mHenrios() {
-    int mH = 100; // Valor inicial en milihenrios
+    int mH = receta.milihenrios; // Valor inicial: el último usado
     int last_clk = gpio_get(ROT_CLK);
+    bool redibujar = true; // Muestra el valor inicial antes del primer giro
 
     while (1) {
+        watchdog_update(); // Mantiene vivo el watchdog mientras se espera al usuario
         int clk = gpio_get(ROT_CLK);
         int dt = gpio_get(ROT_DT);
         if (clk != last_clk) { // Encoder rotatorio girado
@@ -417,7 +1272,13 @@ int seleccionar_mHenrios() {
             if (mH < 10) mH = 10;     // mH mínimo
             if (mH > 2000) mH = 2000; // mH máximo
 
-            // Muestra los mH en el OLED
+            last_clk = clk;
+            redibujar = true;
+            sleep_ms(100); // Debounce para el encoder rotatorio
+        }
+
+        if (redibujar) { // Muestra los mH en el OLED
+            redibujar = false;
             ssd1306_clear();
             char buffer[32];
             sprintf(buffer, "Valor: %d mH", mH);
@@ -425,13 +1286,12 @@ int seleccionar_mHenrios() {
             ssd1306_draw_string(0, 10, buffer);
             ssd1306_draw_string(0, 20, "Presiona SW");
             ssd1306_show();
-
-            last_clk = clk;
-            sleep_ms(100); // Debounce para el encoder rotatorio
         }
 
         if (!gpio_get(ROT_SW)) { // Interruptor del encoder rotatorio presionado
             sleep_ms(200); // Debounce
+            receta.milihenrios = mH;
+            persistencia_marcar(CLAVE_RECETA); // Se recuerda tras apagar
             return mH; // Devuelve los milihenrios seleccionados
         }
 
@@ -443,162 +1303,1191 @@ int seleccionar_mHenrios() {
  * @brief Realiza el bobinado manual de hilo de cobre para lograr una inductancia objetivo.
  *
  * Calcula las vueltas requeridas basándose en los `milihenrios` de entrada. El motor funciona
- * hasta que `pulsos_encoder` (representando vueltas) alcanza las `vueltas_objetivo`.
- * El servo oscila para la distribución del hilo. El bobinado puede detenerse presionando
- * el interruptor del encoder rotatorio o si se detecta tensión excesiva.
+ * hasta que `pulsos_encoder` (representando vueltas) alcanza las vueltas objetivo.
+ * El traslado sigue el giro del tambor para distribuir el hilo. El bobinado puede detenerse presionando
+ * el interruptor del encoder rotatorio o por una falla.
  * Muestra el progreso del bobinado (vueltas) en el OLED.
  * @param milihenrios La inductancia objetivo en milihenrios.
  */
 void enrollar_cobre_manual(int milihenrios) {
-    int vueltas_objetivo = calcular_vueltas_para_mH(milihenrios);
-    pulsos_encoder = 0; // Reinicia el contador global del encoder
+    char detalle[32];
+    sprintf(detalle, "%d mH", milihenrios);
+    trabajo_t t = {
+        .tipo = TRABAJO_BOBINADO,
+        .titulo = "Cobre Manual...",
+        .material = MATERIAL_COBRE,
+        .objetivo_pulsos = calcular_vueltas_para_mH(milihenrios),
+        .unidad = TRABAJO_VUELTAS,
+        .velocidad = MOTOR_VELOCIDAD_NOMINAL,
+        .detenible = true,
+        .fin_titulo = "Bobina completada!",
+        .fin_detalle = detalle,
+    };
+    ejecutar_trabajo(&t);
+}
+
+/**
+ * @brief Realiza el bobinado automático de hilo de cobre para una inductancia objetivo de 1 Henrio.
+ *
+ * Calcula las vueltas requeridas para 1 Henrio (1000 mH). El motor funciona
+ * hasta que `pulsos_encoder` (representando vueltas) alcanza las vueltas objetivo.
+ * El traslado sigue el giro del tambor para distribuir el hilo. El bobinado puede detenerse presionando
+ * el interruptor del encoder rotatorio o por una falla.
+ * Muestra el progreso del bobinado (vueltas) en el OLED.
+ */
+void enrollar_cobre_auto() {
+    trabajo_t t = {
+        .tipo = TRABAJO_BOBINADO,
+        .titulo = "Cobre Auto (1H)...",
+        .material = MATERIAL_COBRE,
+        .objetivo_pulsos = calcular_vueltas_para_mH(1000), // Objetivo 1 Henrio (1000 mH)
+        .unidad = TRABAJO_VUELTAS,
+        .velocidad = MOTOR_VELOCIDAD_NOMINAL,
+        .detenible = true,
+        .fin_titulo = "Bobina completa!",
+        .fin_detalle = "Vueltas: 1 Henrio",
+    };
+    ejecutar_trabajo(&t);
+}
 
-    int ultima_muestra = 0; // Rastrea el último conteo de pulsos mostrado
+// --- Motor de Trabajos ---
+/**
+ * @brief Escribe en `msg` el total bobinado en la unidad del trabajo.
+ */
+static void formatear_total(char *msg, const trabajo_t *t, int pulsos) {
+    if (t->unidad == TRABAJO_METROS) {
+        sprintf(msg, "Total: %.2f m", (float)pulsos / PULSOS_POR_METRO);
+    } else {
+        sprintf(msg, "Vueltas: %d", pulsos);
+    }
+}
 
-    ssd1306_clear();
-    ssd1306_draw_string(0, 0, "Cobre Manual...");
+/**
+ * @brief Muestra el avance del trabajo en curso.
+ */
+static void mostrar_avance(const trabajo_t *t, int pulsos) {
     char msg[32];
-    sprintf(msg, "%d mH -> %d vueltas", milihenrios, vueltas_objetivo);
+    if (t->tipo == TRABAJO_AUTOAJUSTE) {
+        if (autoajuste.estado == AUTOAJUSTE_ASENTANDO) {
+            sprintf(msg, "Referencia: %ld rpm", (long)rpm_filtrada);
+        } else {
+            sprintf(msg, "Ciclo %d de %d", autoajuste.ciclo, autoajuste.cfg.ciclos + 2);
+        }
+    } else if (t->unidad == TRABAJO_METROS) {
+        sprintf(msg, "Metros: %.2f", (float)pulsos / PULSOS_POR_METRO);
+    } else {
+        sprintf(msg, "Vueltas: %d", pulsos);
+    }
+    ssd1306_clear();
+    ssd1306_draw_string(0, 0, !pausado ? t->titulo : motivo_pausa ? motivo_pausa : "En pausa");
     ssd1306_draw_string(0, 10, msg);
-    ssd1306_draw_string(0, 20, "Presiona SW para parar");
+    if (!t->detenible) {
+        // Sin interruptor: solo lo terminan el objetivo o una falla
+    } else if (t->tipo == TRABAJO_AUTOAJUSTE) {
+        ssd1306_draw_string(0, 20, "Presiona SW");
+    } else if (pausado) {
+        ssd1306_draw_string(0, 20, "SW: seguir");
+        ssd1306_draw_string(0, 30, "Mantener SW: terminar");
+    } else {
+        ssd1306_draw_string(0, 20, "SW: pausa");
+        ssd1306_draw_string(0, 30, "Mantener SW: terminar");
+    }
+    if (t->tipo == TRABAJO_BOBINADO && multifilar.hilos > 1) { // Tensión de cada hilo
+        int n = sprintf(msg, "g:");
+        for (int i = 0; i < multifilar.hilos; i++) {
+            n += sprintf(msg + n, " %ld", (long)hilos_gramos(&hilos, i));
+        }
+        ssd1306_draw_string(0, 40, msg);
+    }
     ssd1306_show();
+}
 
-    gpio_put(MOTOR_EN, 1); // Activa el motor
+/**
+ * @brief Pulsación del interruptor del encoder rotatorio durante un trabajo.
+ */
+typedef enum {
+    SW_NADA = 0, ///< Sin pulsación terminada.
+    SW_CORTA,    ///< Soltado antes de `SW_LARGO_MS`.
+    SW_LARGA,    ///< Mantenido `SW_LARGO_MS` (se avisa sin esperar a que se suelte).
+} sw_pulsacion_t;
 
-    while (pulsos_encoder < vueltas_objetivo) {
-        // Actualiza la pantalla cada 20 pulsos (vueltas)
-        if (pulsos_encoder - ultima_muestra >= 20) {
-            ultima_muestra = pulsos_encoder;
+static sw_pulsacion_t sw_remoto = SW_NADA; ///< Pulsación equivalente a la última orden del PC.
 
-            ssd1306_clear();
-            char vueltas_msg[32];
-            sprintf(vueltas_msg, "Vueltas: %d", pulsos_encoder);
-            ssd1306_draw_string(0, 0, "Cobre Manual...");
-            ssd1306_draw_string(0, 10, vueltas_msg);
-            ssd1306_draw_string(0, 20, "Presiona SW");
-            ssd1306_show();
+/**
+ * @brief Lee SW (o el de la traza que se reproduce) y graba sus cambios en la traza.
+ *
+ * @return `true` si está presionado.
+ */
+static bool sw_presionado(void) {
+    if (traza_reproduciendo()) return sw_traza;
+    bool abajo = !gpio_get(ROT_SW);
+    if (abajo != sw_trazado) {
+        sw_trazado = abajo;
+        trazar(TRAZA_SW, 0, abajo, time_us_32());
+    }
+    return abajo;
+}
+
+/**
+ * @brief Empieza a leer pulsaciones; si SW ya está presionado (viene del menú) no cuenta.
+ */
+static void sw_reiniciar(void) {
+    sw_remoto = SW_NADA;
+    sw_abajo = sw_presionado();
+    sw_ignorar = sw_abajo;
+    sw_desde_us = time_us_32();
+}
+
+/**
+ * @brief Distingue pulsaciones cortas y largas de SW sin bloquear el bucle del trabajo.
+ *
+ * Las pulsaciones más breves que `SW_REBOTE_MS` son rebotes y se descartan. Las órdenes
+ * del PC (pausar, seguir, abortar) llegan por aquí como pulsaciones.
+ * @param ahora Instante actual.
+ * @return Pulsación terminada en esta llamada, si la hay.
+ */
+static sw_pulsacion_t sw_leer(uint32_t ahora) {
+    bool abajo = sw_presionado();
+    if (abajo && !sw_abajo) {
+        sw_abajo = true;
+        sw_desde_us = ahora;
+    } else if (!abajo && sw_abajo) {
+        sw_abajo = false;
+        bool atendida = sw_ignorar;
+        sw_ignorar = false;
+        if (!atendida && ahora - sw_desde_us >= SW_REBOTE_MS * 1000) return SW_CORTA;
+    } else if (abajo && !sw_ignorar && ahora - sw_desde_us >= SW_LARGO_MS * 1000) {
+        sw_ignorar = true; // Al soltarlo no es además una pulsación corta
+        return SW_LARGA;
+    }
+    sw_pulsacion_t remota = sw_remoto;
+    sw_remoto = SW_NADA;
+    return remota;
+}
+
+/**
+ * @brief Pausa el trabajo: el tambor baja en rampa hasta pararse.
+ *
+ * El traslado sigue al tambor mientras se detiene y conserva su fase. La rotura se desarma
+ * (el hilo puede faltar mientras se arregla un enganche o se cambia la bobina) y la tensión
+ * no se vigila; el resto de protecciones y los puntos de control siguen activos.
+ * @param t Trabajo en curso.
+ * @param motivo Título de la pantalla de pausa; `NULL` = pausa pedida por el operario.
+ */
+static void pausar_trabajo(const trabajo_t *t, const char *motivo) {
+    velocidad_pausa = velocidad_objetivo_actual();
+    motivo_pausa = motivo;
+    pausado = true;
+    rotura_desarmar();
+    velocidad_objetivo(0); // El motor se corta al terminar la rampa
+    mostrar_avance(t, pulsos_encoder);
+}
+
+/**
+ * @brief Reanuda un trabajo en pausa a la velocidad que tenía.
+ *
+ * Si el tambor aún no se había parado sube en rampa desde la velocidad actual; si no,
+ * arranca como al empezar, con las protecciones rearmadas para el arranque (plazo del
+ * encoder, pico de corriente, rotura) y las anomalías aprendiendo de nuevo.
+ * @param t Trabajo en pausa.
+ * @param perfil Perfil del material del trabajo.
+ */
+static void reanudar_pausa(const trabajo_t *t, const material_perfil_t *perfil) {
+    pausado = false;
+    rotura_armar(); // Si el hilo no se volvió a colocar, falla en el acto
+    if (motor_encendido()) {
+        velocidad_objetivo(velocidad_pausa);
+    } else {
+        ultimo_pulso_us = time_us_32();
+        periodo_pulso_us = 0; // Motor parado: el último periodo es de antes de la pausa
+        corriente_armar(perfil);
+        reiniciar_anomalias(ultimo_pulso_us);
+        pid_iniciar(&lazo_velocidad, &perfil->pid_velocidad,
+                    -VELOCIDAD_CORRECCION_MAX, VELOCIDAD_CORRECCION_MAX);
+        velocidad_arrancar(velocidad_pausa);
+    }
+    mostrar_avance(t, pulsos_encoder);
+}
+
+/**
+ * @brief Velocidad de un trabajo con un material: la pedida, sin superar el techo aprendido.
+ */
+static uint16_t velocidad_trabajo(const trabajo_t *t, const material_perfil_t *perfil) {
+    if (t->tipo == TRABAJO_BOBINADO && t->velocidad > perfil->velocidad_techo) {
+        return perfil->velocidad_techo;
+    }
+    return t->velocidad;
+}
+
+/**
+ * @brief Paso del traslado de un segmento.
+ */
+static int32_t paso_segmento(const trabajo_segmento_t *s) {
+    return s->paso_mgrad > 0 ? s->paso_mgrad : TRASLADO_PASO_MGRAD;
+}
+
+/**
+ * @brief Pulsos que gira el tambor mientras la rampa baja hasta la velocidad de arranque.
+ *
+ * Estimación por exceso (velocidad actual durante toda la rampa): frenar antes de tiempo
+ * solo alarga un poco el tramo lento.
+ */
+static int32_t pulsos_para_frenar(void) {
+    uint32_t periodo = periodo_pulso_us;
+    uint16_t v = motor_velocidad();
+    if (periodo == 0 || v <= VELOCIDAD_ARRANQUE) return 0;
+    uint32_t rampa_us = (uint32_t)(v - VELOCIDAD_ARRANQUE) * (1000000u / VELOCIDAD_RAMPA);
+    return (int32_t)(rampa_us / periodo);
+}
+
+/**
+ * @brief Ejecuta un trabajo de bobinado de principio a fin.
+ *
+ * Bucle común de todos los trabajos: arma las protecciones y el lazo de velocidad con el
+ * perfil del material, arranca el motor con rampa y, hasta alcanzar el objetivo, mueve el
+ * traslado con el tambor, ejecuta el tick de control y las protecciones (`verificar_fallas()`)
+ * y atiende el interruptor del encoder rotatorio. Muestra el avance y el resultado en el OLED.
+ *
+ * En los bobinados detenibles una pulsación corta pausa el trabajo (rampa hasta parar, el
+ * traslado y los contadores se conservan) y otra lo reanuda; mantener SW lo termina. Un
+ * autoajuste termina con cualquier pulsación.
+ *
+ * En un trabajo con segmentos el material, el lazo y el patrón del traslado cambian en cada
+ * límite. Si el siguiente segmento sigue con el mismo hilo el cambio se hace en marcha; si
+ * pide una toma o un cambio de hilo, el tambor baja a la velocidad de arranque antes del
+ * límite, el motor se corta en él y el trabajo queda en pausa hasta que el operario pulsa SW.
+ *
+ * Con varios hilos en paralelo (ver `configurar_multifilar()`) el paso del traslado es el
+ * ancho del haz, salvo que los segmentos fijen el suyo.
+ *
+ * Los bobinados no superan el techo de velocidad del material; al terminar, el techo del
+ * último material se ajusta con la holgura de tensión observada (ver aprendizaje.h).
+ * @param t Trabajo a ejecutar.
+ * @return Cómo terminó el trabajo.
+ */
+trabajo_resultado_t ejecutar_trabajo(const trabajo_t *t) {
+    int n_segmentos = t->segmentos ? t->n_segmentos : 0;
+    int segmento = 0;
+    int32_t fin_segmento = t->objetivo_pulsos;
+    material_activo = t->material;
+    if (n_segmentos > 0) { // Al reanudar se sigue en el segmento donde se cortó
+        fin_segmento = t->segmentos[0].pulsos;
+        while (segmento + 1 < n_segmentos && t->pulsos_inicio >= fin_segmento) {
+            fin_segmento += t->segmentos[++segmento].pulsos;
         }
+        material_activo = t->segmentos[segmento].material;
+    }
+    const material_perfil_t *perfil = material_perfil(material_activo);
+    uint16_t velocidad = velocidad_trabajo(t, perfil);
+    pulsos_encoder = t->pulsos_inicio; // Reinicia el contador del encoder (o lo recupera al reanudar)
+    iniciar_traslado(t->pulsos_inicio > 0 ? &t->posicion_inicio : NULL);
+    if (n_segmentos > 0) {
+        const trabajo_segmento_t *s = &t->segmentos[segmento];
+        traslado_patron(&traslado, paso_segmento(s), s->invertir && t->pulsos_inicio == 0);
+    } else if (multifilar.hilos > 1) { // Paso = ancho del haz de hilos
+        traslado_patron(&traslado, (int32_t)multifilar.hilos * multifilar.diametro_um
+                                   * TRASLADO_MGRAD_POR_MM / 1000, false);
+    }
+    bool frenando = false;      // Bajando a la velocidad de arranque antes de un límite con parada
+    bool cambio_segmento = false; // En pausa en un límite: el segmento nuevo se aplica al reanudar
+    char motivo[24];            // Título de la pausa en un límite de segmento
+    mostrar_avance(t, t->pulsos_inicio);
+    if (t->tipo == TRABAJO_BOBINADO) {
+        respaldo_armar(); // Sector borrado para los puntos de control (motor aún parado)
+        caida_alimentacion = false;
+        caida_respaldada = false;
+    }
 
-        mover_servo_oscilando(50, 130, 15); // Oscila el servo para la distribución del hilo
+    armar_protecciones();  // Corriente, rotura, encoder y anomalías del nuevo trabajo
+    pid_iniciar(&lazo_velocidad, &perfil->pid_velocidad,
+                -VELOCIDAD_CORRECCION_MAX, VELOCIDAD_CORRECCION_MAX);
+    rpm_filtrada = 0;
+    aprendizaje_empezar(&aprendizaje, velocidad_permitida(velocidad, false));
+    control_retraso_max_us = 0;
+    pausado = false;
+    if (traza_pedida) iniciar_reproduccion(); // Encoder, celdas y SW de la traza (orden del PC)
+    sw_reiniciar();
+    trabajo_actual = t;
+    REGISTRO(REG_TRABAJO_INICIO, t->tipo, material_activo, t->pulsos_inicio, t->objetivo_pulsos);
+    REGISTRO(REG_TRABAJO_ESCALA, (uint32_t)(PULSOS_POR_METRO * 1000), calibracion.pulsos_por_vuelta);
+    REGISTRO(REG_TRABAJO_TARA, tension_tara());
+    velocidad_arrancar(velocidad); // Activa el motor con rampa
+
+    int ultimo_mostrado = t->pulsos_inicio; // Rastrea el último conteo de pulsos mostrado
+    int cada = t->unidad == TRABAJO_METROS ? 100 : 20; // Pulsos entre actualizaciones de pantalla
+    trabajo_resultado_t resultado = TRABAJO_COMPLETO;
+
+    while (t->objetivo_pulsos == 0 || pulsos_encoder < t->objetivo_pulsos) {
+        int pulsos_actuales = pulsos_encoder;
+        if (pulsos_actuales - ultimo_mostrado >= cada) {
+            ultimo_mostrado = pulsos_actuales;
+            mostrar_avance(t, pulsos_actuales);
+        }
+
+        traslado_actualizar(&traslado, pulsos_actuales); // Traslado sincronizado con el tambor
+
+        if (verificar_fallas()) { // Tensión, rotura, corriente, encoder... (ver fallas.h)
+            resultado = TRABAJO_FALLA; // La falla ya se mostró en el OLED
+            break;
+        }
+        falla_t falla = falla_activa();
+        if (falla_pausa(falla)) { // El motor ya está cortado: el trabajo espera a SW como en una pausa
+            if (!pausado) {
+                pausar_trabajo(t, falla_nombre(falla));
+                REGISTRO(REG_PAUSA, pausado, pulsos_actuales);
+            }
+            falla_liberar(falla);
+        }
+
+        if (t->tipo == TRABAJO_AUTOAJUSTE && autoajuste.estado >= AUTOAJUSTE_LISTO) {
+            break; // Ensayo terminado (o abortado por sus límites)
+        }
+
+        sw_pulsacion_t sw = t->detenible ? sw_leer(time_us_32()) : SW_NADA;
+        if (sw == SW_LARGA || (sw == SW_CORTA && t->tipo == TRABAJO_AUTOAJUSTE)) {
+            resultado = TRABAJO_DETENIDO;
+            break;
+        }
+        if (sw == SW_CORTA) {
+            if (pausado) {
+                if (cambio_segmento) { // Toma o hilo nuevo listos: material y patrón del segmento
+                    const trabajo_segmento_t *s = &t->segmentos[segmento];
+                    cambio_segmento = false;
+                    material_activo = s->material;
+                    perfil = material_perfil(material_activo);
+                    velocidad = velocidad_trabajo(t, perfil);
+                    velocidad_pausa = velocidad;
+                    aprendizaje_empezar(&aprendizaje, velocidad_permitida(velocidad, false));
+                    traslado_patron(&traslado, paso_segmento(s), s->invertir);
+                }
+                reanudar_pausa(t, perfil);
+            } else {
+                pausar_trabajo(t, NULL);
+            }
+            REGISTRO(REG_PAUSA, pausado, pulsos_actuales);
+        }
+        if (pausado && motor_encendido() && !velocidad_en_rampa()) {
+            motor_cortar(); // Rampa terminada: el tambor se para por inercia
+        }
+
+        if (segmento + 1 < n_segmentos && !cambio_segmento) {
+            const trabajo_segmento_t *s = &t->segmentos[segmento + 1];
+            bool parar = s->inicio != SEGMENTO_SEGUIR || s->material != material_activo;
+            if (parar && !frenando && !pausado && fin_segmento - pulsos_actuales <= pulsos_para_frenar()) {
+                velocidad_objetivo(VELOCIDAD_ARRANQUE); // Llega despacio para parar en el límite
+                frenando = true;
+            }
+            if (pulsos_actuales >= fin_segmento) {
+                segmento++;
+                fin_segmento += s->pulsos;
+                frenando = false;
+                REGISTRO(REG_SEGMENTO, segmento + 1, n_segmentos, pulsos_actuales, parar);
+                if (parar) {
+                    motor_cortar(); // Desde la velocidad de arranque el tambor para casi en el límite
+                    sprintf(motivo, "%s %d/%d", s->inicio == SEGMENTO_TOMA ? "Toma" : "Cambiar hilo",
+                            segmento + 1, n_segmentos);
+                    pausar_trabajo(t, motivo);
+                    cambio_segmento = true;
+                } else {
+                    traslado_patron(&traslado, paso_segmento(s), s->invertir); // En marcha
+                    mostrar_avance(t, pulsos_actuales);
+                }
+            }
+        }
+    }
+
+    motor_cortar(); // Detiene el motor (tras una falla ya está cortado)
+    pausado = false;
+    if (t->tipo == TRABAJO_BOBINADO) {
+        punto_control_t p;
+        if (resultado == TRABAJO_FALLA && falla_activa() == FALLA_ALIMENTACION
+                && capturar_punto_control(&p)) {
+            guardar_punto_ram(&p); // La alimentación volvió: posición final, con el tambor ya detenido
+            if (!respaldo_guardar_final(&p, sizeof(p))) {
+                // La RAM la conserva ante un reinicio, pero no ante otro apagón
+                REGISTRO(REG_RESPALDO_FALLIDO, p.pulsos);
+                ssd1306_clear();
+                ssd1306_draw_string(0, 0, "Respaldo fallido");
+                ssd1306_draw_string(0, 10, "Reanude sin apagar");
+                ssd1306_show();
+                sleep_ms(2000);
+            }
+        } else {
+            punto_ram.magico = 0; // Trabajo terminado: nada que reanudar
+            respaldo_cerrar();
+        }
+    }
+    trabajo_actual = NULL;
+    if (t->tipo == TRABAJO_BOBINADO && velocidad == perfil->velocidad_techo) {
+        static const aprendizaje_config_t techo_cfg = {
+            .minimo = MOTOR_VELOCIDAD_MIN,
+            .maximo = MOTOR_VELOCIDAD_MAX,
+            .paso_subida = TECHO_PASO_SUBIDA,
+            .paso_bajada = TECHO_PASO_BAJADA,
+            .margen_pct = TECHO_MARGEN_PCT,
+            .muestras_min = TECHO_REGIMEN_MS * 1000 / CONTROL_PERIODO_US,
+        };
+        falla_t falla = falla_activa();
+        bool falla_hilo = resultado == TRABAJO_FALLA
+            && (falla == FALLA_TENSION_ALTA || falla == FALLA_ROTURA
+                || falla == FALLA_ANOMALIA || falla == FALLA_ATASCO);
+        uint16_t techo = aprendizaje_techo(&techo_cfg, &aprendizaje, perfil->tension_max, falla_hilo);
+        // Una subida que cae en una banda resonante la salta: rebajada a su borde inferior,
+        // el techo nunca se alcanzaría y no podría volver a subir
+        material_guardar_velocidad_techo(material_activo, velocidad_permitida(techo, techo > aprendizaje.techo));
+        guardar_material(material_activo);
+    }
+    if (t->tipo == TRABAJO_BOBINADO) {
+        if (t->pulsos_inicio == 0) contadores.trabajos++; // Una reanudación no es un trabajo nuevo
+        if (resultado == TRABAJO_COMPLETO) contadores.completos++;
+        if (resultado == TRABAJO_FALLA) contadores.fallas++;
+        contadores.pulsos += pulsos_encoder - t->pulsos_inicio;
+        persistencia_marcar(CLAVE_CONTADORES); // Se guarda al quedar quieto el tambor
+        REGISTRO(REG_CONTROL_RETRASO, control_retraso_max_us);
+    }
+    terminar_reproduccion(); // Vuelven los sensores reales
+    REGISTRO(REG_TRABAJO_FIN, resultado, pulsos_encoder, falla_activa());
+    REGISTRO(REG_TELEMETRIA_PERDIDAS, telemetria_perdidas(), registro_perdidos());
+    if (resultado == TRABAJO_FALLA) return resultado;
 
-        if (leer_fuerza() > 3000) { // Verifica si hay tensión excesiva (simulada)
-            gpio_put(MOTOR_EN, 0); // Detiene el motor
+    char msg[32];
+    if (resultado == TRABAJO_DETENIDO) {
+        ssd1306_clear();
+        ssd1306_draw_string(0, 0, "Enrollado detenido.");
+        formatear_total(msg, t, pulsos_encoder);
+        ssd1306_draw_string(0, 10, msg);
+        ssd1306_show();
+        while (!gpio_get(ROT_SW)) { // Que el menú no tome la pulsación mantenida
+            watchdog_update();
+            sleep_ms(10);
+        }
+        sleep_ms(2000);
+    } else if (t->fin_titulo) {
+        ssd1306_clear();
+        ssd1306_draw_string(0, 0, t->fin_titulo);
+        if (t->fin_detalle) {
+            ssd1306_draw_string(0, 10, t->fin_detalle);
+        } else {
+            formatear_total(msg, t, pulsos_encoder);
+            ssd1306_draw_string(0, 10, msg);
+        }
+        ssd1306_show();
+        sleep_ms(2000);
+    }
+    return resultado;
+}
+
+/**
+ * @brief Busca un punto de operación del ensayo del relé fuera de las bandas resonantes.
+ *
+ * El relé recorre todo el intervalo `[u0 - d, u0 + d]`: si toca una banda, la resonancia se
+ * mezcla con la oscilación medida y el periodo crítico sale falso. Si alguna lo toca, el
+ * intervalo se corre justo por debajo y justo por encima de las bandas, y se elige el punto
+ * libre más cercano a `u0`.
+ * @param u0 Punto de operación deseado.
+ * @param d Amplitud del relé.
+ * @return Punto de operación libre, o -1 si no cabe ninguno en el rango del motor.
+ */
+static int32_t autoajuste_punto_libre(int32_t u0, int32_t d) {
+    int n;
+    const resonancia_banda_t *b = resonancia_bandas(&n);
+    int32_t abajo = u0, arriba = u0;
+    for (int i = n - 1; i >= 0; i--) { // Bandas en orden creciente: bajando, de la más alta a la más baja
+        if (b[i].desde <= abajo + d && b[i].hasta >= abajo - d) abajo = b[i].desde - 1 - d;
+    }
+    for (int i = 0; i < n; i++) {
+        if (b[i].desde <= arriba + d && b[i].hasta >= arriba - d) arriba = b[i].hasta + 1 + d;
+    }
+    bool abajo_libre = abajo - d >= VELOCIDAD_ARRANQUE;
+    bool arriba_libre = arriba + d <= MOTOR_VELOCIDAD_MAX;
+    if (abajo_libre && (!arriba_libre || u0 - abajo <= arriba - u0)) return abajo;
+    return arriba_libre ? arriba : -1;
+}
+
+/**
+ * @brief Ajusta el lazo de velocidad de un material con el ensayo del relé.
+ *
+ * Debe hacerse con el material colocado, como en un bobinado normal: el ensayo es un
+ * trabajo más (protecciones armadas, traslado activo, SW lo detiene). El motor sube al
+ * punto de operación, se mide la velocidad de referencia y el relé hace oscilar la
+ * velocidad; con el periodo y la amplitud se calculan las ganancias (ver autoajuste.h),
+ * que se guardan en el perfil del material. El punto de operación se aleja de las bandas
+ * resonantes (ver `autoajuste_punto_libre()`).
+ * @param material Material a ajustar.
+ */
+void autoajustar_velocidad(int material) {
+    autoajuste_config_t cfg = {
+        .regla = AUTOAJUSTE_REGLA,
+        .u0 = autoajuste_punto_libre(AUTOAJUSTE_U0, AUTOAJUSTE_RELE),
+        .d = AUTOAJUSTE_RELE,
+        .histeresis = AUTOAJUSTE_HISTERESIS_RPM,
+        .ciclos = 4,
+        .asentamiento_us = 2000000,
+        .plazo_us = AUTOAJUSTE_PLAZO_MS * 1000,
+        .excursion_max = AUTOAJUSTE_EXCURSION_RPM,
+    };
+    if (cfg.u0 < 0) {
+        ssd1306_clear();
+        ssd1306_draw_string(0, 0, "Autoajuste fallido");
+        ssd1306_draw_string(0, 10, "Todo resuena");
+        ssd1306_show();
+        sleep_ms(2000);
+        return;
+    }
+    trabajo_t t = {
+        .tipo = TRABAJO_AUTOAJUSTE,
+        .titulo = "Autoajuste PID...",
+        .material = material,
+        .objetivo_pulsos = 0, // Hasta que termine el ensayo
+        .unidad = TRABAJO_VUELTAS,
+        .velocidad = (uint16_t)cfg.u0,
+        .detenible = true,
+    };
+    autoajuste_iniciar(&autoajuste, &cfg);
+    trabajo_resultado_t r = ejecutar_trabajo(&t);
+    if (r != TRABAJO_COMPLETO) return;
+
+    pid_ganancias_t g;
+    int32_t rpm_por_milesima_q8;
+    ssd1306_clear();
+    if (autoajuste_resultado(&autoajuste, &g, &rpm_por_milesima_q8)) {
+        material_guardar_pid_velocidad(material, &g, rpm_por_milesima_q8);
+        guardar_material(material);
+        char msg[32];
+        ssd1306_draw_string(0, 0, "Autoajuste listo");
+        sprintf(msg, "Kp: %.3f", g.kp_q16 / 65536.0f);
+        ssd1306_draw_string(0, 10, msg);
+        sprintf(msg, "Ki: %.3f /s", g.ki_q16 / 65536.0f);
+        ssd1306_draw_string(0, 20, msg);
+    } else {
+        ssd1306_draw_string(0, 0, "Autoajuste fallido");
+        ssd1306_draw_string(0, 10, "Ganancias sin cambio");
+    }
+    ssd1306_show();
+    sleep_ms(2000);
+}
+
+// --- Producción por lotes ---
+/**
+ * @brief Selector genérico de un entero con el encoder rotatorio.
+ *
+ * @param titulo Primera línea del OLED.
+ * @param formato Formato `printf` del valor.
+ * @param valor Valor inicial.
+ * @param minimo Valor mínimo.
+ * @param maximo Valor máximo.
+ * @param paso Cambio por cada paso del encoder.
+ * @return Valor confirmado con SW.
+ */
+static int seleccionar_valor(const char *titulo, const char *formato, int valor, int minimo, int maximo, int paso) {
+    int last_clk = gpio_get(ROT_CLK); // Estado inicial del pin CLK
+    bool redibujar = true; // Muestra el valor inicial antes del primer giro
+
+    while (1) {
+        watchdog_update(); // Mantiene vivo el watchdog mientras se espera al usuario
+        int clk = gpio_get(ROT_CLK);
+        int dt = gpio_get(ROT_DT);
+        if (clk != last_clk) { // Encoder rotatorio girado
+            valor += dt != clk ? paso : -paso; // Horario suma, antihorario resta
+            if (valor < minimo) valor = minimo;
+            if (valor > maximo) valor = maximo;
+            last_clk = clk;
+            redibujar = true;
+            sleep_ms(100); // Debounce para el encoder rotatorio
+        }
+
+        if (redibujar) {
+            redibujar = false;
+            char buffer[32];
+            sprintf(buffer, formato, valor);
             ssd1306_clear();
-            ssd1306_draw_string(0, 0, "TENSION EXCESIVA!");
-            ssd1306_draw_string(0, 10, "Motor detenido.");
+            ssd1306_draw_string(0, 0, titulo);
+            ssd1306_draw_string(0, 10, buffer);
+            ssd1306_draw_string(0, 20, "Presiona SW");
             ssd1306_show();
-            return; // Sale del bobinado
         }
 
-        if (!gpio_get(ROT_SW)) { // Verifica si se presiona el interruptor del encoder rotatorio
+        if (!gpio_get(ROT_SW)) { // Interruptor del encoder rotatorio presionado
             sleep_ms(200); // Debounce
-            gpio_put(MOTOR_EN, 0); // Detiene el motor
-            ssd1306_clear();
-            ssd1306_draw_string(0, 0, "Enrollado detenido.");
-            char final_msg[32];
-            sprintf(final_msg, "Vueltas: %d", pulsos_encoder);
-            ssd1306_draw_string(0, 10, final_msg);
-            ssd1306_show();
-            sleep_ms(2000);
-            return; // Sale del bobinado
+            return valor;
         }
+
+        sleep_ms(20);
     }
+}
 
-    gpio_put(MOTOR_EN, 0); // Detiene el motor cuando se alcanza el objetivo
+/**
+ * @brief Pausa entre bobinas de un lote para retirar la terminada.
+ *
+ * El tambor está parado: los cambios pendientes se guardan en flash mientras se espera.
+ * @param t Trabajo de la bobina que acaba de terminar.
+ * @param falla Falla que la interrumpió, o `FALLA_NINGUNA`.
+ * @return `true` para seguir con la siguiente bobina (SW o SEGUIR del PC), `false` para terminar
+ *         el lote (SW mantenido o ABORTAR).
+ */
+static bool esperar_relevo(const trabajo_t *t, falla_t falla) {
+    char msg[32];
     ssd1306_clear();
-    ssd1306_draw_string(0, 0, "Bobina completada!");
-    char final_msg[32];
-    sprintf(final_msg, "%d mH", milihenrios);
-    ssd1306_draw_string(0, 10, final_msg);
+    if (falla != FALLA_NINGUNA) {
+        ssd1306_draw_string(0, 0, falla_nombre(falla));
+        sprintf(msg, "Repetir bobina %u", lote.completas + 1);
+    } else {
+        sprintf(msg, "Bobina %u/%u lista", lote.completas, lote.receta.cantidad);
+        ssd1306_draw_string(0, 0, msg);
+        sprintf(msg, "Retira la bobina");
+    }
+    ssd1306_draw_string(0, 10, msg);
+    formatear_total(msg, t, (int)lote.pulsos);
+    ssd1306_draw_string(0, 20, msg);
+    ssd1306_draw_string(0, 30, "SW: siguiente");
+    ssd1306_draw_string(0, 40, "Mantener SW: terminar");
     ssd1306_show();
-    sleep_ms(2000);
+
+    sw_reiniciar();
+    en_relevo = true;
+    sw_pulsacion_t sw = SW_NADA;
+    while (sw == SW_NADA) {
+        watchdog_update(); // Mantiene vivo el watchdog mientras se espera al usuario
+        atender_persistencia(); // Tambor quieto: buen momento para escribir en flash
+        telemetria_atender();
+        atender_remoto();
+        sw = sw_leer(time_us_32());
+        sleep_ms(10);
+    }
+    en_relevo = false;
+    return sw == SW_CORTA;
 }
 
 /**
- * @brief Realiza el bobinado automático de hilo de cobre para una inductancia objetivo de 1 Henrio.
+ * @brief Bobina un lote con la receta guardada (cantidad y variación) y el valor indicado.
  *
- * Calcula las vueltas requeridas para 1 Henrio (1000 mH). El motor funciona
- * hasta que `pulsos_encoder` (representando vueltas) alcanza las `vueltas_objetivo`.
- * El servo oscila para la distribución del hilo. El bobinado puede detenerse presionando
- * el interruptor del encoder rotatorio o si se detecta tensión excesiva.
- * Muestra el progreso del bobinado (vueltas) en el OLED.
+ * Entre bobinas el trabajo se detiene para retirar la terminada y una pulsación de SW arranca
+ * la siguiente. Tras una falla la misma bobina se repite. Al final se muestran los totales.
+ * @param material Material del lote (`MATERIAL_HILO` o `MATERIAL_COBRE`).
+ * @param valor Valor de la primera bobina (metros o mH).
  */
-void enrollar_cobre_auto() {
-    int vueltas_objetivo = calcular_vueltas_para_mH(1000); // Objetivo 1 Henrio (1000 mH)
-    pulsos_encoder = 0; // Reinicia el contador global del encoder
-
-    int ultima_muestra = 0;
+static void ejecutar_lote(int material, int valor) {
+    bool hilo = material == MATERIAL_HILO;
+    const lote_receta_t r = { valor, receta.lote_variacion, receta.lote_cantidad };
+    lote_iniciar(&lote, &r);
+    char titulo[24];
+    trabajo_t t = {
+        .tipo = TRABAJO_BOBINADO,
+        .titulo = titulo,
+        .material = material,
+        .unidad = hilo ? TRABAJO_METROS : TRABAJO_VUELTAS,
+        .velocidad = MOTOR_VELOCIDAD_NOMINAL,
+        .detenible = true,
+    };
+
+    while (lote_pendiente(&lote)) {
+        int v = lote_valor(&lote);
+        sprintf(titulo, "Lote %u/%u...", lote.completas + 1, lote.receta.cantidad);
+        t.objetivo_pulsos = hilo ? v * PULSOS_POR_METRO : calcular_vueltas_para_mH(v);
+        trabajo_resultado_t res = ejecutar_trabajo(&t);
+        lote_registrar(&lote, res == TRABAJO_COMPLETO, pulsos_encoder);
+        if (res == TRABAJO_DETENIDO || !lote_pendiente(&lote)) break;
+        if (!esperar_relevo(&t, res == TRABAJO_FALLA ? falla_activa() : FALLA_NINGUNA)) break;
+    }
 
+    char msg[32];
     ssd1306_clear();
-    ssd1306_draw_string(0, 0, "Cobre Auto (1H)...");
-    ssd1306_draw_string(0, 10, "Vueltas: ");
-    char vueltas_msg[16];
-    sprintf(vueltas_msg, "%d", vueltas_objetivo);
-    ssd1306_draw_string(60, 10, vueltas_msg);
+    ssd1306_draw_string(0, 0, lote_pendiente(&lote) ? "Lote interrumpido" : "Lote completo!");
+    sprintf(msg, "Bobinas: %u/%u", lote.completas, lote.receta.cantidad);
+    ssd1306_draw_string(0, 10, msg);
+    sprintf(msg, "Fallidas: %u", lote.fallidas);
+    ssd1306_draw_string(0, 20, msg);
+    formatear_total(msg, &t, (int)lote.pulsos);
+    ssd1306_draw_string(0, 30, msg);
+    ssd1306_draw_string(0, 40, "Presiona SW");
     ssd1306_show();
+    sw_reiniciar();
+    en_relevo = true;
+    while (sw_leer(time_us_32()) == SW_NADA) { // Cualquier pulsación, o SEGUIR del PC
+        watchdog_update();
+        atender_persistencia();
+        telemetria_atender();
+        atender_remoto();
+        sleep_ms(10);
+    }
+    en_relevo = false;
+}
 
-    gpio_put(MOTOR_EN, 1); // Activa el motor
+/**
+ * @brief Bobina un lote: la misma receta N veces seguidas, sin volver a los menús.
+ *
+ * Se eligen el valor (metros de hilo o mH de cobre), la cantidad y la variación por bobina;
+ * los tres se recuerdan para el próximo lote (ver `ejecutar_lote()`).
+ * @param material Material del lote (`MATERIAL_HILO` o `MATERIAL_COBRE`).
+ */
+void enrollar_lote(int material) {
+    bool hilo = material == MATERIAL_HILO;
+    int valor = hilo ? seleccionar_metros() : seleccionar_mHenrios();
+    receta.lote_cantidad = (uint16_t)seleccionar_valor("LOTE", "Bobinas: %d", receta.lote_cantidad,
+                                                       1, LOTE_MAX_BOBINAS, 1);
+    receta.lote_variacion = (int16_t)seleccionar_valor("LOTE: VARIACION", hilo ? "%+d m/bobina" : "%+d mH/bobina",
+                                                       receta.lote_variacion, -LOTE_VARIACION_MAX, LOTE_VARIACION_MAX, 1);
+    persistencia_marcar(CLAVE_RECETA); // Se recuerda tras apagar
+    ejecutar_lote(material, valor);
+}
 
-    while (pulsos_encoder < vueltas_objetivo) {
-        // Actualiza la pantalla cada 20 pulsos (vueltas)
-        if (pulsos_encoder - ultima_muestra >= 20) {
-            ultima_muestra = pulsos_encoder;
+// --- Secuencias de segmentos ---
+/**
+ * @brief Selector de una opción de una lista con el encoder rotatorio.
+ *
+ * @param titulo Primera línea del OLED.
+ * @param opciones Nombres de las opciones.
+ * @param n Número de opciones.
+ * @param actual Opción inicial.
+ * @return Opción confirmada con SW.
+ */
+static int seleccionar_opcion(const char *titulo, const char *const *opciones, int n, int actual) {
+    int last_clk = gpio_get(ROT_CLK); // Estado inicial del pin CLK
+    bool redibujar = true; // Muestra la opción inicial antes del primer giro
+    if (actual < 0 || actual >= n) actual = 0;
 
+    while (1) {
+        watchdog_update(); // Mantiene vivo el watchdog mientras se espera al usuario
+        int clk = gpio_get(ROT_CLK);
+        int dt = gpio_get(ROT_DT);
+        if (clk != last_clk) { // Encoder rotatorio girado: cicla entre las opciones
+            actual = (actual + (dt != clk ? 1 : n - 1)) % n;
+            last_clk = clk;
+            redibujar = true;
+            sleep_ms(100); // Debounce para el encoder rotatorio
+        }
+
+        if (redibujar) {
+            redibujar = false;
+            char buffer[32];
+            sprintf(buffer, "> %s", opciones[actual]);
             ssd1306_clear();
-            char msg[32];
-            sprintf(msg, "Vueltas: %d", pulsos_encoder);
-            ssd1306_draw_string(0, 0, "Cobre Auto (1H)...");
-            ssd1306_draw_string(0, 10, msg);
-            ssd1306_draw_string(0, 20, "Presiona SW para parar");
+            ssd1306_draw_string(0, 0, titulo);
+            ssd1306_draw_string(0, 10, buffer);
+            ssd1306_draw_string(0, 20, "Presiona SW");
             ssd1306_show();
         }
 
-        mover_servo_oscilando(50, 130, 15); // Oscila el servo
+        if (!gpio_get(ROT_SW)) { // Interruptor del encoder rotatorio presionado
+            sleep_ms(200); // Debounce
+            return actual;
+        }
+
+        sleep_ms(20);
+    }
+}
+
+/**
+ * @brief Edita la secuencia de segmentos y la guarda en flash.
+ *
+ * Para cada segmento se eligen las vueltas, el material, cómo se entra en él (seguir en
+ * marcha, parar para una toma o para cambiar de hilo), el sentido del traslado y su paso.
+ */
+void editar_secuencia() {
+    static const char *const inicios[] = { "Seguir", "Toma", "Cambio de hilo" };
+    static const char *const sentidos[] = { "Mismo sentido", "Invertir sentido" };
+    const char *materiales[MATERIAL_NUM];
+    for (int m = 0; m < MATERIAL_NUM; m++) {
+        materiales[m] = material_perfil(m)->nombre;
+    }
+
+    int ppv = calibracion.pulsos_por_vuelta;
+    secuencia.n = (uint8_t)seleccionar_valor("SECUENCIA", "Segmentos: %d", secuencia.n,
+                                             1, SECUENCIA_MAX_SEGMENTOS, 1);
+    for (int i = 0; i < secuencia.n; i++) {
+        trabajo_segmento_t *s = &secuencia.segmentos[i];
+        char titulo[24];
+        sprintf(titulo, "SEGMENTO %d/%d", i + 1, secuencia.n);
+        int vueltas = s->pulsos / ppv;
+        s->pulsos = seleccionar_valor(titulo, "Vueltas: %d", vueltas > 0 ? vueltas : 100, 1, 9999, 1) * ppv;
+        s->material = (uint8_t)seleccionar_opcion(titulo, materiales, MATERIAL_NUM, s->material);
+        s->inicio = i == 0 ? SEGMENTO_SEGUIR : (uint8_t)seleccionar_opcion(titulo, inicios, 3, s->inicio);
+        s->invertir = (uint8_t)seleccionar_opcion(titulo, sentidos, 2, s->invertir);
+        s->paso_mgrad = seleccionar_valor(titulo, "Paso: %d mgrad/v", paso_segmento(s), 100, 20000, 100);
+    }
+    persistencia_marcar(CLAVE_SECUENCIA); // Se recuerda tras apagar
+}
+
+/**
+ * @brief Bobina la secuencia guardada como un único trabajo con segmentos.
+ */
+void bobinar_secuencia() {
+    trabajo_t t = {
+        .tipo = TRABAJO_BOBINADO,
+        .titulo = "Secuencia...",
+        .material = secuencia.segmentos[0].material,
+        .unidad = TRABAJO_VUELTAS,
+        .velocidad = MOTOR_VELOCIDAD_NOMINAL,
+        .detenible = true,
+        .fin_titulo = "Secuencia completa!",
+        .segmentos = secuencia.segmentos,
+        .n_segmentos = secuencia.n,
+    };
+    for (int i = 0; i < secuencia.n; i++) {
+        t.objetivo_pulsos += secuencia.segmentos[i].pulsos;
+    }
+    ejecutar_trabajo(&t);
+}
+
+// --- Funciones de Calibración ---
+/**
+ * @brief Un paso del bucle de calibración: traslado y protecciones.
+ *
+ * @return `false` si una falla detuvo el motor.
+ */
+static bool calibrar_paso() {
+    traslado_actualizar(&traslado, pulsos_encoder);
+    return !verificar_fallas();
+}
+
+/**
+ * @brief Recorre las velocidades del tambor y mide la vibración en cada escalón.
+ *
+ * @param velocidades Recibe la velocidad de cada escalón.
+ * @param energias Recibe la energía de vibración de cada escalón.
+ * @return Número de escalones medidos, o -1 si una falla detuvo el barrido.
+ */
+static int barrer_resonancias(uint16_t *velocidades, uint32_t *energias) {
+    int n = 0;
+    velocidad_arrancar(MOTOR_VELOCIDAD_MIN);
+    for (uint16_t v = MOTOR_VELOCIDAD_MIN; v <= MOTOR_VELOCIDAD_MAX && n < RESONANCIA_MAX_ESCALONES;
+            v += RESONANCIA_PASO) {
+        velocidad_objetivo(v);
+        while (velocidad_en_rampa()) {
+            if (!calibrar_paso()) return -1;
+        }
+        uint32_t inicio = time_us_32();
+        while (time_us_32() - inicio < RESONANCIA_ASENTAMIENTO_MS * 1000) {
+            if (!calibrar_paso()) return -1;
+        }
+        resonancia_capturar();
+        while (!resonancia_captura_lista()) {
+            if (!calibrar_paso()) return -1;
+        }
+
+        uint32_t hz;
+        velocidades[n] = v;
+        energias[n] = resonancia_analizar(&hz);
+        n++;
+
+        ssd1306_clear();
+        char msg[32];
+        ssd1306_draw_string(0, 0, "Calibrando...");
+        sprintf(msg, "Vel: %u/1000", v);
+        ssd1306_draw_string(0, 10, msg);
+        sprintf(msg, "Vibracion: %lu Hz", (unsigned long)hz);
+        ssd1306_draw_string(0, 20, msg);
+        ssd1306_show();
+    }
+    motor_cortar(); // Detiene el motor al terminar el barrido
+    return n;
+}
 
-        if (leer_fuerza() > 3000) { // Verifica si hay tensión excesiva (simulada)
-            gpio_put(MOTOR_EN, 0); // Detiene el motor
+/**
+ * @brief Barre las velocidades del tambor y guarda las bandas resonantes.
+ *
+ * Debe hacerse con hilo colocado y tensado, como en un bobinado normal: el traslado
+ * acompaña al tambor y las protecciones siguen armadas. En cada escalón se espera a que
+ * la velocidad se asiente, se captura y analiza la vibración del canal de tensión y se
+ * muestra la frecuencia dominante. Al final se guardan las bandas (ver resonancia.h).
+ */
+void calibrar_resonancias() {
+    static uint16_t velocidades[RESONANCIA_MAX_ESCALONES];
+    static uint32_t energias[RESONANCIA_MAX_ESCALONES];
+
+    pulsos_encoder = 0; // Reinicia el contador del encoder
+    iniciar_traslado(NULL);
+    resonancia_borrar(); // El barrido debe poder detenerse también en las bandas conocidas
+    armar_protecciones();
+    calibrando = true;   // Las vibraciones de una resonancia no deben ralentizar el barrido
+    int n = barrer_resonancias(velocidades, energias);
+    calibrando = false;
+    if (n < 0) {         // Falla: ya se mostró en el OLED
+        // Vuelven las bandas del último barrido completo
+        resonancia_restaurar(bandas_guardadas.bandas, bandas_guardadas.n);
+        return;
+    }
+
+    resonancia_detectar(velocidades, energias, n);
+    const resonancia_banda_t *bandas = resonancia_bandas(&bandas_guardadas.n);
+    for (int i = 0; i < bandas_guardadas.n; i++) {
+        bandas_guardadas.bandas[i] = bandas[i];
+    }
+    persistencia_marcar(CLAVE_BANDAS);
+    mostrar_bandas();
+}
+
+/**
+ * @brief Ajusta el diámetro del tambor con el encoder rotatorio y lo guarda en flash.
+ *
+ * El diámetro fija la conversión de pulsos a metros; antes era una constante de compilación.
+ */
+void calibrar_tambor() {
+    int centesimas = (int)(calibracion.diametro_tambor_cm * 100 + 0.5f);
+    int last_clk = gpio_get(ROT_CLK);
+    bool redibujar = true;
+
+    while (1) {
+        watchdog_update(); // Mantiene vivo el watchdog mientras se espera al usuario
+        int clk = gpio_get(ROT_CLK);
+        int dt = gpio_get(ROT_DT);
+        if (clk != last_clk) { // Encoder rotatorio girado
+            centesimas += dt != clk ? 1 : -1;
+            if (centesimas < 50) centesimas = 50;     // 0.5 cm mínimo
+            if (centesimas > 1000) centesimas = 1000; // 10 cm máximo
+            last_clk = clk;
+            redibujar = true;
+            sleep_ms(100); // Debounce para el encoder rotatorio
+        }
+
+        if (redibujar) {
+            redibujar = false;
+            char buffer[32];
             ssd1306_clear();
-            ssd1306_draw_string(0, 0, "TENSION EXCESIVA!");
-            ssd1306_draw_string(0, 10, "Motor detenido.");
+            ssd1306_draw_string(0, 0, "DIAMETRO TAMBOR");
+            sprintf(buffer, "%d.%02d cm", centesimas / 100, centesimas % 100);
+            ssd1306_draw_string(0, 10, buffer);
+            sprintf(buffer, "%u pulsos/vuelta", calibracion.pulsos_por_vuelta);
+            ssd1306_draw_string(0, 20, buffer);
+            ssd1306_draw_string(0, 30, "Presiona SW");
             ssd1306_show();
-            return; // Sale del bobinado
         }
 
-        if (!gpio_get(ROT_SW)) { // Verifica si se presiona el interruptor del encoder rotatorio
+        if (!gpio_get(ROT_SW)) { // Interruptor del encoder rotatorio presionado
             sleep_ms(200); // Debounce
-            gpio_put(MOTOR_EN, 0); // Detiene el motor
-            ssd1306_clear();
-            ssd1306_draw_string(0, 0, "Enrollado detenido.");
-            char final_msg[32];
-            sprintf(final_msg, "Vueltas: %d", pulsos_encoder);
-            ssd1306_draw_string(0, 10, final_msg);
-            ssd1306_show();
-            sleep_ms(2000);
-            return; // Sale del bobinado
+            calibracion.diametro_tambor_cm = centesimas / 100.0f;
+            persistencia_marcar(CLAVE_CALIBRACION);
+            return;
         }
+
+        sleep_ms(20);
+    }
+}
+
+/**
+ * @brief Configura el bobinado de varios hilos en paralelo (bifilar, multifilar).
+ *
+ * Se eligen los hilos y el diámetro de cada uno; con más de un hilo todos los bobinados
+ * vigilan la tensión de cada hilo con su celda y el traslado avanza el ancho del haz por
+ * vuelta. Las celdas se taran aquí, sin hilo tensado. Con 1 hilo vuelve el modo normal.
+ */
+void configurar_multifilar() {
+    multifilar.hilos = (uint8_t)seleccionar_valor("MULTIFILAR", "Hilos: %d", multifilar.hilos, 1, HILOS_MAX, 1);
+    if (multifilar.hilos > 1) {
+        multifilar.diametro_um = (uint16_t)seleccionar_valor("MULTIFILAR", "Diametro: %d um",
+                                                             multifilar.diametro_um, 50, 3000, 10);
     }
+    hilos_iniciar(&hilos, multifilar.hilos, HX711_CUENTAS_POR_G);
+    persistencia_marcar(CLAVE_MULTIFILAR);
+    if (multifilar.hilos == 1) return;
 
-    gpio_put(MOTOR_EN, 0); // Detiene el motor cuando se alcanza el objetivo
     ssd1306_clear();
-    ssd1306_draw_string(0, 0, "Bobina completa!");
-    ssd1306_draw_string(0, 10, "Vueltas: 1 Henrio");
+    ssd1306_draw_string(0, 0, "Tarando celdas...");
+    ssd1306_draw_string(0, 10, "Sin hilo tensado");
+    ssd1306_show();
+    bool ok = tarar_hilos();
+    ssd1306_draw_string(0, 20, ok ? "Celdas listas" : "Sin respuesta");
     ssd1306_show();
     sleep_ms(2000);
 }
 
+/**
+ * @brief Muestra las bandas de velocidad prohibidas hasta que se presiona el interruptor.
+ */
+void mostrar_bandas() {
+    int n;
+    const resonancia_banda_t *bandas = resonancia_bandas(&n);
+    ssd1306_clear();
+    ssd1306_draw_string(0, 0, n ? "Bandas prohibidas:" : "Sin resonancias.");
+    for (int i = 0; i < n; i++) {
+        char msg[32];
+        sprintf(msg, "%u - %u /1000", bandas[i].desde, bandas[i].hasta);
+        ssd1306_draw_string(0, 10 * (i + 1), msg);
+    }
+    ssd1306_draw_string(0, 50, "Presiona SW");
+    ssd1306_show();
+
+    while (gpio_get(ROT_SW)) { // Espera a que se presione el interruptor
+        watchdog_update();
+        sleep_ms(20);
+    }
+    sleep_ms(200); // Debounce
+}
+
+// --- Reanudación ---
+/**
+ * @brief Lee el punto de control pendiente, si lo hay.
+ *
+ * El de RAM (se actualiza en cada tick de control) es el más reciente si sobrevivió al
+ * reinicio; tras un apagón solo queda el de flash.
+ * @param p Recibe el punto de control.
+ * @return `true` si hay un bobinado a medias.
+ */
+static bool leer_punto_control(punto_control_t *p) {
+    if (punto_ram_valido()) {
+        *p = punto_ram.p;
+        return true;
+    }
+    return respaldo_leer(p, sizeof(*p));
+}
+
+/**
+ * @brief Ofrece reanudar un bobinado interrumpido por un apagón o un reinicio.
+ *
+ * Muestra lo bobinado hasta el corte; SW lo reanuda en la vuelta y la posición de
+ * traslado exactas, y girar el encoder lo descarta.
+ */
+void ofrecer_reanudar() {
+    punto_control_t p;
+    if (!leer_punto_control(&p)) return;
+
+    char msg[32];
+    if (p.unidad == TRABAJO_METROS) {
+        sprintf(msg, "Metros: %.2f", (float)p.pulsos / PULSOS_POR_METRO);
+    } else {
+        sprintf(msg, "Vueltas: %ld", (long)p.pulsos);
+    }
+    ssd1306_clear();
+    ssd1306_draw_string(0, 0, "Bobina a medias");
+    ssd1306_draw_string(0, 10, msg);
+    ssd1306_draw_string(0, 30, "SW: reanudar");
+    ssd1306_draw_string(0, 40, "Girar: descartar");
+    ssd1306_show();
+
+    while (1) {
+        watchdog_update(); // Mantiene vivo el watchdog mientras se espera al usuario
+        if (!gpio_get(ROT_SW)) { // Interruptor del encoder rotatorio presionado
+            sleep_ms(200); // Debounce
+            reanudar_trabajo(&p);
+            return;
+        }
+        if (!gpio_get(ROT_DT)) { // Encoder girado
+            sleep_ms(300);
+            punto_ram.magico = 0;
+            respaldo_cerrar();
+            return;
+        }
+        sleep_ms(20);
+    }
+}
+
+/**
+ * @brief Reanuda un bobinado desde un punto de control.
+ *
+ * @param p Punto de control.
+ */
+void reanudar_trabajo(const punto_control_t *p) {
+#if TRASLADO_BACKEND_STEPPER
+    stepper_fijar_origen(p->comando_mgrad); // El carro quedó donde estaba al cortarse
+#endif
+    trabajo_t t = {
+        .tipo = TRABAJO_BOBINADO,
+        .titulo = "Reanudando...",
+        .material = p->material,
+        .objetivo_pulsos = p->objetivo_pulsos,
+        .unidad = (trabajo_unidad_t)p->unidad,
+        .velocidad = p->velocidad,
+        .detenible = p->detenible,
+        .fin_titulo = "Bobinado completo!",
+        .pulsos_inicio = p->pulsos,
+        .posicion_inicio = p->posicion,
+    };
+    if (p->secuencia) {
+        t.segmentos = secuencia.segmentos;
+        t.n_segmentos = secuencia.n;
+    }
+    ejecutar_trabajo(&t);
+}
+
+// --- Persistencia ---
+/**
+ * @brief Carga del almacén de flash todo lo guardado en sesiones anteriores.
+ *
+ * Lo que no esté guardado (o tenga otro tamaño, de una versión anterior del firmware)
+ * conserva los valores de fábrica.
+ */
+void cargar_ajustes() {
+    almacen_iniciar();
+
+    calibracion_t c;
+    if (almacen_leer(CLAVE_CALIBRACION, &c, sizeof(c)) && c.pulsos_por_vuelta > 0 && c.diametro_tambor_cm > 0) {
+        calibracion = c;
+    }
+    almacen_leer(CLAVE_RECETA, &receta, sizeof(receta));
+    almacen_leer(CLAVE_CONTADORES, &contadores, sizeof(contadores));
+
+    for (int m = 0; m < MATERIAL_NUM; m++) {
+        material_guardado_t *g = &guardado_material[m];
+        if (almacen_leer(CLAVE_MATERIAL + m, g, sizeof(*g))) {
+            material_guardar_pid_velocidad(m, &g->pid_velocidad, g->rpm_por_milesima_q8);
+            material_guardar_velocidad_techo(m, g->velocidad_techo);
+        }
+        persistencia_registrar(CLAVE_MATERIAL + m, g, sizeof(*g));
+    }
+
+    if (almacen_leer(CLAVE_BANDAS, &bandas_guardadas, sizeof(bandas_guardadas))) {
+        resonancia_restaurar(bandas_guardadas.bandas, bandas_guardadas.n);
+    }
+    secuencia_t sec;
+    if (almacen_leer(CLAVE_SECUENCIA, &sec, sizeof(sec)) && sec.n >= 1 && sec.n <= SECUENCIA_MAX_SEGMENTOS) {
+        secuencia = sec;
+    }
+    multifilar_t mf;
+    if (almacen_leer(CLAVE_MULTIFILAR, &mf, sizeof(mf)) && mf.hilos >= 1 && mf.hilos <= HILOS_MAX) {
+        multifilar = mf;
+    }
+
+    // A partir de aquí los cambios se marcan y se guardan en reposo (ver persistencia.h)
+    persistencia_iniciar(PERSISTENCIA_ESPERA_MS);
+    persistencia_registrar(CLAVE_CALIBRACION, &calibracion, sizeof(calibracion));
+    persistencia_registrar(CLAVE_RECETA, &receta, sizeof(receta));
+    persistencia_registrar(CLAVE_CONTADORES, &contadores, sizeof(contadores));
+    persistencia_registrar(CLAVE_BANDAS, &bandas_guardadas, sizeof(bandas_guardadas));
+    persistencia_registrar(CLAVE_SECUENCIA, &secuencia, sizeof(secuencia));
+    persistencia_registrar(CLAVE_MULTIFILAR, &multifilar, sizeof(multifilar));
+}
+
+/**
+ * @brief Marca para guardar lo aprendido de un material (ganancias y techo de velocidad).
+ *
+ * @param material Índice del material.
+ */
+void guardar_material(int material) {
+    if (material < 0 || material >= MATERIAL_NUM) return;
+    const material_perfil_t *perfil = material_perfil(material);
+    material_guardado_t *g = &guardado_material[material];
+    g->pid_velocidad = perfil->pid_velocidad;
+    g->rpm_por_milesima_q8 = perfil->rpm_por_milesima_q8;
+    g->velocidad_techo = perfil->velocidad_techo;
+    persistencia_marcar(CLAVE_MATERIAL + material);
+}
+
+/**
+ * @brief Guarda en flash los cambios pendientes si la máquina está en reposo.
+ *
+ * Se llama desde los bucles de espera del menú. Solo se escribe con el motor apagado y
+ * el tambor quieto: con el XIP detenido no se atienden el encoder ni las protecciones.
+ */
+void atender_persistencia() {
+    bool reposo = !motor_encendido()
+        && time_us_32() - ultimo_pulso_us > PERSISTENCIA_REPOSO_MS * 1000;
+    persistencia_sondear(reposo);
+}
 
 // --- Funciones de Visualización de Menú ---
 /**
  * @brief Muestra el menú principal en el OLED.
  *
  * Resalta la opción actualmente seleccionada (`menu_state`).
- * Las opciones son "Hilo" y "Cobre".
+ * Las opciones son "Hilo", "Cobre" y "Calibrar".
  */
 void mostrar_menu() {
     ssd1306_clear();
     ssd1306_draw_string(0, 0, "Menu:");
     ssd1306_draw_string(0, 10, menu_state == 0 ? "> Hilo" : "  Hilo");
     ssd1306_draw_string(0, 20, menu_state == 1 ? "> Cobre" : "  Cobre");
+    ssd1306_draw_string(0, 30, menu_state == 2 ? "> Calibrar" : "  Calibrar");
+    ssd1306_draw_string(0, 40, menu_state == 3 ? "> Secuencia" : "  Secuencia");
     ssd1306_show();
 }
 
@@ -606,17 +2495,231 @@ void mostrar_menu() {
  * @brief Muestra el submenú basándose en el `menu_state` actual.
  *
  * Resalta la opción actualmente seleccionada (`sub_state`).
- * Las opciones son "Manual", "Auto" y "Volver".
+ * Las opciones son "Manual", "Auto", "Autoajuste" y "Volver"; en Calibrar, "Resonancia",
+ * "Ver bandas", "Tambor" y "Volver".
  */
 void mostrar_submenu() {
     ssd1306_clear();
+    if (menu_state == 3) {
+        ssd1306_draw_string(0, 0, "Secuencia:");
+        ssd1306_draw_string(0, 10, sub_state == 0 ? "> Editar" : "  Editar");
+        ssd1306_draw_string(0, 20, sub_state == 1 ? "> Bobinar" : "  Bobinar");
+        ssd1306_draw_string(0, 30, sub_state == 2 ? "> Volver" : "  Volver");
+        ssd1306_show();
+        return;
+    }
+    if (menu_state == 2) {
+        ssd1306_draw_string(0, 0, "Calibrar:");
+        ssd1306_draw_string(0, 10, sub_state == 0 ? "> Resonancia" : "  Resonancia");
+        ssd1306_draw_string(0, 20, sub_state == 1 ? "> Ver bandas" : "  Ver bandas");
+        ssd1306_draw_string(0, 30, sub_state == 2 ? "> Tambor" : "  Tambor");
+        ssd1306_draw_string(0, 40, sub_state == 3 ? "> Multifilar" : "  Multifilar");
+        ssd1306_draw_string(0, 50, sub_state == 4 ? "> Volver" : "  Volver");
+        ssd1306_show();
+        return;
+    }
     ssd1306_draw_string(0, 0, menu_state == 0 ? "Hilo:" : "Cobre:"); // El título cambia según la selección del menú principal
     ssd1306_draw_string(0, 10, sub_state == 0 ? "> Manual" : "  Manual");
     ssd1306_draw_string(0, 20, sub_state == 1 ? "> Auto" : "  Auto");
-    ssd1306_draw_string(0, 30, sub_state == 2 ? "> Volver" : "  Volver");
+    ssd1306_draw_string(0, 30, sub_state == 2 ? "> Lote" : "  Lote");
+    ssd1306_draw_string(0, 40, sub_state == 3 ? "> Autoajuste" : "  Autoajuste");
+    ssd1306_draw_string(0, 50, sub_state == 4 ? "> Volver" : "  Volver");
     ssd1306_show();
 }
 
+/**
+ * @brief Completa una muestra de la telemetría (interrupción del temporizador).
+ *
+ * Solo copia valores que ya mantienen el encoder, el tick de control y el traslado.
+ * @param m Muestra a completar.
+ */
+static void muestra_telemetria(telemetria_muestra_t *m) {
+    m->pulsos = pulsos_encoder;
+    m->traslado_mgrad = traslado.comando_mgrad;
+    m->rpm = (int16_t)rpm_filtrada;
+    m->tension_g = (int16_t)tension_actual();
+    m->pwm = motor_encendido() ? motor_velocidad() : 0;
+}
+
+// --- Mando remoto ---
+/**
+ * @brief Estado de la máquina tal como lo ve el PC.
+ */
+static remoto_maquina_t estado_remoto() {
+    if (trabajo_actual) return pausado ? REMOTO_PAUSADA : REMOTO_BOBINANDO;
+    if (en_relevo) return REMOTO_RELEVO;
+    return en_menu ? REMOTO_MENU : REMOTO_OCUPADA;
+}
+
+/**
+ * @brief Ejecuta una orden del PC y arma sus valores de respuesta.
+ *
+ * Las órdenes que actúan sobre el trabajo se convierten en pulsaciones de SW (ver
+ * `sw_leer()`); `REMOTO_INICIAR` deja el trabajo pedido al menú principal.
+ * @param c Orden recibida.
+ * @param valores Recibe los valores de la respuesta.
+ * @param n Recibe el número de valores.
+ * @return Resultado de la orden.
+ */
+static remoto_resultado_t ejecutar_orden(const remoto_comando_t *c, int32_t *valores, int *n) {
+    remoto_maquina_t maquina = estado_remoto();
+    *n = 0;
+    if (!c->valida) return REMOTO_ARGUMENTOS;
+    switch (c->orden) {
+    case REMOTO_ESTADO:
+        valores[0] = maquina;
+        valores[1] = material_activo;
+        valores[2] = falla_activa();
+        valores[3] = pulsos_encoder;
+        valores[4] = trabajo_actual ? trabajo_actual->objetivo_pulsos : 0;
+        valores[5] = lote.completas;
+        valores[6] = lote.receta.cantidad;
+        valores[7] = lote.fallidas;
+        *n = 8;
+        return REMOTO_OK;
+
+    case REMOTO_RECETA: {
+        if (c->n != 4 || (c->args[0] != MATERIAL_HILO && c->args[0] != MATERIAL_COBRE)) return REMOTO_ARGUMENTOS;
+        bool hilo = c->args[0] == MATERIAL_HILO;
+        int32_t valor = c->args[1];
+        if (hilo ? (valor < 1 || valor > 999) : (valor < 10 || valor > 2000)) return REMOTO_ARGUMENTOS;
+        if (c->args[2] < 1 || c->args[2] > LOTE_MAX_BOBINAS) return REMOTO_ARGUMENTOS;
+        if (c->args[3] < -LOTE_VARIACION_MAX || c->args[3] > LOTE_VARIACION_MAX) return REMOTO_ARGUMENTOS;
+        if (hilo) {
+            receta.metros = valor;
+        } else {
+            receta.milihenrios = valor;
+        }
+        receta.lote_cantidad = (uint16_t)c->args[2];
+        receta.lote_variacion = (int16_t)c->args[3];
+        persistencia_marcar(CLAVE_RECETA); // Se guarda en reposo, como desde los selectores
+        return REMOTO_OK;
+    }
+
+    case REMOTO_INICIAR:
+        if (c->n != 2 || (c->args[0] != MATERIAL_HILO && c->args[0] != MATERIAL_COBRE)
+                || c->args[1] < REMOTO_MODO_BOBINA || c->args[1] > REMOTO_MODO_SECUENCIA) return REMOTO_ARGUMENTOS;
+        if (maquina != REMOTO_MENU || inicio_remoto) return REMOTO_OCUPADO;
+        inicio_material = (uint8_t)c->args[0];
+        inicio_modo = (uint8_t)c->args[1];
+        inicio_remoto = true;
+        return REMOTO_OK;
+
+    case REMOTO_PAUSAR:
+        if (maquina != REMOTO_BOBINANDO || trabajo_actual->tipo != TRABAJO_BOBINADO) return REMOTO_NO_APLICA;
+        sw_remoto = SW_CORTA;
+        return REMOTO_OK;
+
+    case REMOTO_SEGUIR:
+        if (maquina != REMOTO_PAUSADA && maquina != REMOTO_RELEVO) return REMOTO_NO_APLICA;
+        sw_remoto = SW_CORTA;
+        return REMOTO_OK;
+
+    case REMOTO_ABORTAR:
+        if (maquina != REMOTO_BOBINANDO && maquina != REMOTO_PAUSADA && maquina != REMOTO_RELEVO) {
+            return REMOTO_NO_APLICA;
+        }
+        sw_remoto = SW_LARGA;
+        return REMOTO_OK;
+
+    case REMOTO_CONTADORES:
+        valores[0] = (int32_t)contadores.trabajos;
+        valores[1] = (int32_t)contadores.completos;
+        valores[2] = (int32_t)contadores.fallas;
+        valores[3] = (int32_t)contadores.pulsos;
+        valores[4] = (int32_t)telemetria_perdidas();
+        valores[5] = (int32_t)registro_perdidos();
+        *n = 6;
+        return REMOTO_OK;
+
+    case REMOTO_TRAZA:
+        if (c->n != 1) return REMOTO_ARGUMENTOS;
+        if (c->args[0] == REMOTO_TRAZA_VOLCAR) {
+            traza_congelar(); // Lo que se envía no cambia mientras sale
+            telemetria_volcar_traza();
+        } else if (c->args[0] == REMOTO_TRAZA_GRABAR) {
+            if (traza_reproduciendo()) return REMOTO_NO_APLICA;
+            traza_pedida = false;
+            grabar_traza();
+        } else if (c->args[0] == REMOTO_TRAZA_REPRODUCIR) {
+            if (maquina != REMOTO_MENU) return REMOTO_OCUPADO;
+            if (traza_cantidad() == 0) return REMOTO_NO_APLICA;
+            traza_congelar();
+            traza_pedida = true;
+        } else {
+            return REMOTO_ARGUMENTOS;
+        }
+        valores[0] = (int32_t)traza_cantidad();
+        valores[1] = traza_congelada();
+        valores[2] = traza_pedida || traza_reproduciendo();
+        valores[3] = traza_cabecera().tara;
+        valores[4] = traza_cabecera().pulsos_por_vuelta;
+        *n = 5;
+        return REMOTO_OK;
+
+    case REMOTO_CARGAR_TRAZA: {
+        if (c->n != 3 || c->args[0] < 0) return REMOTO_ARGUMENTOS;
+        if (maquina != REMOTO_MENU) return REMOTO_OCUPADO;
+        traza_evento_t e = { (uint32_t)c->args[1], (uint32_t)c->args[2] };
+        uint32_t estado = save_and_disable_interrupts(); // El encoder puede estar grabando
+        bool cargado = traza_cargar((uint32_t)c->args[0], &e);
+        restore_interrupts(estado);
+        if (!cargado) return REMOTO_ARGUMENTOS;
+        valores[0] = (int32_t)traza_cantidad();
+        *n = 1;
+        return REMOTO_OK;
+    }
+
+    default:
+        return REMOTO_DESCONOCIDA;
+    }
+}
+
+/**
+ * @brief Tarea del mando remoto: lee las órdenes del PC y las contesta. No bloquea.
+ *
+ * Se llama desde los mismos bucles que `telemetria_atender()`. Si el FIFO del CDC está
+ * lleno la respuesta se pierde: el PC reintenta la orden con la misma secuencia y recibe
+ * la respuesta guardada, sin volver a ejecutarla.
+ */
+void atender_remoto() {
+    uint8_t bytes[32];
+    uint32_t n;
+    while ((n = telemetria_leer(bytes, sizeof(bytes))) > 0) {
+        for (uint32_t i = 0; i < n; i++) {
+            remoto_comando_t c;
+            if (!remoto_recibir(&remoto, bytes[i], &c)) continue;
+            uint8_t datos[REMOTO_RESPUESTA_MAX];
+            size_t largo = c.repetida ? remoto_repetir(&remoto, datos) : 0;
+            if (largo == 0) { // Orden nueva (o reintento de una que no llegó a contestarse)
+                int32_t valores[REMOTO_VALORES_MAX];
+                int nvalores;
+                remoto_resultado_t resultado = ejecutar_orden(&c, valores, &nvalores);
+                largo = remoto_respuesta(&remoto, &c, resultado, valores, nvalores, datos);
+            }
+            telemetria_enviar(datos, largo);
+        }
+    }
+}
+
+/**
+ * @brief Arranca el trabajo pedido por el PC con la receta guardada, sin pasar por los menús.
+ */
+static void iniciar_remoto() {
+    inicio_remoto = false;
+    bool hilo = inicio_material == MATERIAL_HILO;
+    int valor = hilo ? receta.metros : receta.milihenrios;
+    if (inicio_modo == REMOTO_MODO_SECUENCIA) {
+        bobinar_secuencia();
+    } else if (inicio_modo == REMOTO_MODO_LOTE) {
+        ejecutar_lote(inicio_material, valor);
+    } else if (hilo) {
+        enrollar_hasta(valor);
+    } else {
+        enrollar_cobre_manual(valor);
+    }
+}
+
 // --- Programa Principal ---
 /**
  * @brief Punto de entrada principal del programa de la máquina bobinadora de hilo.
@@ -625,15 +2728,69 @@ void mostrar_submenu() {
  * y llama a las funciones de bobinado apropiadas basándose en las selecciones del usuario.
  */
 int main() {
-    stdio_init_all();      // Inicializa stdio (para depuración vía UART)
+    stdio_init_all();      // Inicializa stdio (depuración por UART; el USB queda para la telemetría)
     init_gpio();           // Inicializa todos los pines GPIO
+    motor_iniciar(MOTOR_EN, MOTOR_PWM_HZ); // PWM de velocidad del motor (apagado)
+    static const velocidad_config_t cfg_velocidad = {
+        .arranque = VELOCIDAD_ARRANQUE,
+        .rampa = VELOCIDAD_RAMPA,
+        .rampa_rapida = VELOCIDAD_RAMPA_RAPIDA,
+    };
+    velocidad_iniciar(&cfg_velocidad); // Rampas y bandas prohibidas de velocidad
+    fallas_iniciar();      // Gestor de fallas (antes que cualquier protección)
+    setup_analogico();     // Inicia el muestreo continuo del ADC por DMA
+    bool celda_tarada = setup_tension(); // Celda de carga y estimador de tensión
+    rotura_iniciar(pio0, SENSOR_ROTURA, ROTURA_FILTRO_US); // Sensor de rotura filtrado por PIO
     ssd1306_init(I2C_PORT, OLED_SDA, OLED_SCL); // Inicializa la pantalla OLED
+    cargar_ajustes();      // Calibración, recetas y lo aprendido, desde la flash
+    setup_hilos();         // Celdas de los hilos en paralelo (según la configuración guardada)
+    respaldo_iniciar();    // Punto de control de un bobinado interrumpido
+    telemetria_iniciar(TELEMETRIA_PERIODO_US, muestra_telemetria); // Tramas COBS por el USB
+    remoto_iniciar(&remoto); // Órdenes del PC por el mismo USB
+    grabar_traza();        // Graba los sensores desde el arranque
+#if ENROLLEX_BENCH
+    interpolador_benchmark(); // Compara interpoladores frente a C puro (salida por stdio)
+#endif
+#if TRASLADO_BACKEND_STEPPER
+    setup_stepper();       // Inicializa el traslado paso a paso
+#else
     setup_servo();         // Inicializa el PWM del servo
+#endif
+
+    if (watchdog_caused_reboot()) { // Informa de un reinicio por bloqueo del programa
+        falla_reportar(FALLA_WATCHDOG, time_us_32());
+        ssd1306_clear();
+        ssd1306_draw_string(0, 0, falla_nombre(FALLA_WATCHDOG));
+        ssd1306_show();
+        sleep_ms(2000);
+    }
+    if (!celda_tarada) { // El OLED se inicia después de la celda: se avisa aquí
+        ssd1306_clear();
+        ssd1306_draw_string(0, 0, "Celda sin tara");
+        ssd1306_draw_string(0, 10, "Revise el HX711");
+        ssd1306_show();
+        sleep_ms(2000);
+    }
+    watchdog_enable(WATCHDOG_MS, true); // Reinicia el equipo si el programa se bloquea
 
     while (true) {
+        ofrecer_reanudar(); // Bobinado interrumpido por un apagón, un reinicio o una caída de tensión
+
         // Navegación del Menú Principal
         mostrar_menu();
+        en_menu = true;
         while (1) {
+            watchdog_update(); // Mantiene vivo el watchdog mientras se espera al usuario
+            atender_persistencia(); // Guarda los cambios pendientes en reposo
+            telemetria_atender();
+            atender_remoto();
+            if (inicio_remoto) { // Trabajo pedido por el PC
+                en_menu = false;
+                iniciar_remoto();
+                en_menu = true;
+                mostrar_menu();
+                continue;
+            }
             if (!gpio_get(ROT_SW)) { // Interruptor del encoder rotatorio presionado para seleccionar
                 sleep_ms(200); // Debounce
                 break; // Sale del bucle de selección del menú principal
@@ -643,20 +2800,26 @@ int main() {
             // En un encoder rotatorio real, ROT_CLK y ROT_DT se leen juntos para determinar la dirección.
             // Esta implementación asume que ROT_DT en bajo indica una selección "siguiente".
             if (!gpio_get(ROT_DT)) { // Simula rotación para la navegación del menú
-                menu_state = (menu_state + 1) % 2; // Cicla entre 0 y 1 (Hilo, Cobre)
+                menu_state = (menu_state + 1) % 4; // Cicla entre Hilo, Cobre, Calibrar y Secuencia
                 mostrar_menu();
                 sleep_ms(300); // Retraso para que el usuario vea el cambio y evite el ciclaje rápido
             }
         }
+        en_menu = false;
 
-        // Navegación del Submenú (Manual, Auto, Volver)
+        // Navegación del Submenú (Manual, Auto, Lote, Autoajuste, Volver)
         sub_state = 0; // Reinicia el estado del submenú al entrar
+        int opciones = menu_state == 3 ? 3 : 5; // Secuencia: Editar, Bobinar, Volver
         mostrar_submenu();
         while (1) {
+            watchdog_update(); // Mantiene vivo el watchdog mientras se espera al usuario
+            atender_persistencia(); // Guarda los cambios pendientes en reposo
+            telemetria_atender();
+            atender_remoto(); // Contesta al PC; los trabajos solo se aceptan en el menú principal
             if (!gpio_get(ROT_SW)) { // Interruptor del encoder rotatorio presionado para seleccionar
                 sleep_ms(200); // Debounce
 
-                if (sub_state == 2) {
+                if (sub_state == opciones - 1) {
                     // "Volver" seleccionado, regresa al menú principal
                     break;
                 } else if (menu_state == 0 && sub_state == 0) {
@@ -677,12 +2840,44 @@ int main() {
                     // COBRE -> AUTO seleccionado
                     enrollar_cobre_auto();
                     break; // Sale del submenú después de la tarea
+                } else if (menu_state < 2 && sub_state == 2) {
+                    // HILO/COBRE -> LOTE seleccionado
+                    enrollar_lote(menu_state);
+                    break; // Sale del submenú después de la tarea
+                } else if (menu_state < 2 && sub_state == 3) {
+                    // HILO/COBRE -> AUTOAJUSTE seleccionado
+                    autoajustar_velocidad(menu_state);
+                    break; // Sale del submenú después de la tarea
+                } else if (menu_state == 2 && sub_state == 0) {
+                    // CALIBRAR -> RESONANCIA seleccionado
+                    calibrar_resonancias();
+                    break; // Sale del submenú después de la tarea
+                } else if (menu_state == 2 && sub_state == 1) {
+                    // CALIBRAR -> VER BANDAS seleccionado
+                    mostrar_bandas();
+                    break; // Sale del submenú después de la tarea
+                } else if (menu_state == 2 && sub_state == 2) {
+                    // CALIBRAR -> TAMBOR seleccionado
+                    calibrar_tambor();
+                    break; // Sale del submenú después de la tarea
+                } else if (menu_state == 2 && sub_state == 3) {
+                    // CALIBRAR -> MULTIFILAR seleccionado
+                    configurar_multifilar();
+                    break; // Sale del submenú después de la tarea
+                } else if (menu_state == 3 && sub_state == 0) {
+                    // SECUENCIA -> EDITAR seleccionado
+                    editar_secuencia();
+                    break; // Sale del submenú después de la tarea
+                } else if (menu_state == 3 && sub_state == 1) {
+                    // SECUENCIA -> BOBINAR seleccionado
+                    bobinar_secuencia();
+                    break; // Sale del submenú después de la tarea
                 }
             }
 
             // El DT del encoder rotatorio cambia de estado al girar
             if (!gpio_get(ROT_DT)) { // Simula rotación para la navegación del submenú
-                sub_state = (sub_state + 1) % 3; // Cicla entre 0, 1, 2 (Manual, Auto, Volver)
+                sub_state = (sub_state + 1) % opciones; // Cicla entre las opciones del submenú
                 mostrar_submenu();
                 sleep_ms(300); // Retraso
             }
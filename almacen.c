@@ -0,0 +1,224 @@
+/**
+ * @file almacen.c
+ * @brief Implementación del almacén de registros en flash.
+ *
+ * Una página por registro: la unidad de programación de la flash (256 bytes) es también
+ * la unidad de atomicidad, y una página nunca se programa dos veces sin borrar su sector.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "almacen.h"
+#include <stddef.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+
+#define ALMACEN_MAGICO 0x584E5245u ///< "ERNX": página escrita por este almacén.
+#define PAGINAS_POR_SECTOR ((int)(FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE))
+#define ALMACEN_PAGINAS (ALMACEN_SECTORES * PAGINAS_POR_SECTOR)
+#define ALMACEN_OFFSET (PICO_FLASH_SIZE_BYTES - ALMACEN_SECTORES * FLASH_SECTOR_SIZE)
+
+/**
+ * @brief Formato de una página.
+ */
+typedef struct {
+    uint32_t magico;                   ///< `ALMACEN_MAGICO`.
+    uint32_t secuencia;                ///< Orden de escritura (creciente).
+    uint16_t clave;                    ///< Clave del registro.
+    uint16_t longitud;                 ///< Bytes válidos de `datos`.
+    uint8_t datos[ALMACEN_DATOS_MAX];  ///< Datos.
+    uint32_t crc;                      ///< CRC-32 de la cabecera y los `longitud` bytes de datos.
+} registro_t;
+
+_Static_assert(sizeof(registro_t) == FLASH_PAGE_SIZE, "un registro ocupa una página");
+_Static_assert(ALMACEN_CLAVES_MAX <= PAGINAS_POR_SECTOR, "los registros vigentes deben caber en un sector");
+
+static int16_t indice[ALMACEN_CLAVES_MAX]; ///< Página vigente de cada clave (-1 = sin registro).
+static int cabeza = 0;                     ///< Siguiente página a escribir.
+static uint32_t secuencia = 1;             ///< Secuencia del siguiente registro.
+static registro_t buffer;                  ///< Página en RAM para programar.
+static uint32_t bloqueo_max_us = 0;        ///< Operación de flash más larga medida.
+
+/**
+ * @brief Devuelve una página mapeada en memoria.
+ */
+static const registro_t *pagina(int n) {
+    return (const registro_t *)(XIP_BASE + ALMACEN_OFFSET + (uint32_t)n * FLASH_PAGE_SIZE);
+}
+
+uint32_t almacen_crc32(const void *datos, uint32_t n) {
+    const uint8_t *p = datos;
+    static const uint32_t tabla[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    uint32_t crc = 0xFFFFFFFFu;
+    while (n--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ tabla[crc & 0xF];
+        crc = (crc >> 4) ^ tabla[crc & 0xF];
+    }
+    return ~crc;
+}
+
+/**
+ * @brief CRC de un registro: cabecera y datos válidos.
+ */
+static uint32_t crc_registro(const registro_t *r) {
+    return almacen_crc32(r, offsetof(registro_t, datos) + r->longitud);
+}
+
+static bool valido(const registro_t *r) {
+    return r->magico == ALMACEN_MAGICO
+        && r->clave > 0 && r->clave < ALMACEN_CLAVES_MAX
+        && r->longitud <= ALMACEN_DATOS_MAX
+        && r->crc == crc_registro(r);
+}
+
+/**
+ * @brief Indica si una zona de flash está borrada (todo 0xFF).
+ */
+static bool en_blanco(int primera, int paginas) {
+    const uint32_t *p = (const uint32_t *)pagina(primera);
+    for (uint32_t i = 0; i < (uint32_t)paginas * FLASH_PAGE_SIZE / 4; i++) {
+        if (p[i] != 0xFFFFFFFFu) return false;
+    }
+    return true;
+}
+
+static void borrar_en_ram(void *param) {
+    flash_range_erase((uint32_t)(uintptr_t)param, FLASH_SECTOR_SIZE);
+}
+
+static void programar_en_ram(void *param) {
+    flash_range_program((uint32_t)(uintptr_t)param, (const uint8_t *)&buffer, FLASH_PAGE_SIZE);
+}
+
+/**
+ * @brief Ejecuta una operación de flash con el XIP detenido y mide cuánto bloqueó.
+ */
+static bool ejecutar(void (*operacion)(void *), uint32_t offset) {
+    uint32_t inicio = time_us_32();
+    int r = flash_safe_execute(operacion, (void *)(uintptr_t)offset, ALMACEN_PLAZO_MS);
+    uint32_t duracion = time_us_32() - inicio;
+    if (duracion > bloqueo_max_us) bloqueo_max_us = duracion;
+    return r == PICO_OK;
+}
+
+static bool borrar_sector(int sector) {
+    return ejecutar(borrar_en_ram, ALMACEN_OFFSET + (uint32_t)sector * FLASH_SECTOR_SIZE);
+}
+
+static bool programar_pagina(int n) {
+    return ejecutar(programar_en_ram, ALMACEN_OFFSET + (uint32_t)n * FLASH_PAGE_SIZE);
+}
+
+static bool escribir_pagina(uint16_t clave, const void *datos, uint16_t longitud);
+
+/**
+ * @brief Deja borrado el sector siguiente al de la cabeza.
+ *
+ * Copia antes a la cabeza los registros vigentes que queden en él. Se llama al entrar en un
+ * sector nuevo (que ya está borrado) y al arrancar, por si un apagón cortó la compactación:
+ * en ambos casos el sector de la cabeza solo contiene copias, así que hay sitio.
+ */
+static void liberar_siguiente(void) {
+    int sector = (cabeza / PAGINAS_POR_SECTOR + 1) % ALMACEN_SECTORES;
+    int primera = sector * PAGINAS_POR_SECTOR;
+    if (en_blanco(primera, PAGINAS_POR_SECTOR)) return;
+
+    for (int clave = 1; clave < ALMACEN_CLAVES_MAX; clave++) {
+        int n = indice[clave];
+        if (n >= primera && n < primera + PAGINAS_POR_SECTOR) {
+            const registro_t *r = pagina(n);
+            if (!escribir_pagina(r->clave, r->datos, r->longitud)) return; // Sin copia no se borra
+        }
+    }
+    borrar_sector(sector);
+}
+
+/**
+ * @brief Escribe un registro en la siguiente página libre y actualiza el índice.
+ */
+static bool escribir_pagina(uint16_t clave, const void *datos, uint16_t longitud) {
+    // Una página cortada por un apagón no está en blanco: se salta
+    while (!en_blanco(cabeza, 1)) {
+        cabeza = (cabeza + 1) % ALMACEN_PAGINAS;
+        if (cabeza % PAGINAS_POR_SECTOR == 0) liberar_siguiente();
+    }
+
+    memset(&buffer, 0xFF, sizeof(buffer));
+    buffer.magico = ALMACEN_MAGICO;
+    buffer.secuencia = secuencia++;
+    buffer.clave = clave;
+    buffer.longitud = longitud;
+    memcpy(buffer.datos, datos, longitud);
+    buffer.crc = crc_registro(&buffer);
+    if (!programar_pagina(cabeza)) {
+        return false; // El otro núcleo no se pudo retener: la página sigue en blanco
+    }
+
+    int escrita = cabeza;
+    cabeza = (cabeza + 1) % ALMACEN_PAGINAS;
+    if (!valido(pagina(escrita)) || pagina(escrita)->secuencia != buffer.secuencia) {
+        return false; // La versión anterior sigue vigente
+    }
+    indice[clave] = (int16_t)escrita;
+    if (cabeza % PAGINAS_POR_SECTOR == 0) liberar_siguiente();
+    return true;
+}
+
+int almacen_iniciar(void) {
+    for (int i = 0; i < ALMACEN_CLAVES_MAX; i++) indice[i] = -1;
+    uint32_t max_secuencia = 0;
+    int ultima = -1;
+
+    for (int n = 0; n < ALMACEN_PAGINAS; n++) {
+        const registro_t *r = pagina(n);
+        if (r->magico != ALMACEN_MAGICO || !valido(r)) continue;
+        int actual = indice[r->clave];
+        if (actual < 0 || r->secuencia > pagina(actual)->secuencia) {
+            indice[r->clave] = (int16_t)n;
+        }
+        if (r->secuencia > max_secuencia) {
+            max_secuencia = r->secuencia;
+            ultima = n;
+        }
+    }
+
+    secuencia = max_secuencia + 1;
+    cabeza = (ultima + 1) % ALMACEN_PAGINAS;
+    liberar_siguiente(); // Por si un apagón interrumpió una compactación
+
+    int claves = 0;
+    for (int i = 1; i < ALMACEN_CLAVES_MAX; i++) {
+        if (indice[i] >= 0) claves++;
+    }
+    return claves;
+}
+
+bool almacen_leer(uint16_t clave, void *datos, uint16_t longitud) {
+    if (clave == 0 || clave >= ALMACEN_CLAVES_MAX || indice[clave] < 0) return false;
+    const registro_t *r = pagina(indice[clave]);
+    if (r->longitud != longitud) return false;
+    memcpy(datos, r->datos, longitud);
+    return true;
+}
+
+uint32_t almacen_bloqueo_max_us(void) {
+    return bloqueo_max_us;
+}
+
+bool almacen_escribir(uint16_t clave, const void *datos, uint16_t longitud) {
+    if (clave == 0 || clave >= ALMACEN_CLAVES_MAX || longitud > ALMACEN_DATOS_MAX) return false;
+    if (indice[clave] >= 0) {
+        const registro_t *r = pagina(indice[clave]);
+        if (r->longitud == longitud && memcmp(r->datos, datos, longitud) == 0) {
+            return true; // Sin cambios: no se gasta una página
+        }
+    }
+    return escribir_pagina(clave, datos, longitud);
+}
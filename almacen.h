@@ -0,0 +1,79 @@
+/**
+ * @file almacen.h
+ * @brief Almacén de registros clave/valor en flash con nivelación de desgaste y CRC.
+ *
+ * Ocupa los últimos `ALMACEN_SECTORES` sectores de la flash como un registro circular:
+ * cada escritura añade una página de 256 bytes (cabecera, datos y CRC-32) con un número de
+ * secuencia creciente, y la versión vigente de una clave es la página válida de mayor
+ * secuencia. Así el desgaste se reparte por todo el área y nunca se sobrescribe un dato.
+ *
+ * La escritura es atómica: una página cortada por un apagón no pasa el CRC y se conserva
+ * la versión anterior. Siempre hay un sector borrado por delante de la cabeza; al entrar en
+ * un sector nuevo se copian a él los registros vigentes del sector más antiguo y éste se
+ * borra. Por eso caben como mucho `ALMACEN_CLAVES_MAX - 1` claves (menos que páginas por
+ * sector).
+ *
+ * La carga al arrancar recorre las páginas mapeadas en memoria (XIP) sin copiarlas: con
+ * 64 páginas tarda menos de un milisegundo.
+ *
+ * Borrar o programar la flash detiene el XIP: cada operación se hace con
+ * `flash_safe_execute()`, que desactiva las interrupciones de este núcleo y, si el otro
+ * núcleo está en marcha (y llamó a `flash_safe_execute_core_init()`), lo retiene
+ * ejecutando desde RAM mientras dura. Un borrado de sector bloquea hasta ~50 ms: no se
+ * debe escribir durante un bobinado (ver persistencia.h).
+ */
+
+#ifndef ALMACEN_H
+#define ALMACEN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ALMACEN_SECTORES 4       ///< Sectores de 4 KB al final de la flash.
+#define ALMACEN_CLAVES_MAX 16    ///< Claves posibles: 1 .. ALMACEN_CLAVES_MAX - 1.
+#define ALMACEN_DATOS_MAX 240    ///< Bytes de datos por registro.
+#define ALMACEN_PLAZO_MS 100     ///< Espera máxima para retener el otro núcleo antes de escribir.
+
+/**
+ * @brief Carga el índice de registros y recupera una compactación interrumpida.
+ *
+ * @return Número de claves con un registro válido.
+ */
+int almacen_iniciar(void);
+
+/**
+ * @brief Lee el registro vigente de una clave.
+ *
+ * Solo se copia si la longitud guardada coincide con la pedida: un registro de una
+ * versión anterior del firmware con otro tamaño se ignora y se usan los valores por defecto.
+ * @param clave Clave (1 .. `ALMACEN_CLAVES_MAX` - 1).
+ * @param datos Destino.
+ * @param longitud Tamaño esperado.
+ * @return `true` si se copió un registro válido.
+ */
+bool almacen_leer(uint16_t clave, void *datos, uint16_t longitud);
+
+/**
+ * @brief Escribe una nueva versión de una clave.
+ *
+ * Si los datos coinciden con la versión vigente no se escribe nada.
+ * @param clave Clave (1 .. `ALMACEN_CLAVES_MAX` - 1).
+ * @param datos Datos a guardar.
+ * @param longitud Tamaño (hasta `ALMACEN_DATOS_MAX`).
+ * @return `false` si la clave o la longitud no son válidas o la página no se verificó.
+ */
+bool almacen_escribir(uint16_t clave, const void *datos, uint16_t longitud);
+
+/**
+ * @brief CRC-32 (polinomio reflejado 0xEDB88320) con tabla de 16 entradas.
+ *
+ * Es el CRC de los registros; lo reutilizan otros datos que se guardan fuera del almacén.
+ */
+uint32_t almacen_crc32(const void *datos, uint32_t n);
+
+/**
+ * @brief Mayor duración medida de una operación de flash (interrupciones bloqueadas), en µs.
+ */
+uint32_t almacen_bloqueo_max_us(void);
+
+#endif // ALMACEN_H
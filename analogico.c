@@ -0,0 +1,160 @@
+/**
+ * @file analogico.c
+ * @brief Implementación de la adquisición analógica con DMA y filtros CIC/promedio móvil.
+ *
+ * Dos canales DMA se encadenan entre sí y escriben alternadamente en dos bloques, de modo
+ * que el ADC nunca se detiene. Al completarse un bloque su canal se rearma (dirección y
+ * conteo) mientras el otro sigue escribiendo, y el bloque se filtra en la misma interrupción.
+ *
+ * El CIC se implementa con aritmética modular de 32 bits: los desbordes de los integradores
+ * se cancelan en los peines siempre que la ganancia R^N quepa en el registro.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "analogico.h"
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#define ANALOG_PIN_BASE 26       ///< GPIO del canal ADC0.
+#define ANALOG_BLOQUE 48         ///< Muestras por bloque DMA (múltiplo del número de canales).
+#define ANALOG_MAX_ORDEN 3       ///< Orden máximo del CIC.
+#define ANALOG_MAX_PROMEDIO 16   ///< Largo máximo del promedio móvil.
+#define ADC_CLK_HZ 48000000.0f   ///< Reloj del ADC.
+
+/**
+ * @brief Estado del filtro de un canal.
+ */
+typedef struct {
+    uint8_t orden;                          ///< Orden N del CIC.
+    uint32_t decimacion;                    ///< Decimación R.
+    int8_t desp;                            ///< Desplazamiento para normalizar la ganancia a 16 bits.
+    uint8_t largo_promedio;                 ///< Largo M del promedio móvil.
+    uint32_t integ[ANALOG_MAX_ORDEN];       ///< Integradores del CIC.
+    uint32_t peine[ANALOG_MAX_ORDEN];       ///< Valores anteriores de los peines.
+    uint32_t cuenta;                        ///< Muestras desde la última salida decimada.
+    uint16_t historial[ANALOG_MAX_PROMEDIO]; ///< Salidas decimadas del promedio móvil.
+    uint32_t suma;                          ///< Suma del historial.
+    uint8_t idx;                            ///< Posición del historial a reemplazar.
+} filtro_t;
+
+volatile uint16_t analog_valores[ANALOG_NUM_CANALES];
+
+static uint16_t bloques[2][ANALOG_BLOQUE]; ///< Bloques de muestras del ping-pong DMA.
+static uint dma_canal[2];                  ///< Canales DMA del ping-pong.
+static filtro_t filtros_est[ANALOG_NUM_CANALES]; ///< Estado de los filtros por canal.
+static analog_callback_t callbacks[ANALOG_NUM_CANALES]; ///< Funciones a llamar con cada valor nuevo.
+static uint32_t periodo_muestra_us;              ///< Tiempo entre muestras de un mismo canal.
+
+/**
+ * @brief Pasa una muestra por el filtro de su canal.
+ */
+static void analog_filtrar(filtro_t *f, analog_canal_t canal, uint32_t x) {
+    // Integradores: una suma por etapa y por muestra
+    for (uint8_t i = 0; i < f->orden; i++) {
+        x += f->integ[i];
+        f->integ[i] = x;
+    }
+    if (++f->cuenta < f->decimacion) return;
+    f->cuenta = 0;
+
+    // Peines a la frecuencia decimada
+    for (uint8_t i = 0; i < f->orden; i++) {
+        uint32_t anterior = f->peine[i];
+        f->peine[i] = x;
+        x -= anterior;
+    }
+    uint16_t y = (uint16_t)(f->desp >= 0 ? x >> f->desp : x << -f->desp);
+
+    // Promedio móvil sobre las salidas decimadas
+    f->suma += y - f->historial[f->idx];
+    f->historial[f->idx] = y;
+    f->idx = (f->idx + 1) & (f->largo_promedio - 1);
+    uint16_t valor = (uint16_t)(f->suma / f->largo_promedio);
+    analog_valores[canal] = valor;
+    if (callbacks[canal]) callbacks[canal](valor);
+}
+
+/**
+ * @brief ISR del DMA: rearma el canal que terminó y filtra su bloque.
+ */
+static void analog_dma_irq(void) {
+    for (int b = 0; b < 2; b++) {
+        uint ch = dma_canal[b];
+        if (!dma_channel_get_irq0_status(ch)) continue;
+        dma_channel_acknowledge_irq0(ch);
+        // Se rearma sin disparar: lo disparará el otro canal al terminar
+        dma_channel_set_write_addr(ch, bloques[b], false);
+        dma_channel_set_trans_count(ch, ANALOG_BLOQUE, false);
+
+        const uint16_t *m = bloques[b];
+        for (int i = 0; i < ANALOG_BLOQUE; i += ANALOG_NUM_CANALES) {
+            for (int c = 0; c < ANALOG_NUM_CANALES; c++) {
+                analog_filtrar(&filtros_est[c], (analog_canal_t)c, m[i + c] & 0x0FFF);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Configura un canal del ping-pong encadenado al otro.
+ */
+static void analog_configurar_dma(int b, bool iniciar) {
+    dma_channel_config c = dma_channel_get_default_config(dma_canal[b]);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);  // Siempre la FIFO del ADC
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, DREQ_ADC);
+    channel_config_set_chain_to(&c, dma_canal[1 - b]);
+    dma_channel_configure(dma_canal[b], &c, bloques[b], &adc_hw->fifo, ANALOG_BLOQUE, iniciar);
+    dma_channel_set_irq0_enabled(dma_canal[b], true);
+}
+
+void analog_set_callback(analog_canal_t canal, analog_callback_t callback) {
+    callbacks[canal] = callback;
+}
+
+uint32_t analog_periodo_us(analog_canal_t canal) {
+    return periodo_muestra_us * filtros_est[canal].decimacion;
+}
+
+void analog_iniciar(uint32_t muestras_por_s, const analog_filtro_t filtros[ANALOG_NUM_CANALES]) {
+    periodo_muestra_us = (1000000u * ANALOG_NUM_CANALES) / muestras_por_s;
+    for (int c = 0; c < ANALOG_NUM_CANALES; c++) {
+        filtro_t *f = &filtros_est[c];
+        f->orden = filtros[c].orden_cic;
+        if (f->orden < 1) f->orden = 1;
+        if (f->orden > ANALOG_MAX_ORDEN) f->orden = ANALOG_MAX_ORDEN;
+        uint8_t log2_r = filtros[c].log2_decimacion;
+        if (f->orden * log2_r > 20) log2_r = 20 / f->orden;
+        f->decimacion = 1u << log2_r;
+        // Ganancia del CIC = 2^(N·log2 R); la muestra es de 12 bits y la salida de 16
+        f->desp = (int8_t)(f->orden * log2_r - 4);
+        uint8_t log2_m = filtros[c].log2_promedio > 4 ? 4 : filtros[c].log2_promedio;
+        f->largo_promedio = (uint8_t)(1u << log2_m);
+        analog_valores[c] = 0;
+        adc_gpio_init(ANALOG_PIN_BASE + c);
+    }
+
+    adc_init();
+    adc_select_input(0);
+    adc_set_round_robin((1u << ANALOG_NUM_CANALES) - 1);
+    adc_fifo_setup(true,   // Escribe cada conversión en la FIFO
+                   true,   // Habilita la DREQ para el DMA
+                   1,      // DREQ con una muestra disponible
+                   false,  // Sin bit de error en la muestra
+                   false); // Muestras de 16 bits
+    adc_set_clkdiv(ADC_CLK_HZ / muestras_por_s - 1.0f);
+
+    dma_canal[0] = (uint)dma_claim_unused_channel(true);
+    dma_canal[1] = (uint)dma_claim_unused_channel(true);
+    analog_configurar_dma(1, false);
+    analog_configurar_dma(0, true);
+    irq_add_shared_handler(DMA_IRQ_0, analog_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    adc_run(true);
+}
@@ -0,0 +1,87 @@
+/**
+ * @file analogico.h
+ * @brief Adquisición analógica continua por ADC en modo round-robin con DMA.
+ *
+ * El ADC convierte de forma libre los canales del potenciómetro de tensión, la corriente
+ * del motor y la tensión de alimentación, y dos canales DMA encadenados (ping-pong) vuelcan
+ * las muestras en bloques. No hay interrupción por muestra: al completarse cada bloque una
+ * única interrupción aplica por canal un decimador CIC (sobremuestreo) y un promedio móvil,
+ * y deja el último valor filtrado listo para leerse en O(1) con `analog_leer()`.
+ */
+
+#ifndef ANALOGICO_H
+#define ANALOGICO_H
+
+#include <stdint.h>
+
+/**
+ * @brief Canales analógicos en el orden del round-robin (ADC0, ADC1, ADC2).
+ */
+typedef enum {
+    ANALOG_TENSION = 0,   ///< Potenciómetro de tensión del hilo (GPIO 26).
+    ANALOG_CORRIENTE = 1, ///< Sensor de corriente del motor (GPIO 27).
+    ANALOG_VOLTAJE = 2,   ///< Divisor de la alimentación de 12 V (GPIO 28).
+    ANALOG_NUM_CANALES
+} analog_canal_t;
+
+/**
+ * @brief Filtro de un canal: CIC de orden N con decimación R, seguido de un promedio móvil de M salidas.
+ *
+ * La ganancia del CIC (R^N) debe caber en 20 bits: `orden_cic * log2_decimacion <= 20`.
+ */
+typedef struct {
+    uint8_t orden_cic;        ///< Orden N del CIC (1 = promedio por bloques, hasta 3).
+    uint8_t log2_decimacion;  ///< log2 de la decimación R (muestras del canal por salida).
+    uint8_t log2_promedio;    ///< log2 del largo M del promedio móvil (0 = sin promedio, hasta 4).
+} analog_filtro_t;
+
+/**
+ * @brief Función llamada con cada nuevo valor filtrado de un canal.
+ *
+ * Se ejecuta dentro de la interrupción del DMA: debe ser breve.
+ */
+typedef void (*analog_callback_t)(uint16_t valor);
+
+/**
+ * @brief Inicia la conversión continua y el DMA.
+ *
+ * @param muestras_por_s Frecuencia total de muestreo del ADC (se reparte entre los canales).
+ * @param filtros Filtro de cada canal, en el orden de `analog_canal_t`.
+ */
+void analog_iniciar(uint32_t muestras_por_s, const analog_filtro_t filtros[ANALOG_NUM_CANALES]);
+
+/**
+ * @brief Registra una función a llamar con cada nuevo valor filtrado del canal.
+ *
+ * Permite reaccionar a un valor en cuanto se produce (protecciones) sin sondear.
+ * @param canal Canal a vigilar.
+ * @param callback Función a llamar, o `NULL` para quitarla.
+ */
+void analog_set_callback(analog_canal_t canal, analog_callback_t callback);
+
+/**
+ * @brief Devuelve el periodo entre valores filtrados de un canal, en microsegundos.
+ */
+uint32_t analog_periodo_us(analog_canal_t canal);
+
+/// Últimos valores filtrados, escalados a 16 bits (0-65535 = 0-3.3 V).
+extern volatile uint16_t analog_valores[ANALOG_NUM_CANALES];
+
+/**
+ * @brief Devuelve el último valor filtrado de un canal.
+ *
+ * @param canal Canal a leer.
+ * @return Valor en 16 bits (0-65535 corresponde a 0-3.3 V).
+ */
+static inline uint16_t analog_leer(analog_canal_t canal) {
+    return analog_valores[canal];
+}
+
+/**
+ * @brief Convierte un valor de 16 bits a milivoltios en el pin del ADC.
+ */
+static inline uint32_t analog_a_mv(uint16_t valor) {
+    return ((uint32_t)valor * 3300u) >> 16;
+}
+
+#endif // ANALOGICO_H
@@ -0,0 +1,95 @@
+/**
+ * @file anomalia.c
+ * @brief Implementación del detector EWMA + CUSUM.
+ *
+ * La desviación típica se estima como 1.25 veces la desviación absoluta media (exacto para
+ * ruido normal), lo que evita raíces cuadradas. La línea base solo se adapta mientras las
+ * sumas CUSUM están por debajo de la mitad de su umbral: así una deriva lenta no se
+ * aprende como normal antes de detectarse.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "anomalia.h"
+
+#define ANOMALIA_Z_MAX_Q8 (8 << 8) ///< Límite de |z| por muestra: un pico aislado no basta para alarmar.
+
+/**
+ * @brief Suma CUSUM de un paso: max(0, s + incremento).
+ */
+static int32_t cusum(int32_t s, int32_t incremento) {
+    s += incremento;
+    return s > 0 ? s : 0;
+}
+
+/**
+ * @brief Actualiza la línea base con peso 1/w.
+ */
+static void anomalia_base(anomalia_t *a, int32_t d, int32_t w) {
+    int32_t abs_d = d < 0 ? -d : d;
+    a->media_q8 += d / w;
+    a->desv_q8 += (abs_d - a->desv_q8) / w;
+}
+
+void anomalia_iniciar(anomalia_t *a, const anomalia_config_t *cfg) {
+    a->cfg = *cfg;
+    a->n = 0;
+    a->media_q8 = 0;
+    a->desv_q8 = 0;
+    a->s_sube = 0;
+    a->s_baja = 0;
+    a->s_varianza = 0;
+}
+
+anomalia_resultado_t anomalia_actualizar(anomalia_t *a, int32_t x) {
+    const anomalia_config_t *cfg = &a->cfg;
+    int32_t x_q8 = x * 256;
+    int32_t d = x_q8 - a->media_q8;
+    int32_t ventana = 1 << cfg->log2_base;
+
+    // Aprendizaje: promedio acumulado que pasa a exponencial al llenar la ventana
+    if (a->n == 0) {
+        a->media_q8 = x_q8;
+        a->n = 1;
+        return ANOMALIA_NINGUNA;
+    }
+    if (a->n < cfg->aprendizaje) {
+        a->n++;
+        anomalia_base(a, d, (int32_t)a->n < ventana ? (int32_t)a->n : ventana);
+        return ANOMALIA_NINGUNA;
+    }
+
+    // Muestra normalizada
+    int32_t sigma_q8 = a->desv_q8 + a->desv_q8 / 4;
+    if (sigma_q8 < cfg->desviacion_min * 256) sigma_q8 = cfg->desviacion_min * 256;
+    int32_t z = (int32_t)(((int64_t)d * 256) / sigma_q8);
+    if (z > ANOMALIA_Z_MAX_Q8) z = ANOMALIA_Z_MAX_Q8;
+    if (z < -ANOMALIA_Z_MAX_Q8) z = -ANOMALIA_Z_MAX_Q8;
+    int32_t z2 = (z * z) >> 8;
+
+    a->s_sube = cusum(a->s_sube, z - cfg->k_media_q8);
+    a->s_baja = cusum(a->s_baja, -z - cfg->k_media_q8);
+    a->s_varianza = cusum(a->s_varianza, z2 - 256 - cfg->k_varianza_q8);
+
+    anomalia_resultado_t r = ANOMALIA_NINGUNA;
+    if (a->s_varianza > cfg->h_varianza_q8) {
+        r = ANOMALIA_VARIANZA;
+    } else if (a->s_sube > cfg->h_media_q8) {
+        r = ANOMALIA_SUBE;
+    } else if (a->s_baja > cfg->h_media_q8) {
+        r = ANOMALIA_BAJA;
+    }
+    if (r != ANOMALIA_NINGUNA) {
+        a->s_sube = 0;
+        a->s_baja = 0;
+        a->s_varianza = 0;
+        return r;
+    }
+
+    if (a->s_sube < cfg->h_media_q8 / 2 && a->s_baja < cfg->h_media_q8 / 2
+            && a->s_varianza < cfg->h_varianza_q8 / 2) {
+        anomalia_base(a, d, ventana);
+    }
+    return ANOMALIA_NINGUNA;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file anomalia.h
+ * @brief Detector de anomalías en flujo (EWMA + CUSUM) para anticipar la rotura del hilo.
+ *
+ * El hilo suele degradarse antes de romperse: la varianza de la tensión sube y la velocidad
+ * del tambor se vuelve irregular. Cada señal vigilada tiene un detector que:
+ * - Aprende una línea base (media y desviación) con promedios exponenciales (EWMA).
+ * - Normaliza cada muestra contra esa línea base: z = (x - media) / desviación.
+ * - Acumula tres sumas CUSUM: deriva de la media hacia arriba, hacia abajo, y exceso de
+ *   varianza (z² - 1). Una suma que supera el umbral `h` es una alarma.
+ *
+ * Memoria y tiempo constantes por muestra, sin raíces cuadradas.
+ * La holgura `k` y el umbral `h` fijan la tasa de falsas alarmas (ARL): subir `h` alarga el
+ * plazo medio entre falsas alarmas a costa de detectar más tarde. La varianza doble da
+ * E[z²] = 2, así que su holgura debe ser menor que 1. Simulado con ruido normal, línea base
+ * de 2^9 muestras y 256 de aprendizaje (`tools/anomalia_simular.c`, 8 semillas): media
+ * k = 0.5, h = 12 y varianza k = 0.45, h = 40 dan más de 3·10^5 muestras entre falsas
+ * alarmas, detectan una deriva de 1 desviación en unas 26 muestras y una varianza doble en
+ * unas 90 (en 1 de cada 100 ensayos la línea base la absorbe antes y tarda mucho más).
+ *
+ * El módulo no depende del SDK: la simulación lo compila en el PC.
+ */
+
+#ifndef ANOMALIA_H
+#define ANOMALIA_H
+
+#include <stdint.h>
+
+/**
+ * @brief Resultado de una muestra.
+ */
+typedef enum {
+    ANOMALIA_NINGUNA = 0, ///< Sin alarma (o aún aprendiendo la línea base).
+    ANOMALIA_SUBE,        ///< La media derivó hacia arriba.
+    ANOMALIA_BAJA,        ///< La media derivó hacia abajo.
+    ANOMALIA_VARIANZA,    ///< La varianza creció (señal irregular).
+} anomalia_resultado_t;
+
+/**
+ * @brief Parámetros de un detector. Holguras y umbrales en desviaciones típicas, Q8.
+ */
+typedef struct {
+    uint8_t log2_base;        ///< La línea base promedia las últimas ~2^n muestras.
+    uint16_t aprendizaje;     ///< Muestras iniciales que solo aprenden la línea base.
+    int32_t desviacion_min;   ///< Desviación mínima de la señal en sus unidades (cuantización).
+    int32_t k_media_q8;       ///< Holgura del CUSUM de media.
+    int32_t h_media_q8;       ///< Umbral del CUSUM de media.
+    int32_t k_varianza_q8;    ///< Holgura del CUSUM de varianza.
+    int32_t h_varianza_q8;    ///< Umbral del CUSUM de varianza.
+} anomalia_config_t;
+
+/**
+ * @brief Estado de un detector.
+ */
+typedef struct {
+    anomalia_config_t cfg;    ///< Copia de la configuración.
+    uint32_t n;               ///< Muestras procesadas desde el último reinicio.
+    int32_t media_q8;         ///< Media de la línea base (Q8).
+    int32_t desv_q8;          ///< Desviación absoluta media de la línea base (Q8).
+    int32_t s_sube;           ///< CUSUM de media hacia arriba (Q8).
+    int32_t s_baja;           ///< CUSUM de media hacia abajo (Q8).
+    int32_t s_varianza;       ///< CUSUM de varianza (Q8).
+} anomalia_t;
+
+/**
+ * @brief Inicia (o reinicia) un detector; vuelve a aprender la línea base.
+ *
+ * Debe reiniciarse cuando cambia el punto de operación (por ejemplo, la velocidad).
+ * @param a Detector.
+ * @param cfg Configuración (se copia).
+ */
+void anomalia_iniciar(anomalia_t *a, const anomalia_config_t *cfg);
+
+/**
+ * @brief Procesa una muestra.
+ *
+ * Tras una alarma las sumas CUSUM vuelven a 0 y la línea base se conserva.
+ * @param a Detector.
+ * @param x Muestra en las unidades de la señal.
+ * @return Alarma detectada con esta muestra, o `ANOMALIA_NINGUNA`.
+ */
+anomalia_resultado_t anomalia_actualizar(anomalia_t *a, int32_t x);
+
+#endif // ANOMALIA_H
@@ -0,0 +1,40 @@
+/**
+ * @file aprendizaje.c
+ * @brief Implementación del aprendizaje de la velocidad máxima.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "aprendizaje.h"
+
+void aprendizaje_empezar(aprendizaje_t *a, uint16_t techo) {
+    a->techo = techo;
+    a->pico = INT32_MIN;
+    a->muestras = 0;
+    a->incidente = false;
+}
+
+void aprendizaje_observar(aprendizaje_t *a, uint16_t velocidad, int32_t tension) {
+    if (velocidad < a->techo) return;
+    if (tension > a->pico) a->pico = tension;
+    a->muestras++;
+}
+
+void aprendizaje_incidente(aprendizaje_t *a) {
+    a->incidente = true;
+}
+
+uint16_t aprendizaje_techo(const aprendizaje_config_t *cfg, const aprendizaje_t *a,
+                           int32_t tension_max, bool falla) {
+    int32_t techo = a->techo;
+    if (falla || a->incidente) {
+        techo -= cfg->paso_bajada;
+    } else if (a->muestras >= cfg->muestras_min
+               && (int64_t)(tension_max - a->pico) * 100 >= (int64_t)tension_max * cfg->margen_pct) {
+        techo += cfg->paso_subida;
+    }
+    if (techo < cfg->minimo) techo = cfg->minimo;
+    if (techo > cfg->maximo) techo = cfg->maximo;
+    return (uint16_t)techo;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file aprendizaje.h
+ * @brief Aprendizaje de la velocidad máxima de cada material a partir de la holgura de tensión.
+ *
+ * Cada perfil de material guarda un techo de velocidad. Durante un bobinado se registra el
+ * pico de tensión mientras el tambor gira en el techo; al terminar el trabajo:
+ * - si hubo un incidente (falla o anomalía del hilo), el techo baja `paso_bajada`;
+ * - si se bobinó el tiempo suficiente en el techo y el pico quedó al menos `margen_pct` por
+ *   debajo del límite de tensión del material, el techo sube `paso_subida`;
+ * - en otro caso no cambia.
+ *
+ * La bajada es mayor que la subida: tras un disparo el techo retrocede por debajo del
+ * último valor sin incidentes y vuelve a subir despacio, así cada material converge a su
+ * velocidad máxima real sin oscilar alrededor del punto de rotura.
+ */
+
+#ifndef APRENDIZAJE_H
+#define APRENDIZAJE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Parámetros del aprendizaje.
+ */
+typedef struct {
+    uint16_t minimo;       ///< Techo mínimo (milésimas del PWM).
+    uint16_t maximo;       ///< Techo máximo (milésimas del PWM).
+    uint16_t paso_subida;  ///< Subida del techo tras un trabajo con holgura.
+    uint16_t paso_bajada;  ///< Bajada del techo tras un incidente.
+    uint8_t margen_pct;    ///< Holgura mínima de tensión (% del límite) para subir.
+    uint32_t muestras_min; ///< Muestras en el techo necesarias para decidir una subida.
+} aprendizaje_config_t;
+
+/**
+ * @brief Observación de un trabajo.
+ */
+typedef struct {
+    uint16_t techo;     ///< Techo con el que empezó el trabajo.
+    int32_t pico;       ///< Tensión máxima medida en el techo.
+    uint32_t muestras;  ///< Muestras tomadas en el techo.
+    bool incidente;     ///< Hubo una anomalía durante el trabajo.
+} aprendizaje_t;
+
+/**
+ * @brief Empieza la observación de un trabajo.
+ *
+ * @param a Observación.
+ * @param techo Techo de velocidad del material al empezar, ya fuera de las bandas resonantes
+ *        (el planificador nunca alcanza una velocidad dentro de una banda).
+ */
+void aprendizaje_empezar(aprendizaje_t *a, uint16_t techo);
+
+/**
+ * @brief Registra una medida de tensión con el tambor en régimen.
+ *
+ * Solo cuentan las medidas con la velocidad objetivo en el techo: por debajo (rampas,
+ * ralentizado por anomalía) la holgura no dice nada del techo.
+ * @param a Observación.
+ * @param velocidad Velocidad objetivo actual.
+ * @param tension Tensión medida, en las unidades del límite del material.
+ */
+void aprendizaje_observar(aprendizaje_t *a, uint16_t velocidad, int32_t tension);
+
+/**
+ * @brief Marca un incidente (anomalía del hilo) en el trabajo en curso.
+ */
+void aprendizaje_incidente(aprendizaje_t *a);
+
+/**
+ * @brief Calcula el techo para los siguientes trabajos.
+ *
+ * @param cfg Parámetros.
+ * @param a Observación del trabajo terminado.
+ * @param tension_max Límite de tensión del material.
+ * @param falla El trabajo terminó por una falla atribuible al hilo (tensión excesiva,
+ *        rotura, atasco); las del equipo (alimentación, encoder, pantalla) no cuentan.
+ * @return Nuevo techo, dentro de [minimo, maximo].
+ */
+uint16_t aprendizaje_techo(const aprendizaje_config_t *cfg, const aprendizaje_t *a,
+                           int32_t tension_max, bool falla);
+
+#endif // APRENDIZAJE_H
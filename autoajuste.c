@@ -0,0 +1,113 @@
+/**
+ * @file autoajuste.c
+ * @brief Implementación del ensayo del relé y del cálculo de ganancias.
+ *
+ * Un ciclo va de una conmutación a salida alta hasta la siguiente. El primer ciclo
+ * completo se descarta (transitorio de arranque del relé) y los siguientes se promedian.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "autoajuste.h"
+#include <math.h>
+
+void autoajuste_iniciar(autoajuste_t *a, const autoajuste_config_t *cfg) {
+    a->cfg = *cfg;
+    a->estado = AUTOAJUSTE_ASENTANDO;
+    a->t_us = 0;
+    a->suma = 0;
+    a->n = 0;
+    a->referencia = 0;
+    a->alta = true;
+    a->t_ciclo_us = 0;
+    a->y_max = INT32_MIN;
+    a->y_min = INT32_MAX;
+    a->ciclo = 0;
+    a->suma_periodo_us = 0;
+    a->suma_amplitud = 0;
+}
+
+/**
+ * @brief Cierra un ciclo en la conmutación a salida alta.
+ */
+static void autoajuste_ciclo(autoajuste_t *a) {
+    if (a->ciclo >= 2) { // El ciclo 1 (primer ciclo completo) se descarta
+        a->suma_periodo_us += a->t_us - a->t_ciclo_us;
+        a->suma_amplitud += a->y_max - a->y_min;
+    }
+    a->ciclo++;
+    a->t_ciclo_us = a->t_us;
+    a->y_max = INT32_MIN;
+    a->y_min = INT32_MAX;
+    if (a->ciclo >= a->cfg.ciclos + 2) {
+        a->estado = AUTOAJUSTE_LISTO;
+    }
+}
+
+int32_t autoajuste_paso(autoajuste_t *a, int32_t y, uint32_t dt_us) {
+    const autoajuste_config_t *cfg = &a->cfg;
+    a->t_us += dt_us;
+
+    switch (a->estado) {
+    case AUTOAJUSTE_ASENTANDO:
+        // Se promedia la segunda mitad del asentamiento (la primera es transitorio)
+        if (a->t_us > cfg->asentamiento_us / 2) {
+            a->suma += y;
+            a->n++;
+        }
+        if (a->t_us >= cfg->asentamiento_us && a->n > 0) {
+            a->referencia = (int32_t)(a->suma / a->n);
+            a->estado = AUTOAJUSTE_RELE;
+            a->alta = true;
+        }
+        return cfg->u0;
+
+    case AUTOAJUSTE_RELE:
+        if (a->t_us > cfg->plazo_us
+                || y > a->referencia + cfg->excursion_max
+                || y < a->referencia - cfg->excursion_max) {
+            a->estado = AUTOAJUSTE_ERROR;
+            return cfg->u0;
+        }
+        if (y > a->y_max) a->y_max = y;
+        if (y < a->y_min) a->y_min = y;
+
+        if (a->alta && y > a->referencia + cfg->histeresis) {
+            a->alta = false;
+        } else if (!a->alta && y < a->referencia - cfg->histeresis) {
+            a->alta = true;
+            autoajuste_ciclo(a);
+            if (a->estado != AUTOAJUSTE_RELE) return cfg->u0;
+        }
+        return a->alta ? cfg->u0 + cfg->d : cfg->u0 - cfg->d;
+
+    default:
+        return cfg->u0;
+    }
+}
+
+bool autoajuste_resultado(const autoajuste_t *a, pid_ganancias_t *g, int32_t *ganancia_q8) {
+    if (a->estado != AUTOAJUSTE_LISTO || a->cfg.ciclos == 0) return false;
+
+    float tu_s = (float)a->suma_periodo_us / a->cfg.ciclos / 1e6f;
+    float amplitud = (float)a->suma_amplitud / a->cfg.ciclos / 2.0f;
+    float h = (float)a->cfg.histeresis;
+    if (amplitud <= h || tu_s <= 0.0f) return false; // Oscilación no medible
+
+    // Ganancia crítica con corrección por la histéresis del relé
+    float ku = 4.0f * (float)a->cfg.d / (3.14159265f * sqrtf(amplitud * amplitud - h * h));
+    bool zn = a->cfg.regla == AUTOAJUSTE_ZIEGLER_NICHOLS;
+    float kp = zn ? 0.45f * ku : ku / 3.2f;
+    float ti = zn ? tu_s / 1.2f : 2.2f * tu_s;
+
+    g->kp_q16 = (int32_t)(kp * 65536.0f);
+    g->ki_q16 = (int32_t)(kp / ti * 65536.0f);
+    g->kd_q16 = 0;
+    if (g->kp_q16 == 0) g->kp_q16 = 1; // Ajustado aunque la ganancia sea muy baja
+
+    if (ganancia_q8) {
+        *ganancia_q8 = a->cfg.u0 ? (int32_t)(((int64_t)a->referencia << 8) / a->cfg.u0) : 0;
+    }
+    return true;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file autoajuste.h
+ * @brief Autoajuste de PID por el método del relé (Åström–Hägglund).
+ *
+ * Alrededor de un punto de operación `u0` la salida conmuta entre `u0 + d` y `u0 - d`
+ * según la medida esté por debajo o por encima de la referencia (con histéresis). La planta
+ * entra en un ciclo límite cuyo periodo `Tu` y amplitud `a` dan la ganancia crítica
+ * Ku = 4·d / (pi·sqrt(a² - h²)). Con ellas se calcula un PI por una de dos reglas
+ * (`autoajuste_regla_t`):
+ * - Tyreus–Luyben (Kp = Ku/3.2, Ti = 2.2·Tu): conservadora a propósito. Apenas sobrepasa
+ *   la referencia y tolera el ruido de cuantización del encoder, pero recupera despacio
+ *   un escalón de carga: en la planta de tools/autoajuste_simular.c, Ti ≈ 3.2 s y 9.4 s
+ *   para volver a ±2 % tras perder el 20 % de ganancia.
+ * - Ziegler–Nichols (Kp = 0.45·Ku, Ti = Tu/1.2): en la misma planta, Ti ≈ 1.2 s y 2.7 s
+ *   de recuperación (`autoajuste_simular -z`), a cambio de menos margen si la planta
+ *   cambia con el material.
+ *
+ * Límites de seguridad: plazo máximo, excursión máxima de la medida respecto de la
+ * referencia y salida siempre dentro de `u0 ± d`. Si alguno se supera el ensayo termina
+ * en error sin tocar las ganancias.
+ *
+ * tools/autoajuste_simular.c ejecuta este mismo ensayo sobre una planta de primer orden con
+ * retardo y mide las ganancias obtenidas y la respuesta a un escalón de carga.
+ */
+
+#ifndef AUTOAJUSTE_H
+#define AUTOAJUSTE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pid.h"
+
+/**
+ * @brief Regla de ajuste del PI a partir de Ku y Tu.
+ */
+typedef enum {
+    AUTOAJUSTE_TYREUS_LUYBEN = 0, ///< Conservadora: poco sobreimpulso, recuperación lenta.
+    AUTOAJUSTE_ZIEGLER_NICHOLS,   ///< Rápida: más sobreimpulso y menos margen.
+} autoajuste_regla_t;
+
+/**
+ * @brief Parámetros del ensayo.
+ */
+typedef struct {
+    autoajuste_regla_t regla; ///< Regla de ajuste de las ganancias.
+    int32_t u0;               ///< Salida en el punto de operación.
+    int32_t d;                ///< Amplitud del relé.
+    int32_t histeresis;       ///< Histéresis del relé, en unidades de la medida.
+    uint8_t ciclos;           ///< Ciclos a promediar (el primero se descarta).
+    uint32_t asentamiento_us; ///< Tiempo en `u0` para medir la referencia.
+    uint32_t plazo_us;        ///< Duración máxima del ensayo.
+    int32_t excursion_max;    ///< Desvío máximo admisible de la medida respecto de la referencia.
+} autoajuste_config_t;
+
+/**
+ * @brief Fase del ensayo.
+ */
+typedef enum {
+    AUTOAJUSTE_ASENTANDO = 0, ///< Midiendo la referencia en `u0`.
+    AUTOAJUSTE_RELE,          ///< Oscilación con relé.
+    AUTOAJUSTE_LISTO,         ///< Terminado: hay resultado.
+    AUTOAJUSTE_ERROR,         ///< Abortado por un límite de seguridad.
+} autoajuste_estado_t;
+
+/**
+ * @brief Estado del ensayo.
+ */
+typedef struct {
+    autoajuste_config_t cfg;   ///< Copia de la configuración.
+    autoajuste_estado_t estado; ///< Fase actual.
+    uint32_t t_us;             ///< Tiempo desde el inicio del ensayo.
+    int64_t suma;              ///< Acumulador de la referencia durante el asentamiento.
+    uint32_t n;                ///< Muestras acumuladas.
+    int32_t referencia;        ///< Medida media en `u0`.
+    bool alta;                 ///< El relé está en `u0 + d`.
+    uint32_t t_ciclo_us;       ///< Inicio del ciclo en curso.
+    int32_t y_max;             ///< Máximo de la medida en el ciclo en curso.
+    int32_t y_min;             ///< Mínimo de la medida en el ciclo en curso.
+    uint8_t ciclo;             ///< Ciclos completados.
+    uint64_t suma_periodo_us;  ///< Suma de periodos de los ciclos válidos.
+    int64_t suma_amplitud;     ///< Suma de amplitudes pico a pico de los ciclos válidos.
+} autoajuste_t;
+
+/**
+ * @brief Inicia el ensayo.
+ *
+ * @param a Ensayo.
+ * @param cfg Parámetros (se copian).
+ */
+void autoajuste_iniciar(autoajuste_t *a, const autoajuste_config_t *cfg);
+
+/**
+ * @brief Avanza el ensayo con una nueva medida.
+ *
+ * @param a Ensayo.
+ * @param y Medida actual.
+ * @param dt_us Tiempo desde la medida anterior.
+ * @return Salida a aplicar a la planta.
+ */
+int32_t autoajuste_paso(autoajuste_t *a, int32_t y, uint32_t dt_us);
+
+/**
+ * @brief Calcula las ganancias de un ensayo terminado.
+ *
+ * @param a Ensayo en estado `AUTOAJUSTE_LISTO`.
+ * @param g Recibe las ganancias del PI.
+ * @param ganancia_q8 Si no es nulo, recibe la ganancia estática de la planta (medida/salida, Q8).
+ * @return `false` si el ensayo no terminó bien o la oscilación no es medible.
+ */
+bool autoajuste_resultado(const autoajuste_t *a, pid_ganancias_t *g, int32_t *ganancia_q8);
+
+#endif // AUTOAJUSTE_H
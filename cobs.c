@@ -0,0 +1,49 @@
+/**
+ * @file cobs.c
+ * @brief Implementación de la codificación y decodificación COBS.
+ *
+ * Cada bloque codificado empieza con un byte de código `c`: le siguen `c - 1` bytes de
+ * datos distintos de 0 y, si `c < 0xFF`, un 0 implícito (salvo al final de la trama).
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "cobs.h"
+
+size_t cobs_codificar(const uint8_t *datos, size_t n, uint8_t *trama) {
+    size_t codigo_idx = 0; // Posición del código del bloque en curso
+    size_t salida = 1;
+    uint8_t codigo = 1;
+    for (size_t i = 0; i < n; i++) {
+        if (datos[i] != 0) {
+            trama[salida++] = datos[i];
+            codigo++;
+        }
+        if (datos[i] == 0 || codigo == 0xFF) { // Cierra el bloque
+            trama[codigo_idx] = codigo;
+            codigo_idx = salida++;
+            codigo = 1;
+        }
+    }
+    trama[codigo_idx] = codigo;
+    trama[salida++] = 0;
+    return salida;
+}
+
+size_t cobs_decodificar(const uint8_t *trama, size_t n, uint8_t *datos) {
+    size_t salida = 0;
+    size_t i = 0;
+    while (i < n) {
+        uint8_t codigo = trama[i++];
+        if (codigo == 0 || i + codigo - 1 > n) return 0; // 0 dentro de la trama o bloque cortado
+        for (uint8_t k = 1; k < codigo; k++) {
+            if (trama[i] == 0) return 0;
+            datos[salida++] = trama[i++];
+        }
+        if (codigo < 0xFF && i < n) {
+            datos[salida++] = 0;
+        }
+    }
+    return salida;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file cobs.h
+ * @brief Entramado COBS (Consistent Overhead Byte Stuffing) para los flujos binarios.
+ *
+ * COBS reescribe un bloque de bytes de modo que no contenga ningún 0 y le añade un 0 como
+ * delimitador: el receptor se sincroniza en el siguiente 0 aunque se pierdan bytes. El
+ * costo es de un byte por cada 254 de datos más el delimitador.
+ *
+ * El módulo no depende del SDK: lo comparten el equipo y las herramientas del PC.
+ */
+
+#ifndef COBS_H
+#define COBS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Tamaño máximo de la trama codificada (con el delimitador) para `n` bytes de datos.
+#define COBS_TRAMA_MAX(n) ((n) + (n) / 254 + 2)
+
+/**
+ * @brief Codifica un bloque y le añade el delimitador.
+ *
+ * @param datos Bloque a codificar.
+ * @param n Bytes del bloque.
+ * @param trama Destino, de al menos `COBS_TRAMA_MAX(n)` bytes.
+ * @return Bytes escritos, incluido el 0 final.
+ */
+size_t cobs_codificar(const uint8_t *datos, size_t n, uint8_t *trama);
+
+/**
+ * @brief Decodifica una trama recibida.
+ *
+ * @param trama Bytes entre dos delimitadores (sin el 0 final).
+ * @param n Bytes de la trama.
+ * @param datos Destino, de al menos `n` bytes.
+ * @return Bytes decodificados, o 0 si la trama está mal formada.
+ */
+size_t cobs_decodificar(const uint8_t *trama, size_t n, uint8_t *datos);
+
+#endif // COBS_H
@@ -0,0 +1,53 @@
+/**
+ * @file control.c
+ * @brief Implementación de los cálculos comunes del tick de control.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "control.h"
+
+const tension_config_t control_tension_cfg = {
+    .cuentas_por_g = HX711_CUENTAS_POR_G,
+    .inercia_g_q16 = TENSION_INERCIA_G_Q16,
+    .ruido_g = TENSION_RUIDO_G,
+    .deriva_min_g = TENSION_DERIVA_MIN_G,
+    .deriva_max_g = TENSION_DERIVA_MAX_G,
+};
+
+// Ajuste simulado (ver anomalia.h y tools/anomalia_simular.c): más de 3·10^5 ticks
+// (~1.8 h) entre falsas alarmas, deriva de 1 desviación en ~0.5 s, varianza doble en ~1.8 s.
+const anomalia_config_t control_anomalia_cfg = {
+    .log2_base = 9,
+    .aprendizaje = 256,  // ~5 s de línea base a 50 Hz
+    .desviacion_min = 1, // 1 g o 1 rpm
+    .k_media_q8 = 128,   // 0.5
+    .h_media_q8 = 3072,  // 12
+    .k_varianza_q8 = 115, // 0.45
+    .h_varianza_q8 = 10240, // 40
+};
+
+int32_t control_rpm(uint32_t periodo_pulso_us, uint32_t pulsos_por_vuelta) {
+    return periodo_pulso_us ? (int32_t)(60000000u / (periodo_pulso_us * pulsos_por_vuelta)) : 0;
+}
+
+void control_vigilancia_reiniciar(control_vigilancia_t *v, uint32_t ahora) {
+    anomalia_iniciar(&v->tension, &control_anomalia_cfg);
+    anomalia_iniciar(&v->rpm, &control_anomalia_cfg);
+    control_vigilancia_esperar(v, ahora);
+}
+
+void control_vigilancia_esperar(control_vigilancia_t *v, uint32_t ahora) {
+    v->desde_us = ahora + ANOMALIA_ESPERA_MS * 1000;
+}
+
+anomalia_resultado_t control_vigilar(control_vigilancia_t *v, uint32_t ahora, int32_t tension_g, int32_t rpm) {
+    if ((int32_t)(ahora - v->desde_us) < 0) return ANOMALIA_NINGUNA; // Transitorio de velocidad
+
+    anomalia_resultado_t r = anomalia_actualizar(&v->tension, tension_g);
+    anomalia_resultado_t r_rpm = anomalia_actualizar(&v->rpm, rpm);
+    if (r == ANOMALIA_NINGUNA) r = r_rpm;
+    if (r != ANOMALIA_NINGUNA) control_vigilancia_reiniciar(v, ahora);
+    return r;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file control.h
+ * @brief Parámetros y cálculos del tick de control comunes al equipo y a las herramientas del PC.
+ *
+ * Reúne lo que Final_dig.c y las simulaciones de tools/ deben compartir para dar los mismos
+ * resultados: el periodo del tick, la calibración del estimador de tensión de la celda
+ * principal, el ajuste de los detectores de anomalías, la medida de velocidad del tambor
+ * y la vigilancia de anomalías sobre la tensión y la velocidad.
+ *
+ * El módulo no depende del SDK.
+ */
+
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <stdint.h>
+#include "anomalia.h"
+#include "tension.h"
+
+#define CONTROL_PERIODO_US 20000      ///< Periodo del tick de control (50 Hz).
+#define ANOMALIA_ESPERA_MS 1000       ///< Transitorio tras arrancar o cambiar de velocidad que no se vigila.
+#define HX711_CUENTAS_POR_G 420       ///< Escala de la celda de carga: cuentas del HX711 por gramo.
+#define TENSION_INERCIA_G_Q16 655     ///< Tensión inercial por aceleración del tambor: 0.01 g/(pulso/s²) en Q16.
+#define TENSION_RUIDO_G 15            ///< Desviación del ruido de la celda con el tambor girando (g).
+#define TENSION_DERIVA_MIN_G 1        ///< Cambio real mínimo de tensión entre muestras (g): suavizado con tensión estable.
+#define TENSION_DERIVA_MAX_G 200      ///< Cambio real máximo de tensión entre muestras (g): rapidez ante cambios.
+
+extern const tension_config_t control_tension_cfg;   ///< Calibración del estimador de la celda principal.
+extern const anomalia_config_t control_anomalia_cfg; ///< Ajuste de los detectores de anomalías.
+
+/**
+ * @brief Detectores de anomalías del bobinado.
+ */
+typedef struct {
+    anomalia_t tension; ///< Detector sobre la medida de tensión.
+    anomalia_t rpm;     ///< Detector sobre la velocidad del tambor.
+    uint32_t desde_us;  ///< Instante a partir del cual se vigila.
+} control_vigilancia_t;
+
+/**
+ * @brief Velocidad del tambor a partir del periodo entre pulsos del encoder.
+ *
+ * @param periodo_pulso_us Tiempo entre los dos últimos pulsos (0 = aún no hubo dos).
+ * @param pulsos_por_vuelta Pulsos del encoder por vuelta del tambor.
+ * @return Velocidad en rpm (0 sin periodo).
+ */
+int32_t control_rpm(uint32_t periodo_pulso_us, uint32_t pulsos_por_vuelta);
+
+/**
+ * @brief Reinicia los detectores para un nuevo punto de operación.
+ *
+ * La línea base se vuelve a aprender tras el transitorio de `ANOMALIA_ESPERA_MS`.
+ * @param v Detectores.
+ * @param ahora Instante actual.
+ */
+void control_vigilancia_reiniciar(control_vigilancia_t *v, uint32_t ahora);
+
+/**
+ * @brief Aplaza la vigilancia `ANOMALIA_ESPERA_MS` desde ahora, sin olvidar la línea base.
+ *
+ * Para las rampas de velocidad y las pausas.
+ */
+void control_vigilancia_esperar(control_vigilancia_t *v, uint32_t ahora);
+
+/**
+ * @brief Tick de la vigilancia: pasa la tensión y la velocidad por los detectores.
+ *
+ * Ante una anomalía reinicia los detectores (ver `control_vigilancia_reiniciar()`).
+ * @param v Detectores.
+ * @param ahora Instante del tick.
+ * @param tension_g Medida de tensión compensada (`tension_medida_gramos()`).
+ * @param rpm Velocidad del tambor (`control_rpm()`).
+ * @return La anomalía detectada (la de tensión si saltan las dos) o `ANOMALIA_NINGUNA`.
+ */
+anomalia_resultado_t control_vigilar(control_vigilancia_t *v, uint32_t ahora, int32_t tension_g, int32_t rpm);
+
+#endif // CONTROL_H
@@ -0,0 +1,79 @@
+/**
+ * @file corriente.c
+ * @brief Implementación de la protección por corriente del motor.
+ *
+ * Modelo I²t: en cada muestra se acumula (I² - I_nominal²)·dt, sin bajar de cero. Mientras
+ * la corriente está por debajo de la nominal el acumulador se descarga; una sobrecarga
+ * sostenida lo llena hasta `i2t_limite_a2ms` y dispara. El acumulador trabaja en mA²·ms
+ * con 64 bits.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "corriente.h"
+#include "pico/stdlib.h"
+#include "analogico.h"
+#include "fallas.h"
+
+static corriente_config_t cfg_corriente;      ///< Calibración del sensor.
+static volatile bool armada = false;          ///< La protección está activa.
+static volatile int32_t ultima_ma = 0;        ///< Última corriente medida.
+static uint32_t max_ma;                       ///< Umbral de atasco del material.
+static int64_t nominal2;                      ///< Corriente nominal al cuadrado (mA²).
+static int64_t limite_i2t;                    ///< Límite del acumulador (mA²·ms).
+static int64_t acumulado_i2t;                 ///< Acumulador del modelo I²t (mA²·ms).
+static uint32_t dt_us;                        ///< Periodo de la muestra de corriente.
+static uint32_t inicio_us;                    ///< Instante en que se armó la protección.
+
+/**
+ * @brief Reporta el disparo al gestor de fallas. Se ejecuta en la interrupción del ADC.
+ */
+static void corriente_disparar(falla_t falla) {
+    armada = false;
+    falla_reportar(falla, time_us_32());
+}
+
+/**
+ * @brief Evalúa cada nueva muestra de corriente (callback del canal ANALOG_CORRIENTE).
+ */
+static void corriente_muestra(uint16_t valor) {
+    int32_t mv = (int32_t)analog_a_mv(valor) - (int32_t)cfg_corriente.cero_mv;
+    int32_t ma = (mv * 1000) / (int32_t)cfg_corriente.mv_por_amperio;
+    if (ma < 0) ma = -ma;
+    ultima_ma = ma;
+    if (!armada) return;
+
+    // Atasco: disparo instantáneo, salvo durante el pico de arranque
+    if ((uint32_t)ma > max_ma && time_us_32() - inicio_us > cfg_corriente.arranque_ms * 1000) {
+        corriente_disparar(FALLA_ATASCO);
+        return;
+    }
+
+    // Sobrecarga: integración de I² por encima de la nominal
+    acumulado_i2t += (((int64_t)ma * ma - nominal2) * dt_us) / 1000;
+    if (acumulado_i2t < 0) acumulado_i2t = 0;
+    if (acumulado_i2t > limite_i2t) {
+        corriente_disparar(FALLA_SOBRECARGA);
+    }
+}
+
+void corriente_iniciar(const corriente_config_t *cfg) {
+    cfg_corriente = *cfg;
+    dt_us = analog_periodo_us(ANALOG_CORRIENTE);
+    analog_set_callback(ANALOG_CORRIENTE, corriente_muestra);
+}
+
+void corriente_armar(const material_perfil_t *perfil) {
+    armada = false; // Evita que la ISR use límites a medio actualizar
+    max_ma = perfil->corriente_max_ma;
+    nominal2 = (int64_t)perfil->corriente_nominal_ma * perfil->corriente_nominal_ma;
+    limite_i2t = (int64_t)perfil->i2t_limite_a2ms * 1000000; // A² -> mA²
+    acumulado_i2t = 0;
+    inicio_us = time_us_32();
+    armada = true;
+}
+
+int32_t corriente_ma(void) {
+    return ultima_ma;
+}
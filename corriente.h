@@ -0,0 +1,48 @@
+/**
+ * @file corriente.h
+ * @brief Protección del motor por corriente: atasco (disparo instantáneo) y sobrecarga (I²t).
+ *
+ * La corriente se evalúa en cada salida filtrada del canal `ANALOG_CORRIENTE` (4 kHz),
+ * dentro de la interrupción del DMA del ADC. Al disparar se reporta la falla al gestor
+ * (`FALLA_ATASCO` o `FALLA_SOBRECARGA`) en la misma interrupción, que corta el motor en
+ * menos de 1 ms desde el pico.
+ */
+
+#ifndef CORRIENTE_H
+#define CORRIENTE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "material.h"
+
+/**
+ * @brief Calibración del sensor de corriente.
+ */
+typedef struct {
+    uint32_t mv_por_amperio; ///< Sensibilidad del sensor en el pin del ADC, en mV/A.
+    uint32_t cero_mv;        ///< Tensión del sensor a corriente nula, en mV.
+    uint32_t arranque_ms;    ///< Tiempo tras armar en que se ignora el pico de arranque.
+} corriente_config_t;
+
+/**
+ * @brief Registra la protección sobre el canal de corriente del ADC.
+ *
+ * Debe llamarse después de `analog_iniciar()`. La protección queda desarmada.
+ * @param cfg Calibración (se copia).
+ */
+void corriente_iniciar(const corriente_config_t *cfg);
+
+/**
+ * @brief Arma la protección con los límites del material.
+ *
+ * Debe llamarse justo antes de encender el motor.
+ * @param perfil Perfil del material a bobinar.
+ */
+void corriente_armar(const material_perfil_t *perfil);
+
+/**
+ * @brief Devuelve la última corriente medida en mA.
+ */
+int32_t corriente_ma(void);
+
+#endif // CORRIENTE_H
@@ -0,0 +1,129 @@
+/**
+ * @file fallas.c
+ * @brief Implementación del gestor central de fallas.
+ *
+ * La tabla de fallas fija prioridad y acción de cada tipo en un solo sitio auditable.
+ * Las acciones que detienen el motor lo cortan antes de cualquier otra cosa y el tiempo
+ * de reacción se mide justo después del corte.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "fallas.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "motor.h"
+
+/**
+ * @brief Descripción fija de un tipo de falla.
+ */
+typedef struct {
+    const char *nombre;      ///< Texto para la pantalla (máx. 21 caracteres).
+    uint8_t prioridad;       ///< Prioridad: mayor valor, más urgente.
+    falla_accion_t accion;   ///< Acción a aplicar.
+} falla_desc_t;
+
+/// Prioridad y acción de cada falla.
+static const falla_desc_t tabla[FALLA_NUM] = {
+    [FALLA_NINGUNA]          = { "",                  0, FALLA_AVISAR },
+    [FALLA_TENSION_ALTA]     = { "TENSION EXCESIVA!", 6, FALLA_PARAR },
+    [FALLA_TENSION_BAJA]     = { "TENSION BAJA",      3, FALLA_PAUSAR },
+    [FALLA_ROTURA]           = { "HILO ROTO!",        7, FALLA_PARAR },
+    [FALLA_ENCODER_DETENIDO] = { "TAMBOR BLOQUEADO!", 6, FALLA_PARAR },
+    [FALLA_ATASCO]           = { "ATASCO!",           7, FALLA_PARAR },
+    [FALLA_SOBRECARGA]       = { "SOBRECARGA!",       5, FALLA_FRENAR },
+    [FALLA_BUS_PANTALLA]     = { "ERROR PANTALLA",    1, FALLA_AVISAR },
+    [FALLA_WATCHDOG]         = { "REINICIO WATCHDOG", 2, FALLA_AVISAR },
+    [FALLA_ANOMALIA]         = { "HILO IRREGULAR",    2, FALLA_AVISAR },
+    [FALLA_ALIMENTACION]     = { "CAIDA DE TENSION",  8, FALLA_PAUSAR },
+};
+
+static volatile falla_t activa = FALLA_NINGUNA; ///< Falla enclavada de mayor prioridad.
+static falla_registro_t historial[FALLAS_HISTORIAL]; ///< Últimas fallas reportadas.
+static uint32_t historial_idx = 0;              ///< Próxima posición del historial.
+static volatile uint32_t enclavadas = 0;        ///< Máscara de tipos ya reportados desde el último rearme.
+static volatile uint32_t reportadas = 0;        ///< Registros escritos en el historial desde el arranque.
+
+void fallas_iniciar(void) {
+    activa = FALLA_NINGUNA;
+    enclavadas = 0;
+}
+
+void falla_reportar(falla_t tipo, uint32_t deteccion_us) {
+    if (tipo <= FALLA_NINGUNA || tipo >= FALLA_NUM) return;
+
+    // Reacción primero: cortar el motor es devolver su pin a la SIO (salida en 0)
+    if (tabla[tipo].accion != FALLA_AVISAR) {
+        motor_cortar();
+    }
+    uint32_t reaccion = time_us_32() - deteccion_us;
+
+    // Registro y enclavamiento, protegidos frente a reportes desde interrupciones
+    uint32_t estado = save_and_disable_interrupts();
+    if (enclavadas & (1u << tipo)) { // Ya enclavada: no se repite en el historial
+        restore_interrupts(estado);
+        return;
+    }
+    enclavadas |= 1u << tipo;
+    falla_registro_t *r = &historial[historial_idx];
+    historial_idx = (historial_idx + 1) % FALLAS_HISTORIAL;
+    r->tipo = tipo;
+    r->deteccion_us = deteccion_us;
+    r->reaccion_us = reaccion;
+    reportadas++;
+    if (tabla[tipo].prioridad > tabla[activa].prioridad) {
+        activa = tipo;
+    }
+    restore_interrupts(estado);
+}
+
+falla_t falla_activa(void) {
+    return activa;
+}
+
+void falla_liberar(falla_t tipo) {
+    if (tipo <= FALLA_NINGUNA || tipo >= FALLA_NUM) return;
+    uint32_t estado = save_and_disable_interrupts();
+    enclavadas &= ~(1u << tipo);
+    activa = FALLA_NINGUNA;
+    for (int f = FALLA_NINGUNA + 1; f < FALLA_NUM; f++) { // La siguiente más urgente, si la hay
+        if ((enclavadas & (1u << f)) && tabla[f].prioridad > tabla[activa].prioridad) {
+            activa = (falla_t)f;
+        }
+    }
+    restore_interrupts(estado);
+}
+
+falla_accion_t falla_accion(falla_t tipo) {
+    return tabla[tipo].accion;
+}
+
+const char *falla_nombre(falla_t tipo) {
+    return tabla[tipo].nombre;
+}
+
+const falla_registro_t *falla_registro(falla_t tipo) {
+    // Recorre el historial desde el más reciente
+    for (uint32_t i = 1; i <= FALLAS_HISTORIAL; i++) {
+        const falla_registro_t *r = &historial[(historial_idx + FALLAS_HISTORIAL - i) % FALLAS_HISTORIAL];
+        if (r->tipo == tipo) return r;
+    }
+    return NULL;
+}
+
+uint32_t fallas_reportadas(void) {
+    return reportadas;
+}
+
+const falla_registro_t *falla_historial(uint32_t n) {
+    if (n >= reportadas || reportadas - n > FALLAS_HISTORIAL) return NULL;
+    return &historial[n % FALLAS_HISTORIAL];
+}
+
+void fallas_rearmar(void) {
+    uint32_t estado = save_and_disable_interrupts();
+    activa = FALLA_NINGUNA;
+    enclavadas = 0;
+    restore_interrupts(estado);
+}
@@ -0,0 +1,120 @@
+/**
+ * @file fallas.h
+ * @brief Gestor central de fallas: tipos, prioridades, acciones y tiempos de reacción.
+ *
+ * Todas las protecciones (tensión, rotura, encoder, corriente, pantalla, watchdog) reportan
+ * aquí. `falla_reportar()` aplica la acción de la falla en el acto (también desde una
+ * interrupción), la enclava y registra el instante de detección y el tiempo hasta la
+ * reacción. Queda activa la falla de mayor prioridad hasta `fallas_rearmar()`.
+ */
+
+#ifndef FALLAS_H
+#define FALLAS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Tipos de falla.
+ */
+typedef enum {
+    FALLA_NINGUNA = 0,      ///< Sin falla.
+    FALLA_TENSION_ALTA,     ///< Tensión del hilo por encima del máximo del material.
+    FALLA_TENSION_BAJA,     ///< Tensión del hilo por debajo del mínimo (hilo flojo).
+    FALLA_ROTURA,           ///< Fotointerruptor: hilo roto o ausente.
+    FALLA_ENCODER_DETENIDO, ///< Motor encendido sin pulsos del encoder (tambor bloqueado).
+    FALLA_ATASCO,           ///< Pico de corriente del motor (atasco).
+    FALLA_SOBRECARGA,       ///< Sobrecarga térmica del motor (I²t).
+    FALLA_BUS_PANTALLA,     ///< Error de comunicación I2C con la pantalla.
+    FALLA_WATCHDOG,         ///< El último reinicio lo provocó el watchdog.
+    FALLA_ANOMALIA,         ///< Tensión o velocidad irregulares: el hilo se degrada (se ralentiza).
+    FALLA_ALIMENTACION,     ///< Caída de la alimentación de 12 V: se guarda el trabajo para reanudarlo.
+    FALLA_NUM
+} falla_t;
+
+/**
+ * @brief Acción asociada a una falla, de menor a mayor severidad.
+ */
+typedef enum {
+    FALLA_AVISAR = 0, ///< Solo se informa; el bobinado continúa.
+    FALLA_PAUSAR,     ///< Se corta el motor y el trabajo queda en pausa (o, sin alimentación, en su punto de control) para reanudarlo.
+    FALLA_FRENAR,     ///< Se corta el motor y el traslado acompaña al tambor hasta que se detiene.
+    FALLA_PARAR,      ///< Parada inmediata; el trabajo termina.
+} falla_accion_t;
+
+/**
+ * @brief Registro de una falla detectada.
+ */
+typedef struct {
+    falla_t tipo;             ///< Tipo de falla.
+    uint32_t deteccion_us;    ///< Instante de la detección (time_us_32).
+    uint32_t reaccion_us;     ///< Tiempo desde la detección hasta aplicar la acción.
+} falla_registro_t;
+
+#define FALLAS_HISTORIAL 8 ///< Fallas conservadas en el historial.
+
+/**
+ * @brief Inicializa el gestor.
+ *
+ * Las acciones que detienen el motor lo cortan con `motor_cortar()`: debe llamarse
+ * después de `motor_iniciar()`.
+ */
+void fallas_iniciar(void);
+
+/**
+ * @brief Reporta una falla, aplica su acción y la enclava.
+ *
+ * Puede llamarse desde una interrupción.
+ * @param tipo Tipo de falla.
+ * @param deteccion_us Instante (time_us_32) en que la fuente detectó la condición.
+ */
+void falla_reportar(falla_t tipo, uint32_t deteccion_us);
+
+/**
+ * @brief Devuelve la falla enclavada de mayor prioridad, o `FALLA_NINGUNA`.
+ */
+falla_t falla_activa(void);
+
+/**
+ * @brief Desenclava una falla ya atendida (p. ej. al pausar el trabajo) sin tocar las demás.
+ *
+ * Queda en el historial; si vuelve a reportarse se registra de nuevo.
+ * @param tipo Tipo de falla.
+ */
+void falla_liberar(falla_t tipo);
+
+/**
+ * @brief Devuelve la acción de un tipo de falla.
+ */
+falla_accion_t falla_accion(falla_t tipo);
+
+/**
+ * @brief Devuelve el texto a mostrar para un tipo de falla.
+ */
+const char *falla_nombre(falla_t tipo);
+
+/**
+ * @brief Devuelve el registro más reciente del tipo indicado en el historial, o `NULL`.
+ */
+const falla_registro_t *falla_registro(falla_t tipo);
+
+/**
+ * @brief Devuelve cuántas fallas se registraron en el historial desde el arranque.
+ */
+uint32_t fallas_reportadas(void);
+
+/**
+ * @brief Devuelve el registro número `n` (desde el arranque, empezando en 0).
+ *
+ * @return `NULL` si aún no existe o ya se sobrescribió en el historial.
+ */
+const falla_registro_t *falla_historial(uint32_t n);
+
+/**
+ * @brief Borra las fallas enclavadas (el historial se conserva).
+ *
+ * Se llama al empezar cada trabajo.
+ */
+void fallas_rearmar(void);
+
+#endif // FALLAS_H
@@ -0,0 +1,72 @@
+/**
+ * @file fft.c
+ * @brief Implementación de la FFT Q15 (decimación en el tiempo, mariposas con escalado).
+ *
+ * Se usa una sola tabla de `FFT_N_MAX` senos; el coseno se lee desplazado un cuarto de
+ * periodo, y los tamaños menores recorren la tabla con paso `FFT_N_MAX / N`.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "fft.h"
+#include <math.h>
+
+static int16_t seno[FFT_N_MAX]; ///< sin(2·pi·k / FFT_N_MAX) en Q15.
+
+/**
+ * @brief cos(2·pi·k / FFT_N_MAX) en Q15.
+ */
+static inline int32_t coseno(unsigned k) {
+    return seno[(k + FFT_N_MAX / 4) & (FFT_N_MAX - 1)];
+}
+
+void fft_iniciar(void) {
+    for (unsigned k = 0; k < FFT_N_MAX; k++) {
+        float v = sinf(2.0f * 3.14159265f * (float)k / FFT_N_MAX) * 32767.0f;
+        seno[k] = (int16_t)lrintf(v);
+    }
+}
+
+void fft_ventana_hann(int16_t *x, unsigned log2n) {
+    unsigned n = 1u << log2n;
+    unsigned paso = FFT_N_MAX >> log2n;
+    for (unsigned i = 0; i < n; i++) {
+        int32_t w = (32767 - coseno(i * paso)) >> 1; // 0.5·(1 - cos)
+        x[i] = (int16_t)((x[i] * w) >> 15);
+    }
+}
+
+void fft_q15(int16_t *re, int16_t *im, unsigned log2n) {
+    unsigned n = 1u << log2n;
+
+    // Reordenamiento por inversión de bits
+    for (unsigned i = 1, j = 0; i < n; i++) {
+        unsigned bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j |= bit;
+        if (i < j) {
+            int16_t t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    // Mariposas: cada etapa divide por 2 (escalado total 1/N)
+    for (unsigned largo = 2; largo <= n; largo <<= 1) {
+        unsigned mitad = largo >> 1;
+        unsigned paso = FFT_N_MAX / largo;
+        for (unsigned k = 0; k < mitad; k++) {
+            int32_t wr = coseno(k * paso);
+            int32_t wi = -seno[k * paso];
+            for (unsigned i = k; i < n; i += largo) {
+                unsigned j = i + mitad;
+                int32_t tr = (re[j] * wr - im[j] * wi) >> 15;
+                int32_t ti = (re[j] * wi + im[j] * wr) >> 15;
+                re[j] = (int16_t)((re[i] - tr) >> 1);
+                im[j] = (int16_t)((im[i] - ti) >> 1);
+                re[i] = (int16_t)((re[i] + tr) >> 1);
+                im[i] = (int16_t)((im[i] + ti) >> 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,47 @@
+/**
+ * @file fft.h
+ * @brief FFT de raíz 2 en punto fijo (Q15) para el análisis de vibraciones.
+ *
+ * Transformada en el sitio sobre partes real e imaginaria de 16 bits. Cada etapa divide
+ * por 2 para no desbordar, así que la salida queda escalada por 1/N. La tabla de senos
+ * se calcula una vez en `fft_iniciar()`.
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <stdint.h>
+
+#define FFT_LOG2_MAX 8                  ///< log2 del mayor tamaño admitido.
+#define FFT_N_MAX (1u << FFT_LOG2_MAX)  ///< Mayor tamaño admitido (256 puntos).
+
+/**
+ * @brief Calcula la tabla de senos. Debe llamarse una vez antes de usar la FFT.
+ */
+void fft_iniciar(void);
+
+/**
+ * @brief Aplica una ventana de Hann en el sitio (reduce la fuga espectral).
+ *
+ * @param x Muestras Q15.
+ * @param log2n log2 del número de muestras (hasta `FFT_LOG2_MAX`).
+ */
+void fft_ventana_hann(int16_t *x, unsigned log2n);
+
+/**
+ * @brief FFT compleja en el sitio, salida escalada por 1/N en orden natural.
+ *
+ * @param re Partes reales (Q15).
+ * @param im Partes imaginarias (Q15).
+ * @param log2n log2 del número de puntos (hasta `FFT_LOG2_MAX`).
+ */
+void fft_q15(int16_t *re, int16_t *im, unsigned log2n);
+
+/**
+ * @brief Potencia de un bin: re² + im².
+ */
+static inline uint32_t fft_potencia(int16_t re, int16_t im) {
+    return (uint32_t)((int32_t)re * re + (int32_t)im * im);
+}
+
+#endif // FFT_H
@@ -0,0 +1,78 @@
+/**
+ * @file hilos.c
+ * @brief Implementación de la medida de tensión de varios hilos.
+ *
+ * El promedio exponencial usa alfa = 1/2: a 80 muestras/s un salto de tensión se ve en
+ * una o dos muestras y el ruido de cada celda se reduce a la mitad de su varianza.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "hilos.h"
+
+#define HILOS_ALFA_LOG2 1 ///< Alfa del promedio exponencial como potencia de 2 (1/2).
+
+void hilos_iniciar(hilos_t *h, uint8_t n, int32_t cuentas_por_g) {
+    h->n = n > HILOS_MAX ? HILOS_MAX : n;
+    h->cuentas_por_g = cuentas_por_g;
+    for (int i = 0; i < HILOS_MAX; i++) {
+        h->tara[i] = 0;
+        h->gramos_q8[i] = 0;
+    }
+    h->iniciado = false;
+}
+
+void hilos_tarar(hilos_t *h, const int64_t *suma, uint32_t muestras) {
+    for (int i = 0; i < h->n; i++) {
+        h->tara[i] = (int32_t)(suma[i] / muestras);
+    }
+    h->iniciado = false; // El filtro anterior usaba otra tara
+}
+
+void hilos_actualizar(hilos_t *h, const int32_t *crudas) {
+    for (int i = 0; i < h->n; i++) {
+        int32_t z_q8 = (int32_t)((((int64_t)crudas[i] - h->tara[i]) << 8) / h->cuentas_por_g);
+        if (h->iniciado) {
+            h->gramos_q8[i] += (z_q8 - h->gramos_q8[i]) >> HILOS_ALFA_LOG2;
+        } else {
+            h->gramos_q8[i] = z_q8;
+        }
+    }
+    h->iniciado = true;
+}
+
+int32_t hilos_gramos(const hilos_t *h, int i) {
+    return h->gramos_q8[i] >> 8;
+}
+
+int32_t hilos_max(const hilos_t *h) {
+    int32_t max = INT32_MIN;
+    for (int i = 0; i < h->n; i++) {
+        if (hilos_gramos(h, i) > max) max = hilos_gramos(h, i);
+    }
+    return h->n > 0 ? max : 0;
+}
+
+int32_t hilos_total(const hilos_t *h) {
+    int32_t total = 0;
+    for (int i = 0; i < h->n; i++) {
+        total += hilos_gramos(h, i);
+    }
+    return total;
+}
+
+int hilos_fuera_de_rango(const hilos_t *h, int32_t minimo, int32_t maximo, bool *alta) {
+    // En Q8: truncar a gramos llevaría -0.1 g a -1 g
+    int64_t minimo_q8 = (int64_t)minimo << 8;
+    int64_t maximo_q8 = (int64_t)maximo << 8;
+    for (int i = 0; i < h->n; i++) {
+        int32_t g_q8 = h->gramos_q8[i];
+        bool alto = g_q8 > maximo_q8;
+        if (alto || (minimo > 0 && g_q8 < minimo_q8)) {
+            if (alta) *alta = alto;
+            return i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file hilos.h
+ * @brief Tensión de varios hilos bobinados en paralelo (bifilar, multifilar).
+ *
+ * Cada hilo tiene su celda de carga (ver hx711_pio.h). El módulo quita la tara, escala y
+ * filtra cada canal con un promedio exponencial corto: la respuesta debe ser rápida porque
+ * un hilo que se suelta o se engancha tiene que parar el bobinado de todos. Los límites de
+ * tensión del material se aplican a cada hilo por separado; la tensión del haz es la suma.
+ *
+ * Todas las tensiones se expresan en gramos-fuerza (g).
+ */
+
+#ifndef HILOS_H
+#define HILOS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HILOS_MAX 4 ///< Hilos máximos en paralelo.
+
+/**
+ * @brief Estado de la medida de los hilos.
+ */
+typedef struct {
+    uint8_t n;                     ///< Hilos en paralelo.
+    int32_t cuentas_por_g;         ///< Escala de las celdas (con signo).
+    int32_t tara[HILOS_MAX];       ///< Lectura cruda sin carga de cada celda.
+    int32_t gramos_q8[HILOS_MAX];  ///< Tensión filtrada de cada hilo (g, Q8).
+    bool iniciado;                 ///< Ya se procesó la primera lectura.
+} hilos_t;
+
+/**
+ * @brief Prepara la medida con la tara a cero.
+ *
+ * @param h Estado.
+ * @param n Hilos en paralelo (se limita a `HILOS_MAX`).
+ * @param cuentas_por_g Escala de las celdas: cuentas del HX711 por gramo.
+ */
+void hilos_iniciar(hilos_t *h, uint8_t n, int32_t cuentas_por_g);
+
+/**
+ * @brief Fija la tara de cada celda con la suma de varias lecturas sin carga.
+ *
+ * @param h Estado.
+ * @param suma Suma de las lecturas crudas de cada hilo.
+ * @param muestras Lecturas sumadas (mayor que 0).
+ */
+void hilos_tarar(hilos_t *h, const int64_t *suma, uint32_t muestras);
+
+/**
+ * @brief Procesa una lectura simultánea de todas las celdas.
+ *
+ * @param h Estado.
+ * @param crudas Lectura cruda de cada hilo.
+ */
+void hilos_actualizar(hilos_t *h, const int32_t *crudas);
+
+/**
+ * @brief Tensión filtrada de un hilo en gramos.
+ */
+int32_t hilos_gramos(const hilos_t *h, int i);
+
+/**
+ * @brief Tensión del hilo más tenso en gramos.
+ */
+int32_t hilos_max(const hilos_t *h);
+
+/**
+ * @brief Tensión total del haz en gramos.
+ */
+int32_t hilos_total(const hilos_t *h);
+
+/**
+ * @brief Busca un hilo fuera de los límites de tensión.
+ *
+ * @param h Estado.
+ * @param minimo Tensión mínima admisible de cada hilo (0 o menos = sin mínimo).
+ * @param maximo Tensión máxima admisible de cada hilo.
+ * @param alta Si no es nulo, recibe `true` si el hilo encontrado supera el máximo.
+ * @return Índice del primer hilo fuera de límites, o -1.
+ */
+int hilos_fuera_de_rango(const hilos_t *h, int32_t minimo, int32_t maximo, bool *alta);
+
+#endif // HILOS_H
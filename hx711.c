@@ -0,0 +1,52 @@
+/**
+ * @file hx711.c
+ * @brief Implementación de la lectura del HX711 por GPIO.
+ *
+ * La lectura se hace con las interrupciones deshabilitadas: si PD_SCK queda en alto más
+ * de 60 us el HX711 entra en bajo consumo y la conversión se pierde.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "hx711.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+#define HX711_PULSOS_GANANCIA 1 ///< Pulsos extra tras los 24 bits: 1 = canal A, ganancia 128.
+
+static unsigned int pin_dt_hx;  ///< Pin de datos.
+static unsigned int pin_sck_hx; ///< Pin de reloj.
+
+void hx711_iniciar(unsigned int pin_dt, unsigned int pin_sck) {
+    pin_dt_hx = pin_dt;
+    pin_sck_hx = pin_sck;
+    gpio_init(pin_dt);
+    gpio_set_dir(pin_dt, GPIO_IN);
+    gpio_pull_up(pin_dt); // Sin HX711 conectado la línea queda en alto: nunca "listo"
+    gpio_init(pin_sck);
+    gpio_set_dir(pin_sck, GPIO_OUT);
+    gpio_put(pin_sck, 0);
+}
+
+bool hx711_listo(void) {
+    return !gpio_get(pin_dt_hx);
+}
+
+int32_t hx711_leer(void) {
+    uint32_t valor = 0;
+    uint32_t estado = save_and_disable_interrupts();
+    for (int i = 0; i < 24 + HX711_PULSOS_GANANCIA; i++) {
+        gpio_put(pin_sck_hx, 1);
+        busy_wait_us_32(1);
+        if (i < 24) {
+            valor = (valor << 1) | gpio_get(pin_dt_hx);
+        }
+        gpio_put(pin_sck_hx, 0);
+        busy_wait_us_32(1);
+    }
+    restore_interrupts(estado);
+
+    // Extensión de signo del complemento a dos de 24 bits
+    return (int32_t)(valor << 8) >> 8;
+}
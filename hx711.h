@@ -0,0 +1,38 @@
+/**
+ * @file hx711.h
+ * @brief Lectura no bloqueante del conversor HX711 de la celda de carga.
+ *
+ * El HX711 indica que tiene una conversión lista bajando su línea DT. `hx711_listo()`
+ * solo consulta ese nivel, de modo que el bucle de control nunca espera al conversor;
+ * la lectura de los 24 bits tarda unos 30 us. Para una respuesta rápida de la tensión
+ * el pin RATE del HX711 debe estar en alto (80 muestras/s).
+ */
+
+#ifndef HX711_H
+#define HX711_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Configura los pines del HX711 (canal A, ganancia 128).
+ *
+ * @param pin_dt Pin GPIO de datos (DT/DOUT).
+ * @param pin_sck Pin GPIO de reloj (PD_SCK).
+ */
+void hx711_iniciar(unsigned int pin_dt, unsigned int pin_sck);
+
+/**
+ * @brief Indica si hay una conversión lista para leer.
+ */
+bool hx711_listo(void);
+
+/**
+ * @brief Lee la conversión lista.
+ *
+ * Solo debe llamarse si `hx711_listo()` devolvió `true`.
+ * @return Lectura con signo de 24 bits extendida a 32 bits.
+ */
+int32_t hx711_leer(void);
+
+#endif // HX711_H
@@ -0,0 +1,68 @@
+/**
+ * @file hx711_pio.c
+ * @brief Implementación de la lectura de varios HX711 por PIO.
+ *
+ * La lectura llega como una ristra de 96 bits (24 muestras de 4 pines) en 3 palabras;
+ * el bit `c` de cada grupo de 4 es el bit del canal `c`, del más significativo al menos.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "hx711_pio.h"
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hx711_pio.pio.h"
+
+#define HX711_PIO_FREQ_SM 1000000 ///< Reloj de la máquina de estados: 1 us por ciclo.
+#define HX711_PIO_PALABRAS 3      ///< Palabras de la FIFO por lectura (24 x 4 bits).
+
+static PIO hx_pio;           ///< Bloque PIO utilizado.
+static uint hx_sm;           ///< Máquina de estados asignada.
+static uint hx_pin_dt;       ///< Pin DT del primer conversor.
+static bool leyendo = false; ///< Hay una lectura en curso en la PIO.
+
+void hx711_pio_iniciar(PIO pio, uint pin_dt, uint pin_sck) {
+    hx_pio = pio;
+    hx_pin_dt = pin_dt;
+    for (uint i = 0; i < HX711_PIO_CANALES_MAX; i++) {
+        gpio_init(pin_dt + i);
+        gpio_set_dir(pin_dt + i, GPIO_IN);
+        gpio_pull_up(pin_dt + i); // Sin HX711 conectado la línea queda en alto: nunca "listo"
+    }
+
+    hx_sm = (uint)pio_claim_unused_sm(pio, true);
+    uint offset = pio_add_program(pio, &hx711_pio_program);
+    float div = (float)clock_get_hz(clk_sys) / HX711_PIO_FREQ_SM;
+    hx711_pio_program_init(pio, hx_sm, offset, pin_dt, pin_sck, div);
+    pio_sm_set_enabled(pio, hx_sm, true);
+}
+
+bool hx711_pio_sondear(int32_t *lecturas, uint n) {
+    if (!leyendo) {
+        uint32_t mascara = ((1u << n) - 1) << hx_pin_dt;
+        if (gpio_get_all() & mascara) return false; // Algún conversor aún no tiene dato
+        pio_sm_put(hx_pio, hx_sm, 0);               // La PIO genera el reloj
+        leyendo = true;
+        return false;
+    }
+    if (pio_sm_get_rx_fifo_level(hx_pio, hx_sm) < HX711_PIO_PALABRAS) return false;
+
+    uint32_t datos[HX711_PIO_PALABRAS];
+    for (int i = 0; i < HX711_PIO_PALABRAS; i++) {
+        datos[i] = pio_sm_get(hx_pio, hx_sm);
+    }
+    leyendo = false;
+
+    uint32_t valores[HX711_PIO_CANALES_MAX] = { 0 };
+    for (int k = 0; k < 24; k++) {
+        uint32_t grupo = (datos[k / 8] >> (28 - 4 * (k % 8))) & 0xF;
+        for (uint c = 0; c < n; c++) {
+            valores[c] = (valores[c] << 1) | ((grupo >> c) & 1);
+        }
+    }
+    for (uint c = 0; c < n; c++) {
+        lecturas[c] = (int32_t)(valores[c] << 8) >> 8; // Extensión de signo de 24 bits
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file hx711_pio.h
+ * @brief Lectura por PIO de varios HX711 a la vez (una celda de carga por hilo).
+ *
+ * Para bobinar varios hilos en paralelo cada hilo pasa por su propia celda. Los HX711
+ * comparten el reloj PD_SCK y tienen sus líneas DT en pines consecutivos; una máquina de
+ * estados genera el reloj y muestrea todas las líneas en el mismo instante, así las
+ * tensiones de todos los hilos corresponden a la misma muestra y la lectura no deshabilita
+ * interrupciones como `hx711_leer()`. Compartir el reloj sincroniza además las
+ * conversiones: tras cada lectura todos empiezan la siguiente a la vez.
+ */
+
+#ifndef HX711_PIO_H
+#define HX711_PIO_H
+
+#include "hardware/pio.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HX711_PIO_CANALES_MAX 4 ///< Conversores máximos (pines DT consecutivos).
+
+/**
+ * @brief Inicializa los pines y la máquina de estados.
+ *
+ * @param pio Bloque PIO a utilizar.
+ * @param pin_dt Pin DT del primer conversor; los demás le siguen.
+ * @param pin_sck Pin PD_SCK común.
+ */
+void hx711_pio_iniciar(PIO pio, uint pin_dt, uint pin_sck);
+
+/**
+ * @brief Avanza la lectura sin bloquear.
+ *
+ * Si todos los canales tienen una conversión lista ordena la lectura a la PIO; en una
+ * llamada posterior, terminada la lectura, entrega los valores.
+ * @param lecturas Recibe la lectura con signo de cada canal.
+ * @param n Canales en uso (1 .. `HX711_PIO_CANALES_MAX`).
+ * @return `true` si `lecturas` tiene una lectura nueva de todos los canales.
+ */
+bool hx711_pio_sondear(int32_t *lecturas, uint n);
+
+#endif // HX711_PIO_H
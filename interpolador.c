@@ -0,0 +1,124 @@
+/**
+ * @file interpolador.c
+ * @brief Configuración de los interpoladores y banco de pruebas frente a C puro.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "interpolador.h"
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+#include "font5x7.h"
+#include <stdio.h>
+
+#define BENCH_ITERACIONES 10000 ///< Iteraciones por medida del banco de pruebas.
+
+void interp_lerp_config(uint32_t base, uint32_t pendiente, uint desplazamiento) {
+    (void)pendiente; // La pendiente la aplica la CPU en interp_lerp()
+    interp_config cfg = interp_default_config();
+    interp_config_set_shift(&cfg, desplazamiento);
+    interp_config_set_mask(&cfg, 0, 31 - desplazamiento);
+    interp_set_config(interp0, 0, &cfg);
+    interp0->base[0] = base;
+}
+
+void interp_blit_config(void) {
+    interp_config cfg = interp_default_config(); // Sin desplazamiento, máscara completa
+    interp_set_config(interp0, 1, &cfg);
+    interp0->base[1] = 1;
+}
+
+void interp_engranaje_config(int32_t num, int32_t den) {
+    // Carril 0: ACCUM0 += incremento Q16 en cada POP
+    interp_config cfg = interp_default_config();
+    interp_set_config(interp1, 0, &cfg);
+    interp1->base[0] = (uint32_t)(((int64_t)num << 16) / den);
+
+    // Carril 1: lee ACCUM0 y entrega su parte entera (16 bits)
+    cfg = interp_default_config();
+    interp_config_set_cross_input(&cfg, true);
+    interp_config_set_shift(&cfg, 16);
+    interp_config_set_mask(&cfg, 0, 15);
+    interp_set_config(interp1, 1, &cfg);
+    interp1->base[1] = 0;
+
+    interp_engranaje_reiniciar();
+}
+
+/**
+ * @brief Versión anterior del dibujo de glifos: un `ssd1306_draw_pixel()` por píxel.
+ */
+static void glifo_por_pixel(uint8_t x, uint8_t y, char c) {
+    for (uint8_t i = 0; i < 5; i++) {
+        uint8_t line = font5x7[c - 32][i];
+        for (uint8_t j = 0; j < 8; j++) {
+            ssd1306_draw_pixel(x + i, y + j, line & 0x01);
+            line >>= 1;
+        }
+    }
+}
+
+/**
+ * @brief Imprime el tiempo por iteración de una medida.
+ */
+static void bench_reportar(const char *nombre, uint32_t t_c, uint32_t t_interp) {
+    printf("%-10s C: %4lu ns  interp: %4lu ns\n", nombre,
+           (unsigned long)(t_c * 1000ull / BENCH_ITERACIONES),
+           (unsigned long)(t_interp * 1000ull / BENCH_ITERACIONES));
+}
+
+void interpolador_benchmark(void) {
+    volatile int32_t sumidero = 0; // Evita que el compilador elimine los bucles
+    uint32_t t0, t_c, t_interp;
+
+    // Engranaje electrónico: 2000 mgrad por vuelta de 100 pulsos
+    int32_t num = 2000, den = 100, resto = 0;
+    t0 = time_us_32();
+    for (int i = 0; i < BENCH_ITERACIONES; i++) {
+        resto += num;
+        int32_t avance = resto / den;
+        resto -= avance * den;
+        sumidero += avance;
+    }
+    t_c = time_us_32() - t0;
+    interp_engranaje_config(num, den);
+    t0 = time_us_32();
+    for (int i = 0; i < BENCH_ITERACIONES; i++) {
+        sumidero += interp_engranaje_pulso();
+    }
+    t_interp = time_us_32() - t0;
+    bench_reportar("engranaje", t_c, t_interp);
+
+    // Lerp de ángulo a cuentas PWM del servo
+    const uint32_t pendiente = (1953u << 20) / 180000; // Cuentas por mgrad en Q20
+    t0 = time_us_32();
+    for (int i = 0; i < BENCH_ITERACIONES; i++) {
+        sumidero += 1953 + ((i * 18) * (3906 - 1953)) / 180000;
+    }
+    t_c = time_us_32() - t0;
+    interp_lerp_config(1953, pendiente, 20);
+    t0 = time_us_32();
+    for (int i = 0; i < BENCH_ITERACIONES; i++) {
+        sumidero += interp_lerp((uint32_t)(i * 18), pendiente);
+    }
+    t_interp = time_us_32() - t0;
+    bench_reportar("lerp", t_c, t_interp);
+
+    // Dibujo de glifos
+    interp_blit_config();
+    t0 = time_us_32();
+    for (int i = 0; i < BENCH_ITERACIONES; i++) {
+        glifo_por_pixel((uint8_t)(i % 120), (uint8_t)(i % 56), 'A' + i % 26);
+    }
+    t_c = time_us_32() - t0;
+    t0 = time_us_32();
+    for (int i = 0; i < BENCH_ITERACIONES; i++) {
+        ssd1306_draw_char((uint8_t)(i % 120), (uint8_t)(i % 56), 'A' + i % 26);
+    }
+    t_interp = time_us_32() - t0;
+    bench_reportar("glifo", t_c, t_interp);
+
+    ssd1306_clear();
+    (void)sumidero;
+}
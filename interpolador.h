@@ -0,0 +1,98 @@
+/**
+ * @file interpolador.h
+ * @brief Uso de los interpoladores por hardware del RP2040 en los bucles críticos.
+ *
+ * Reparto de los interpoladores del núcleo 0:
+ * - interp0, carril 0: interpolación lineal (lerp) base + (x · pendiente) >> desplazamiento,
+ *   usada para convertir la posición del servo en cuentas o nanosegundos.
+ * - interp0, carril 1: acumulador +1 para recorrer direcciones del búfer al dibujar glifos.
+ * - interp1, carriles 0 y 1: acumulador Q16 del engranaje electrónico del traslado; el
+ *   carril 1 lee el acumulador del carril 0 y entrega su parte entera.
+ *
+ * Los interpoladores son propios de cada núcleo y no se guardan en las interrupciones,
+ * por lo que estas funciones solo deben llamarse desde el código principal del núcleo 0.
+ */
+
+#ifndef INTERPOLADOR_H
+#define INTERPOLADOR_H
+
+#include "hardware/interp.h"
+#include <stdint.h>
+
+/**
+ * @brief Configura interp0 carril 0 para la interpolación lineal.
+ *
+ * @param base Valor para x = 0.
+ * @param pendiente Pendiente en punto fijo con `desplazamiento` bits fraccionarios.
+ * @param desplazamiento Bits fraccionarios de la pendiente.
+ */
+void interp_lerp_config(uint32_t base, uint32_t pendiente, uint desplazamiento);
+
+/**
+ * @brief Evalúa base + (x · pendiente) >> desplazamiento en interp0 carril 0.
+ *
+ * El producto lo hace el multiplicador de un ciclo del M0+; el interpolador aplica
+ * desplazamiento, máscara y suma de la base en la misma lectura.
+ * @param x Valor de entrada (no negativo).
+ * @param pendiente La misma pendiente pasada a `interp_lerp_config()`.
+ */
+static inline uint32_t interp_lerp(uint32_t x, uint32_t pendiente) {
+    interp0->accum[0] = x * pendiente;
+    return interp0->peek[0];
+}
+
+/**
+ * @brief Configura interp0 carril 1 como contador de direcciones (+1 por lectura).
+ */
+void interp_blit_config(void);
+
+/**
+ * @brief Fija el índice que devolverá la próxima llamada a `interp_blit_siguiente()`.
+ */
+static inline void interp_blit_inicio(uint32_t indice) {
+    interp0->accum[1] = indice - 1;
+}
+
+/**
+ * @brief Devuelve el índice actual y avanza al siguiente.
+ */
+static inline uint32_t interp_blit_siguiente(void) {
+    return interp0->pop[1];
+}
+
+/**
+ * @brief Configura interp1 como engranaje electrónico.
+ *
+ * @param num Avance por vuelta (p. ej. miligrados de traslado).
+ * @param den Pulsos del encoder por vuelta.
+ */
+void interp_engranaje_config(int32_t num, int32_t den);
+
+/**
+ * @brief Pone a cero el acumulador del engranaje (inicio de cada pasada del traslado).
+ */
+static inline void interp_engranaje_reiniciar(void) {
+    interp1->accum[0] = 0;
+}
+
+/**
+ * @brief Acumula un pulso y devuelve el avance entero producido por ese pulso.
+ *
+ * Equivale a `resto += num; avance = resto / den; resto -= avance * den;` sin división.
+ */
+static inline int32_t interp_engranaje_pulso(void) {
+    uint32_t antes = interp1->peek[1];
+    (void)interp1->pop[0];
+    return (int32_t)((interp1->peek[1] - antes) & 0xFFFF);
+}
+
+/**
+ * @brief Compara el tiempo de los bucles con interpolador frente a su versión en C.
+ *
+ * Imprime por stdio el tiempo por iteración de cada par (engranaje, lerp y glifo).
+ * Modifica la configuración de los interpoladores y el búfer de la pantalla: debe
+ * llamarse al arrancar, antes de configurar el servo.
+ */
+void interpolador_benchmark(void);
+
+#endif // INTERPOLADOR_H
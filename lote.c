@@ -0,0 +1,34 @@
+/**
+ * @file lote.c
+ * @brief Implementación de la cola de producción.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "lote.h"
+
+void lote_iniciar(lote_t *l, const lote_receta_t *r) {
+    l->receta = *r;
+    l->completas = 0;
+    l->fallidas = 0;
+    l->pulsos = 0;
+}
+
+bool lote_pendiente(const lote_t *l) {
+    return l->completas < l->receta.cantidad;
+}
+
+int32_t lote_valor(const lote_t *l) {
+    int32_t v = l->receta.valor + l->receta.variacion * l->completas;
+    return v < 1 ? 1 : v;
+}
+
+void lote_registrar(lote_t *l, bool completa, int32_t pulsos) {
+    if (completa) {
+        l->completas++;
+    } else {
+        l->fallidas++;
+    }
+    l->pulsos += pulsos;
+}
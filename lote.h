@@ -0,0 +1,67 @@
+/**
+ * @file lote.h
+ * @brief Cola de producción: N bobinas seguidas de la misma receta.
+ *
+ * Un lote guarda el valor de la receta (metros de hilo o milihenrios de cobre), la
+ * cantidad de bobinas y una variación opcional que se suma al valor en cada bobina
+ * completada (series de bobinas escalonadas). Lleva los totales del lote; el programa
+ * principal ejecuta cada bobina como un trabajo normal y pausa entre ellas para retirarla.
+ *
+ * Una bobina que no se completa (falla) no cuenta: la siguiente repite su valor.
+ */
+
+#ifndef LOTE_H
+#define LOTE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Receta de un lote.
+ */
+typedef struct {
+    int32_t valor;     ///< Valor de la primera bobina (metros o mH).
+    int32_t variacion; ///< Cambio del valor en cada bobina siguiente; 0 = todas iguales.
+    uint16_t cantidad; ///< Bobinas a producir.
+} lote_receta_t;
+
+/**
+ * @brief Estado de un lote.
+ */
+typedef struct {
+    lote_receta_t receta; ///< Copia de la receta.
+    uint16_t completas;   ///< Bobinas completadas.
+    uint16_t fallidas;    ///< Bobinas interrumpidas por una falla.
+    int64_t pulsos;       ///< Pulsos del encoder bobinados en todo el lote.
+} lote_t;
+
+/**
+ * @brief Empieza un lote con los totales a cero.
+ *
+ * @param l Lote.
+ * @param r Receta (se copia).
+ */
+void lote_iniciar(lote_t *l, const lote_receta_t *r);
+
+/**
+ * @brief Indica si quedan bobinas por completar.
+ */
+bool lote_pendiente(const lote_t *l);
+
+/**
+ * @brief Valor de la bobina en curso: el de la receta más la variación acumulada.
+ *
+ * @return Valor, nunca menor que 1.
+ */
+int32_t lote_valor(const lote_t *l);
+
+/**
+ * @brief Registra una bobina terminada.
+ *
+ * @param l Lote.
+ * @param completa La bobina alcanzó su objetivo.
+ * @param pulsos Pulsos bobinados en ella.
+ */
+void lote_registrar(lote_t *l, bool completa, int32_t pulsos);
+
+#endif // LOTE_H
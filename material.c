@@ -0,0 +1,51 @@
+/**
+ * @file material.c
+ * @brief Tabla de perfiles de material.
+ *
+ * La tabla vive en RAM: el autoajuste escribe en ella las ganancias de los lazos y el
+ * motor de trabajos el techo de velocidad aprendido. El programa principal guarda esos
+ * valores en el almacén de flash y los restaura al arrancar.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "material.h"
+
+/// Perfiles indexados por `material_t`.
+static material_perfil_t perfiles[MATERIAL_NUM] = {
+    [MATERIAL_HILO] = {
+        .nombre = "Hilo",
+        .tension_max = 3000,
+        .tension_min = 0,             // Sin celda de carga conectada no se vigila el hilo flojo
+        .corriente_max_ma = 2500,     // El hilo se enreda: el atasco se nota pronto
+        .corriente_nominal_ma = 1200,
+        .i2t_limite_a2ms = 5000,      // ~2 s a 2 A
+        .velocidad_techo = 600,       // Punto de partida prudente; se aprende bobinando
+    },
+    [MATERIAL_COBRE] = {
+        .nombre = "Cobre",
+        .tension_max = 3000,
+        .tension_min = 0,
+        .corriente_max_ma = 3000,     // El cobre exige más par al motor
+        .corriente_nominal_ma = 1500,
+        .i2t_limite_a2ms = 8000,      // ~2 s a 2.5 A
+        .velocidad_techo = 500,       // El esmalte se daña antes que el hilo textil
+    },
+};
+
+const material_perfil_t *material_perfil(int material) {
+    if (material < 0 || material >= MATERIAL_NUM) material = MATERIAL_HILO;
+    return &perfiles[material];
+}
+
+void material_guardar_pid_velocidad(int material, const pid_ganancias_t *g, int32_t rpm_por_milesima_q8) {
+    if (material < 0 || material >= MATERIAL_NUM) return;
+    perfiles[material].pid_velocidad = *g;
+    perfiles[material].rpm_por_milesima_q8 = rpm_por_milesima_q8;
+}
+
+void material_guardar_velocidad_techo(int material, uint16_t techo) {
+    if (material < 0 || material >= MATERIAL_NUM) return;
+    perfiles[material].velocidad_techo = techo;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file material.h
+ * @brief Perfiles de material: parámetros de operación que dependen de lo que se bobina.
+ *
+ * Cada material del menú principal (Hilo, Cobre) tiene un perfil con sus límites de
+ * protección. El índice del perfil coincide con `menu_state`.
+ */
+
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include <stdint.h>
+#include "pid.h"
+
+/**
+ * @brief Materiales disponibles, en el orden del menú principal.
+ */
+typedef enum {
+    MATERIAL_HILO = 0,  ///< Hilo textil.
+    MATERIAL_COBRE = 1, ///< Alambre de cobre esmaltado.
+    MATERIAL_NUM
+} material_t;
+
+/**
+ * @brief Parámetros de un material.
+ */
+typedef struct {
+    const char *nombre;            ///< Nombre mostrado en pantalla.
+    int32_t tension_max;           ///< Lectura de tensión que dispara `FALLA_TENSION_ALTA`.
+    int32_t tension_min;           ///< Lectura de tensión que dispara `FALLA_TENSION_BAJA` (0 = desactivada).
+    uint16_t corriente_max_ma;     ///< Corriente de disparo instantáneo (atasco), en mA.
+    uint16_t corriente_nominal_ma; ///< Corriente continua admisible por el modelo I²t, en mA.
+    uint32_t i2t_limite_a2ms;      ///< Exceso de I²t admisible sobre la nominal, en A²·ms.
+    pid_ganancias_t pid_velocidad; ///< Lazo de velocidad (rpm -> PWM); sin ajustar = lazo abierto.
+    int32_t rpm_por_milesima_q8;   ///< Ganancia estática del motor con este material (rpm por milésima de PWM, Q8).
+    uint16_t velocidad_techo;      ///< Velocidad máxima de bobinado aprendida (milésimas del PWM, ver aprendizaje.h).
+} material_perfil_t;
+
+/**
+ * @brief Devuelve el perfil de un material.
+ *
+ * @param material Índice del material (`menu_state`). Valores fuera de rango devuelven Hilo.
+ * @return Puntero al perfil (no nulo).
+ */
+const material_perfil_t *material_perfil(int material);
+
+/**
+ * @brief Guarda el resultado de un autoajuste del lazo de velocidad en el perfil.
+ *
+ * @param material Índice del material. Valores fuera de rango se ignoran.
+ * @param g Ganancias del lazo de velocidad.
+ * @param rpm_por_milesima_q8 Ganancia estática medida del motor.
+ */
+void material_guardar_pid_velocidad(int material, const pid_ganancias_t *g, int32_t rpm_por_milesima_q8);
+
+/**
+ * @brief Guarda el techo de velocidad aprendido en el perfil.
+ *
+ * @param material Índice del material. Valores fuera de rango se ignoran.
+ * @param techo Velocidad máxima de bobinado (milésimas del PWM).
+ */
+void material_guardar_velocidad_techo(int material, uint16_t techo);
+
+#endif // MATERIAL_H
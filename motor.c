@@ -0,0 +1,57 @@
+/**
+ * @file motor.c
+ * @brief Implementación del control de velocidad del motor por PWM.
+ *
+ * La salida de la SIO del pin se deja siempre en 0; encender es seleccionar la función
+ * PWM del pin y cortar es volver a la SIO.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "motor.h"
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+
+static unsigned int pin_motor;           ///< Pin de habilitación del puente H.
+static uint32_t tope;                    ///< Valor de 'wrap' del PWM.
+static volatile uint16_t velocidad_actual = 0; ///< Velocidad comandada (milésimas).
+
+void motor_iniciar(unsigned int pin, uint32_t frecuencia_hz) {
+    pin_motor = pin;
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_OUT);
+    gpio_put(pin, 0);
+
+    // Sin divisor: a 125 MHz y 20 kHz el tope es 6250 (resolución mejor que 0.02 %)
+    uint slice = pwm_gpio_to_slice_num(pin);
+    tope = clock_get_hz(clk_sys) / frecuencia_hz - 1;
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_wrap(&config, tope);
+    pwm_init(slice, &config, true);
+    pwm_set_gpio_level(pin, 0);
+}
+
+void motor_fijar_velocidad(uint16_t velocidad) {
+    if (velocidad > MOTOR_VELOCIDAD_MAX) velocidad = MOTOR_VELOCIDAD_MAX;
+    velocidad_actual = velocidad;
+    pwm_set_gpio_level(pin_motor, (uint16_t)(((tope + 1) * velocidad) / MOTOR_VELOCIDAD_MAX));
+}
+
+void motor_encender(uint16_t velocidad) {
+    motor_fijar_velocidad(velocidad);
+    gpio_set_function(pin_motor, GPIO_FUNC_PWM);
+}
+
+uint16_t motor_velocidad(void) {
+    return velocidad_actual;
+}
+
+bool motor_encendido(void) {
+    return gpio_get_function(pin_motor) == GPIO_FUNC_PWM;
+}
+
+void motor_cortar(void) {
+    gpio_set_function(pin_motor, GPIO_FUNC_SIO);
+}
@@ -0,0 +1,56 @@
+/**
+ * @file motor.h
+ * @brief Control de velocidad del motor del tambor por PWM sobre la habilitación del puente H.
+ *
+ * La velocidad se expresa en milésimas del ciclo de trabajo (0 a 1000). 1000 equivale al
+ * encendido fijo anterior. `motor_cortar()` devuelve el pin a la SIO (salida en 0), lo que
+ * apaga el puente H en el acto sin esperar al fin del periodo PWM; es segura desde una
+ * interrupción y es la que usan las protecciones.
+ */
+
+#ifndef MOTOR_H
+#define MOTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MOTOR_VELOCIDAD_MAX 1000 ///< Ciclo de trabajo máximo (milésimas).
+
+/**
+ * @brief Configura el PWM del motor. El motor queda apagado.
+ *
+ * @param pin Pin de habilitación del puente H.
+ * @param frecuencia_hz Frecuencia del PWM (típicamente 20 kHz, inaudible; mínimo 2 kHz).
+ */
+void motor_iniciar(unsigned int pin, uint32_t frecuencia_hz);
+
+/**
+ * @brief Enciende el motor a la velocidad indicada.
+ *
+ * @param velocidad Ciclo de trabajo en milésimas (se limita a `MOTOR_VELOCIDAD_MAX`).
+ */
+void motor_encender(uint16_t velocidad);
+
+/**
+ * @brief Cambia la velocidad sin cambiar el estado encendido/apagado.
+ *
+ * @param velocidad Ciclo de trabajo en milésimas.
+ */
+void motor_fijar_velocidad(uint16_t velocidad);
+
+/**
+ * @brief Devuelve la velocidad comandada en milésimas.
+ */
+uint16_t motor_velocidad(void);
+
+/**
+ * @brief Indica si el motor está encendido (pin en función PWM).
+ */
+bool motor_encendido(void);
+
+/**
+ * @brief Apaga el motor en el acto. Segura desde interrupciones.
+ */
+void motor_cortar(void);
+
+#endif // MOTOR_H
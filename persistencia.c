@@ -0,0 +1,72 @@
+/**
+ * @file persistencia.c
+ * @brief Implementación del servicio de persistencia diferida.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "persistencia.h"
+#include "pico/stdlib.h"
+#include "almacen.h"
+#include "registro.h"
+
+/**
+ * @brief Registro asociado a una clave.
+ */
+typedef struct {
+    const void *datos; ///< Copia en RAM.
+    uint16_t longitud; ///< Tamaño.
+} fuente_t;
+
+static fuente_t fuentes[ALMACEN_CLAVES_MAX]; ///< Copia en RAM de cada clave registrada.
+static uint32_t marcadas = 0;                ///< Máscara de claves pendientes.
+static uint32_t ultima_marca_us;             ///< Instante de la última marca.
+static uint32_t espera_us = 0;               ///< Espera desde la última marca.
+
+_Static_assert(ALMACEN_CLAVES_MAX <= 32, "la máscara de claves es de 32 bits");
+
+void persistencia_iniciar(uint32_t espera_ms) {
+    espera_us = espera_ms * 1000;
+}
+
+void persistencia_registrar(uint16_t clave, const void *datos, uint16_t longitud) {
+    if (clave == 0 || clave >= ALMACEN_CLAVES_MAX) return;
+    fuentes[clave].datos = datos;
+    fuentes[clave].longitud = longitud;
+}
+
+void persistencia_marcar(uint16_t clave) {
+    if (clave == 0 || clave >= ALMACEN_CLAVES_MAX || !fuentes[clave].datos) return;
+    marcadas |= 1u << clave;
+    ultima_marca_us = time_us_32();
+}
+
+bool persistencia_pendiente(void) {
+    return marcadas != 0;
+}
+
+int persistencia_forzar(void) {
+    int escritos = 0;
+    for (uint16_t clave = 1; clave < ALMACEN_CLAVES_MAX && marcadas; clave++) {
+        if (!(marcadas & (1u << clave))) continue;
+        if (almacen_escribir(clave, fuentes[clave].datos, fuentes[clave].longitud)) {
+            marcadas &= ~(1u << clave);
+            escritos++;
+        } // Si falla sigue marcada y se reintenta en el próximo momento seguro
+    }
+    if (escritos) {
+        REGISTRO(REG_PERSISTENCIA, escritos, almacen_bloqueo_max_us());
+    }
+    return escritos;
+}
+
+int persistencia_sondear(bool seguro) {
+    if (!marcadas || !seguro) return 0;
+    if (time_us_32() - ultima_marca_us < espera_us) return 0; // Puede llegar otro cambio
+    return persistencia_forzar();
+}
+
+uint32_t persistencia_bloqueo_max_us(void) {
+    return almacen_bloqueo_max_us();
+}
@@ -0,0 +1,71 @@
+/**
+ * @file persistencia.h
+ * @brief Servicio de persistencia diferida: agrupa las escrituras en flash y las hace en reposo.
+ *
+ * Programar o borrar la flash detiene el XIP: mientras dura (hasta ~50 ms por sector) no
+ * puede ejecutarse código desde la flash, así que las interrupciones del encoder, la
+ * corriente y la rotura quedarían congeladas. En vez de escribir en el momento, cada
+ * registro se asocia a su copia en RAM (`persistencia_registrar()`) y los cambios solo
+ * se marcan (`persistencia_marcar()`, sin coste). `persistencia_sondear()` escribe de una
+ * vez todas las claves marcadas cuando el llamador indica que es seguro (motor parado y
+ * tambor quieto) y pasaron `espera_ms` desde la última marca.
+ *
+ * La duración de cada escritura se mide: es el peor retardo que ve cualquier interrupción
+ * mientras se guarda (ver `persistencia_bloqueo_max_us()`).
+ */
+
+#ifndef PERSISTENCIA_H
+#define PERSISTENCIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Fija la espera desde la última marca antes de escribir.
+ *
+ * Agrupa cambios seguidos (p. ej. fin de trabajo: contadores y material) en una escritura.
+ * @param espera_ms Espera en milisegundos.
+ */
+void persistencia_iniciar(uint32_t espera_ms);
+
+/**
+ * @brief Asocia una clave del almacén a su copia en RAM.
+ *
+ * @param clave Clave del almacén.
+ * @param datos Copia en RAM (debe vivir todo el programa).
+ * @param longitud Tamaño del registro.
+ */
+void persistencia_registrar(uint16_t clave, const void *datos, uint16_t longitud);
+
+/**
+ * @brief Marca una clave para guardarla en el próximo momento seguro.
+ */
+void persistencia_marcar(uint16_t clave);
+
+/**
+ * @brief Indica si hay claves marcadas sin guardar.
+ */
+bool persistencia_pendiente(void);
+
+/**
+ * @brief Guarda las claves marcadas si es seguro y pasó la espera.
+ *
+ * @param seguro El motor está parado y el tambor quieto.
+ * @return Registros escritos en esta llamada.
+ */
+int persistencia_sondear(bool seguro);
+
+/**
+ * @brief Guarda ya todas las claves marcadas, sin esperar.
+ *
+ * Para cuando el contenido de la RAM está a punto de perderse (apagado).
+ * @return Registros escritos.
+ */
+int persistencia_forzar(void);
+
+/**
+ * @brief Mayor tiempo con las interrupciones bloqueadas por una escritura, en µs.
+ */
+uint32_t persistencia_bloqueo_max_us(void);
+
+#endif // PERSISTENCIA_H
@@ -0,0 +1,42 @@
+/**
+ * @file pid.c
+ * @brief Implementación del PID en punto fijo.
+ *
+ * El término derivativo actúa sobre el error; en los lazos del bobinado la referencia
+ * cambia en rampa, así que no produce golpes.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "pid.h"
+
+void pid_iniciar(pid_lazo_t *pid, const pid_ganancias_t *g, int32_t salida_min, int32_t salida_max) {
+    pid->g = *g;
+    pid->salida_min = salida_min;
+    pid->salida_max = salida_max;
+    pid->integral_q16 = 0;
+    pid->error_anterior = 0;
+}
+
+int32_t pid_actualizar(pid_lazo_t *pid, int32_t error, uint32_t dt_us) {
+    const pid_ganancias_t *g = &pid->g;
+    int64_t p = (int64_t)g->kp_q16 * error;
+    int64_t d = dt_us ? ((int64_t)g->kd_q16 * (error - pid->error_anterior) * 1000000) / dt_us : 0;
+    pid->error_anterior = error;
+
+    int64_t incremento = ((int64_t)g->ki_q16 * error * dt_us) / 1000000;
+    int64_t salida = (p + pid->integral_q16 + incremento + d) >> 16;
+
+    // Anti-windup: solo se integra si no empuja más allá de la saturación
+    if (salida > pid->salida_max) {
+        if (incremento < 0) pid->integral_q16 += incremento;
+        return pid->salida_max;
+    }
+    if (salida < pid->salida_min) {
+        if (incremento > 0) pid->integral_q16 += incremento;
+        return pid->salida_min;
+    }
+    pid->integral_q16 += incremento;
+    return (int32_t)salida;
+}
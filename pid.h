@@ -0,0 +1,67 @@
+/**
+ * @file pid.h
+ * @brief Regulador PID en punto fijo con anti-windup, para los lazos del bobinado.
+ *
+ * Las ganancias van en Q16 y en unidades de la salida por unidad de error:
+ * `kp` (salida/error), `ki` (salida/(error·s)) y `kd` (salida·s/error). Una ganancia
+ * proporcional nula significa "lazo sin ajustar": `pid_ajustado()` devuelve `false`.
+ *
+ * No depende del SDK: tools/autoajuste_simular.c lo usa en el PC para cerrar el lazo sobre
+ * una planta simulada.
+ */
+
+#ifndef PID_H
+#define PID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Ganancias de un PID (Q16).
+ */
+typedef struct {
+    int32_t kp_q16; ///< Ganancia proporcional.
+    int32_t ki_q16; ///< Ganancia integral, por segundo.
+    int32_t kd_q16; ///< Ganancia derivativa, en segundos.
+} pid_ganancias_t;
+
+/**
+ * @brief Estado de un lazo PID.
+ */
+typedef struct {
+    pid_ganancias_t g;      ///< Ganancias activas.
+    int32_t salida_min;     ///< Límite inferior de la salida.
+    int32_t salida_max;     ///< Límite superior de la salida.
+    int64_t integral_q16;   ///< Término integral acumulado (Q16).
+    int32_t error_anterior; ///< Error del paso anterior (término derivativo).
+} pid_lazo_t;
+
+/**
+ * @brief Indica si unas ganancias están ajustadas (kp distinto de 0).
+ */
+static inline bool pid_ajustado(const pid_ganancias_t *g) {
+    return g->kp_q16 != 0;
+}
+
+/**
+ * @brief Inicia un lazo con el integrador a cero.
+ *
+ * @param pid Lazo.
+ * @param g Ganancias (se copian).
+ * @param salida_min Límite inferior de la salida.
+ * @param salida_max Límite superior de la salida.
+ */
+void pid_iniciar(pid_lazo_t *pid, const pid_ganancias_t *g, int32_t salida_min, int32_t salida_max);
+
+/**
+ * @brief Calcula la salida para un nuevo error.
+ *
+ * Con la salida saturada el integrador no acumula en el sentido de la saturación.
+ * @param pid Lazo.
+ * @param error Referencia menos medida.
+ * @param dt_us Tiempo desde el paso anterior.
+ * @return Salida limitada a [salida_min, salida_max].
+ */
+int32_t pid_actualizar(pid_lazo_t *pid, int32_t error, uint32_t dt_us);
+
+#endif // PID_H
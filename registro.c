@@ -0,0 +1,57 @@
+/**
+ * @file registro.c
+ * @brief Implementación de la cola del registro diferido.
+ *
+ * Escriben el bucle principal y las interrupciones: la reserva y copia de una entrada
+ * (seis palabras) se hace con las interrupciones desactivadas, que en un solo núcleo es
+ * más barato que cualquier esquema de reintentos. Lee solo el bucle principal, que no
+ * necesita protegerse: una entrada publicada no se vuelve a escribir hasta sacarla.
+ *
+ * `registro_escribir()` corre desde la RAM para no esperar a la caché de la flash.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "registro.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+static registro_entrada_t cola[REGISTRO_COLA]; ///< Mensajes pendientes.
+static volatile uint32_t escritas = 0; ///< Mensajes puestos en la cola.
+static volatile uint32_t leidas = 0;   ///< Mensajes sacados de la cola.
+static volatile uint32_t perdidos = 0; ///< Mensajes descartados por cola llena.
+
+void __not_in_flash_func(registro_escribir)(uint32_t n, uint16_t id, uint32_t a, uint32_t b,
+                                            uint32_t c, uint32_t d) {
+    uint32_t ahora = time_us_32();
+    uint32_t estado = save_and_disable_interrupts();
+    uint32_t e = escritas;
+    if (e - leidas >= REGISTRO_COLA) {
+        perdidos++;
+    } else {
+        registro_entrada_t *r = &cola[e % REGISTRO_COLA];
+        r->id = id;
+        r->n = (uint8_t)n;
+        r->t_us = ahora;
+        r->args[0] = a;
+        r->args[1] = b;
+        r->args[2] = c;
+        r->args[3] = d;
+        escritas = e + 1;
+    }
+    restore_interrupts(estado);
+}
+
+bool registro_sacar(registro_entrada_t *e) {
+    uint32_t l = leidas;
+    if (l == escritas) return false;
+    *e = cola[l % REGISTRO_COLA];
+    __compiler_memory_barrier(); // Copiada antes de liberar la entrada
+    leidas = l + 1;
+    return true;
+}
+
+uint32_t registro_perdidos(void) {
+    return perdidos;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file registro.h
+ * @brief Registro diferido de mensajes: número de formato y argumentos, sin `printf`.
+ *
+ * `REGISTRO(REG_X, a, b)` guarda el número del mensaje, el instante y hasta 4 argumentos
+ * de 32 bits en una cola circular: unas pocas decenas de ciclos, también en interrupciones
+ * y en los caminos del control, así que los diagnósticos pueden quedar siempre activos. El
+ * texto lo arma el PC con el catálogo de `registro_formatos.h` (ver
+ * `tools/registro_decodificar.c`); la cola se vacía por el USB junto con la telemetría
+ * (`telemetria_atender()`). Con la cola llena se descartan los mensajes nuevos y se cuentan.
+ */
+
+#ifndef REGISTRO_H
+#define REGISTRO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define REGISTRO_COLA 64     ///< Mensajes en la cola (potencia de 2).
+#define REGISTRO_ARGS_MAX 4  ///< Argumentos por mensaje.
+
+#define REGISTRO_FORMATO(nombre, formato) nombre,
+/**
+ * @brief Número de cada mensaje del catálogo.
+ */
+typedef enum {
+#include "registro_formatos.h"
+    REGISTRO_NUM
+} registro_id_t;
+#undef REGISTRO_FORMATO
+
+/**
+ * @brief Mensaje guardado.
+ */
+typedef struct {
+    uint16_t id;                        ///< Mensaje (`registro_id_t`).
+    uint8_t n;                          ///< Argumentos usados.
+    uint8_t reservado;
+    uint32_t t_us;                      ///< Instante (time_us_32).
+    uint32_t args[REGISTRO_ARGS_MAX];   ///< Argumentos.
+} registro_entrada_t;
+
+/**
+ * @brief Registra un mensaje del catálogo con 0 a 4 argumentos enteros.
+ */
+#define REGISTRO(...) registro_escribir(REGISTRO_CUENTA_(__VA_ARGS__, 4, 3, 2, 1, 0, 0), \
+                                        REGISTRO_ARGS_(__VA_ARGS__, 0, 0, 0, 0, 0))
+#define REGISTRO_CUENTA_(id, a, b, c, d, n, ...) (n)
+#define REGISTRO_ARGS_(id, a, b, c, d, ...) (id), (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d)
+
+/**
+ * @brief Pasa un real como argumento (para `%f`, `%e`, `%g`).
+ */
+static inline uint32_t registro_real(float x) {
+    union { float f; uint32_t u; } v = { .f = x };
+    return v.u;
+}
+
+/**
+ * @brief Guarda un mensaje. Usar a través de `REGISTRO()`.
+ */
+void registro_escribir(uint32_t n, uint16_t id, uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+
+/**
+ * @brief Saca el mensaje más antiguo de la cola.
+ *
+ * Un solo consumidor (el bucle principal).
+ * @return `false` si la cola está vacía.
+ */
+bool registro_sacar(registro_entrada_t *e);
+
+/**
+ * @brief Devuelve los mensajes descartados por cola llena desde el arranque.
+ */
+uint32_t registro_perdidos(void);
+
+#endif // REGISTRO_H
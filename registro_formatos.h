@@ -0,0 +1,28 @@
+/**
+ * @file registro_formatos.h
+ * @brief Catálogo de los mensajes del registro diferido.
+ *
+ * Cada línea es `REGISTRO_FORMATO(nombre, "formato")`. El equipo envía solo el número del
+ * mensaje (su posición en esta lista) y los argumentos; el decodificador del PC incluye
+ * este mismo archivo para reconstruir el texto. Los mensajes nuevos van al final para no
+ * cambiar el número de los anteriores.
+ *
+ * Hasta 4 argumentos de 32 bits: `%d %i %u %x %X %o %c` (los modificadores `l`/`ll` se
+ * ignoran) y `%f %e %g` con `registro_real()`. No hay `%s`: el texto no viaja.
+ *
+ * Sin guardas de inclusión: se incluye con distintas definiciones de `REGISTRO_FORMATO`.
+ */
+
+REGISTRO_FORMATO(REG_CONTROL_RETRASO, "control: retraso max %lu us")
+REGISTRO_FORMATO(REG_PERSISTENCIA, "persistencia: %d registros, bloqueo max %lu us")
+REGISTRO_FORMATO(REG_TRABAJO_INICIO, "trabajo: tipo %u, material %u, desde %ld hasta %ld pulsos")
+REGISTRO_FORMATO(REG_TRABAJO_FIN, "trabajo: resultado %u en %ld pulsos, falla %u")
+REGISTRO_FORMATO(REG_SEGMENTO, "trabajo: segmento %d de %d en %ld pulsos, parada %u")
+REGISTRO_FORMATO(REG_PAUSA, "trabajo: pausa %u en %ld pulsos")
+REGISTRO_FORMATO(REG_TELEMETRIA_PERDIDAS, "telemetria: %lu muestras perdidas, registro: %lu perdidos")
+REGISTRO_FORMATO(REG_TRABAJO_ESCALA, "trabajo: %lu pulsos por km, %u pulsos por vuelta")
+REGISTRO_FORMATO(REG_TRAZA_CONGELADA, "traza: congelada con %lu eventos por la falla %u")
+REGISTRO_FORMATO(REG_TRAZA_REPRODUCCION, "traza: reproduciendo %lu eventos")
+REGISTRO_FORMATO(REG_TRAZA_FIN, "traza: fin de la reproduccion en %ld pulsos")
+REGISTRO_FORMATO(REG_RESPALDO_FALLIDO, "respaldo: punto de control final sin guardar en %ld pulsos")
+REGISTRO_FORMATO(REG_TRABAJO_TARA, "trabajo: tara %ld de la celda principal")
@@ -0,0 +1,87 @@
+/**
+ * @file remoto.c
+ * @brief Implementación del analizador de órdenes y de las respuestas.
+ *
+ * Un reintento se reconoce comparando la orden decodificada entera (orden, secuencia y
+ * argumentos) con la última: una orden distinta con la secuencia repetida se ejecuta.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "remoto.h"
+#include <string.h>
+#include "telemetria.h"
+
+/**
+ * @brief Deja el analizador listo para la siguiente trama.
+ */
+static void vaciar_trama(remoto_t *r) {
+    r->largo = 0;
+    r->desbordada = false;
+}
+
+void remoto_iniciar(remoto_t *r) {
+    vaciar_trama(r);
+    r->ultima_largo = 0;
+    r->respuesta_largo = 0;
+}
+
+bool remoto_recibir(remoto_t *r, uint8_t byte, remoto_comando_t *c) {
+    if (byte != 0) {
+        if (r->largo < sizeof(r->trama)) {
+            r->trama[r->largo++] = byte;
+        } else {
+            r->desbordada = true;
+        }
+        return false;
+    }
+
+    // Fin de trama: se decodifica y el analizador queda listo para la siguiente
+    uint8_t datos[sizeof(r->trama)];
+    size_t n = r->desbordada ? 0 : cobs_decodificar(r->trama, r->largo, datos);
+    vaciar_trama(r);
+    if (n < 2) return false; // Ruido o trama vacía: no hay a quién contestar
+
+    c->repetida = n == r->ultima_largo && memcmp(datos, r->ultima, n) == 0;
+    if (!c->repetida) {
+        memcpy(r->ultima, datos, n);
+        r->ultima_largo = (uint8_t)n;
+        r->respuesta_largo = 0;
+    }
+
+    c->orden = datos[0];
+    c->secuencia = datos[1];
+    c->valida = (n - 2) % 4 == 0 && (n - 2) / 4 <= REMOTO_ARGS_MAX;
+    c->n = c->valida ? (uint8_t)((n - 2) / 4) : 0;
+    for (int i = 0; i < c->n; i++) {
+        const uint8_t *p = &datos[2 + 4 * i];
+        c->args[i] = (int32_t)(p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+    }
+    return true;
+}
+
+size_t remoto_respuesta(remoto_t *r, const remoto_comando_t *c, remoto_resultado_t resultado,
+                        const int32_t *valores, int n, uint8_t *datos) {
+    if (n > REMOTO_VALORES_MAX) n = REMOTO_VALORES_MAX;
+    uint8_t *p = datos;
+    *p++ = TELEMETRIA_RESPUESTA;
+    *p++ = c->orden;
+    *p++ = c->secuencia;
+    *p++ = (uint8_t)resultado;
+    for (int i = 0; i < n; i++) {
+        uint32_t v = (uint32_t)valores[i];
+        *p++ = (uint8_t)v;
+        *p++ = (uint8_t)(v >> 8);
+        *p++ = (uint8_t)(v >> 16);
+        *p++ = (uint8_t)(v >> 24);
+    }
+    r->respuesta_largo = (uint8_t)(p - datos);
+    memcpy(r->respuesta, datos, r->respuesta_largo);
+    return r->respuesta_largo;
+}
+
+size_t remoto_repetir(const remoto_t *r, uint8_t *datos) {
+    memcpy(datos, r->respuesta, r->respuesta_largo);
+    return r->respuesta_largo;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file remoto.h
+ * @brief Protocolo binario de órdenes por el USB, para manejar la bobinadora desde un PC.
+ *
+ * Las órdenes llegan por el mismo CDC que la telemetría, en tramas COBS:
+ * `orden u8, secuencia u8` y de 0 a 4 argumentos i32 (little-endian). Cada orden se
+ * contesta con una trama `TELEMETRIA_RESPUESTA`: `orden u8, secuencia u8, resultado u8`
+ * y de 0 a `REMOTO_VALORES_MAX` valores i32. La secuencia la elige el PC y vuelve en la
+ * respuesta: con ella reconoce la respuesta de cada orden y reintenta las que no llegan.
+ * Un reintento (la misma orden con la misma secuencia y los mismos argumentos que la
+ * última) no se vuelve a ejecutar: se repite la respuesta guardada. Así un INICIAR cuya
+ * respuesta se perdió no contesta OCUPADO al reintentarlo. El PC debe cambiar la secuencia
+ * en cada orden nueva, también entre ejecuciones.
+ *
+ * Órdenes (argumentos -> valores de la respuesta):
+ * - `REMOTO_ESTADO` -> máquina (`remoto_maquina_t`), material, falla activa, pulsos,
+ *   objetivo en pulsos, bobinas completas del lote, bobinas del lote, bobinas fallidas.
+ * - `REMOTO_RECETA` material, valor (metros o mH), bobinas del lote, variación por bobina.
+ * - `REMOTO_INICIAR` material, modo (`remoto_modo_t`): solo con la máquina en el menú.
+ * - `REMOTO_PAUSAR`, `REMOTO_SEGUIR`, `REMOTO_ABORTAR`: como SW, SW y SW mantenido.
+ * - `REMOTO_CONTADORES` -> trabajos, completos, fallas, pulsos, muestras de telemetría
+ *   perdidas, mensajes del registro perdidos.
+ * - `REMOTO_TRAZA` acción (`remoto_traza_t`) -> eventos de la traza, congelada, reproducción
+ *   pedida o en curso, tara y pulsos por vuelta de la cabecera (`traza_cabecera_t`). El
+ *   volcado llega en tramas `TELEMETRIA_TRAZA`.
+ * - `REMOTO_CARGAR_TRAZA` posición, t_us, dato -> eventos cargados: un evento de una traza
+ *   (ver traza.h), en orden desde la posición 0. Solo con la máquina en el menú.
+ *
+ * El analizador recibe los bytes de a uno, sin memoria dinámica ni bloqueo.
+ *
+ * El módulo no depende del SDK: lo comparten el equipo y las herramientas del PC.
+ */
+
+#ifndef REMOTO_H
+#define REMOTO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "cobs.h"
+
+#define REMOTO_ARGS_MAX 4    ///< Argumentos por orden.
+#define REMOTO_VALORES_MAX 8 ///< Valores por respuesta.
+#define REMOTO_DATOS_MAX (2 + 4 * REMOTO_ARGS_MAX) ///< Bytes de la orden más larga.
+#define REMOTO_RESPUESTA_MAX (4 + 4 * REMOTO_VALORES_MAX) ///< Bytes de la respuesta más larga (con el tipo).
+
+/**
+ * @brief Órdenes.
+ */
+typedef enum {
+    REMOTO_ESTADO = 1,  ///< Estado de la máquina y del trabajo.
+    REMOTO_RECETA,      ///< Carga la receta de un material.
+    REMOTO_INICIAR,     ///< Empieza un trabajo con la receta guardada.
+    REMOTO_PAUSAR,      ///< Pausa el trabajo en curso.
+    REMOTO_SEGUIR,      ///< Reanuda la pausa o sigue con la próxima bobina del lote.
+    REMOTO_ABORTAR,     ///< Termina el trabajo o el lote.
+    REMOTO_CONTADORES,  ///< Contadores de producción y de diagnóstico.
+    REMOTO_TRAZA,       ///< Vuelca, vuelve a grabar o reproduce la traza de los sensores.
+    REMOTO_CARGAR_TRAZA, ///< Carga un evento de una traza grabada.
+} remoto_orden_t;
+
+/**
+ * @brief Resultado de una orden.
+ */
+typedef enum {
+    REMOTO_OK = 0,       ///< Orden aceptada.
+    REMOTO_DESCONOCIDA,  ///< Orden que el equipo no conoce.
+    REMOTO_ARGUMENTOS,   ///< Faltan argumentos o están fuera de rango.
+    REMOTO_OCUPADO,      ///< La máquina no está en el menú (INICIAR).
+    REMOTO_NO_APLICA,    ///< La orden no tiene sentido en el estado actual.
+} remoto_resultado_t;
+
+/**
+ * @brief Estado de la máquina, visto desde el PC.
+ */
+typedef enum {
+    REMOTO_MENU = 0,    ///< En el menú principal: acepta INICIAR.
+    REMOTO_OCUPADA,     ///< El operario está en otra pantalla (selector, calibración).
+    REMOTO_BOBINANDO,   ///< Trabajo en marcha.
+    REMOTO_PAUSADA,     ///< Trabajo en pausa (del operario, de una toma o de un cambio de hilo).
+    REMOTO_RELEVO,      ///< Entre bobinas de un lote o al final de él: espera SEGUIR.
+} remoto_maquina_t;
+
+/**
+ * @brief Trabajo que arranca `REMOTO_INICIAR`.
+ */
+typedef enum {
+    REMOTO_MODO_BOBINA = 0, ///< Una bobina con el valor de la receta.
+    REMOTO_MODO_LOTE,       ///< Un lote con la receta completa.
+    REMOTO_MODO_SECUENCIA,  ///< La secuencia de segmentos guardada (el material no se usa).
+} remoto_modo_t;
+
+/**
+ * @brief Acción de `REMOTO_TRAZA`.
+ */
+typedef enum {
+    REMOTO_TRAZA_VOLCAR = 0, ///< Congela la traza y la envía.
+    REMOTO_TRAZA_GRABAR,     ///< Vacía la traza y vuelve a grabar.
+    REMOTO_TRAZA_REPRODUCIR, ///< El próximo trabajo toma los sensores de la traza (solo en el menú).
+} remoto_traza_t;
+
+/**
+ * @brief Orden recibida.
+ */
+typedef struct {
+    uint8_t orden;                  ///< `remoto_orden_t`.
+    uint8_t secuencia;              ///< Número elegido por el PC.
+    bool valida;                    ///< `false` si el largo no corresponde a argumentos enteros.
+    bool repetida;                  ///< Reintento de la última orden: ver `remoto_repetir()`.
+    uint8_t n;                      ///< Argumentos recibidos.
+    int32_t args[REMOTO_ARGS_MAX];  ///< Argumentos.
+} remoto_comando_t;
+
+/**
+ * @brief Analizador de órdenes.
+ */
+typedef struct {
+    uint8_t trama[COBS_TRAMA_MAX(REMOTO_DATOS_MAX)]; ///< Bytes recibidos desde el último 0.
+    uint8_t largo;      ///< Bytes en `trama`.
+    bool desbordada;    ///< La trama en curso no cabe: se descarta al llegar su 0.
+    uint8_t ultima[COBS_TRAMA_MAX(REMOTO_DATOS_MAX)]; ///< Última orden recibida (decodificada, cabe como `trama`).
+    uint8_t ultima_largo; ///< Bytes de `ultima` (0 = ninguna).
+    uint8_t respuesta[REMOTO_RESPUESTA_MAX]; ///< Respuesta a la última orden.
+    uint8_t respuesta_largo; ///< Bytes de `respuesta` (0 = aún sin contestar).
+} remoto_t;
+
+/**
+ * @brief Vacía el analizador y olvida la última orden.
+ */
+void remoto_iniciar(remoto_t *r);
+
+/**
+ * @brief Procesa un byte recibido.
+ *
+ * @param r Analizador.
+ * @param byte Byte recibido.
+ * @param c Recibe la orden cuando se completa una trama.
+ * @return `true` si `c` tiene una orden (nueva o `repetida`).
+ */
+bool remoto_recibir(remoto_t *r, uint8_t byte, remoto_comando_t *c);
+
+/**
+ * @brief Arma la respuesta a una orden (antes de COBS) y la guarda para los reintentos.
+ *
+ * @param r Analizador que recibió la orden.
+ * @param c Orden contestada.
+ * @param resultado Resultado.
+ * @param valores Valores de la respuesta (puede ser `NULL` si `n` es 0).
+ * @param n Número de valores (máx. `REMOTO_VALORES_MAX`).
+ * @param datos Destino, de al menos `REMOTO_RESPUESTA_MAX` bytes.
+ * @return Bytes escritos.
+ */
+size_t remoto_respuesta(remoto_t *r, const remoto_comando_t *c, remoto_resultado_t resultado,
+                        const int32_t *valores, int n, uint8_t *datos);
+
+/**
+ * @brief Copia la respuesta guardada de la última orden, para contestar un reintento.
+ *
+ * @param r Analizador.
+ * @param datos Destino, de al menos `REMOTO_RESPUESTA_MAX` bytes.
+ * @return Bytes escritos (0 si la última orden aún no tiene respuesta).
+ */
+size_t remoto_repetir(const remoto_t *r, uint8_t *datos);
+
+#endif // REMOTO_H
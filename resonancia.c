@@ -0,0 +1,135 @@
+/**
+ * @file resonancia.c
+ * @brief Implementación de la captura, el análisis FFT y el mapa de bandas resonantes.
+ *
+ * La captura la llena la interrupción del ADC (callback del canal de tensión); el análisis
+ * se hace en el bucle principal sobre la captura completa. Con 256 puntos la FFT entera
+ * son 1024 mariposas.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "resonancia.h"
+#include <stddef.h>
+#include "analogico.h"
+#include "fft.h"
+
+#define RESONANCIA_ENERGIA_MIN 1024 ///< Energía mínima para considerar resonancia (sobre el ruido del ADC).
+
+static uint16_t captura[RESONANCIA_N];       ///< Muestras crudas del canal de tensión.
+static volatile uint32_t capturadas = RESONANCIA_N; ///< Muestras ya capturadas (N = captura lista).
+static int16_t re[RESONANCIA_N];             ///< Parte real de trabajo de la FFT.
+static int16_t im[RESONANCIA_N];             ///< Parte imaginaria de trabajo de la FFT.
+
+static resonancia_banda_t bandas[RESONANCIA_MAX_BANDAS]; ///< Bandas prohibidas.
+static int num_bandas = 0;                   ///< Bandas guardadas.
+
+/**
+ * @brief Guarda cada nuevo valor del canal de tensión mientras hay una captura en curso.
+ */
+static void resonancia_muestra(uint16_t valor) {
+    uint32_t i = capturadas;
+    if (i < RESONANCIA_N) {
+        captura[i] = valor;
+        capturadas = i + 1;
+    }
+}
+
+void resonancia_iniciar(void) {
+    fft_iniciar();
+    analog_set_callback(ANALOG_TENSION, resonancia_muestra);
+}
+
+void resonancia_capturar(void) {
+    capturadas = 0;
+}
+
+bool resonancia_captura_lista(void) {
+    return capturadas >= RESONANCIA_N;
+}
+
+uint32_t resonancia_analizar(uint32_t *frecuencia_hz) {
+    // Se quita la continua y se pasa a Q15 (16 bits de `analog_valores` -> 15 bits con
+    // signo): una oscilación de toda la escala del ADC cabe sin recortarse
+    uint32_t suma = 0;
+    for (uint32_t i = 0; i < RESONANCIA_N; i++) suma += captura[i];
+    int32_t media = (int32_t)(suma / RESONANCIA_N);
+    for (uint32_t i = 0; i < RESONANCIA_N; i++) {
+        re[i] = (int16_t)(((int32_t)captura[i] - media) >> 1); // |v| < 65536: cabe en Q15
+        im[i] = 0;
+    }
+    fft_ventana_hann(re, RESONANCIA_LOG2_N);
+    fft_q15(re, im, RESONANCIA_LOG2_N);
+
+    // Energía y pico de la mitad positiva del espectro, sin el bin de continua
+    uint64_t energia = 0;
+    uint32_t pico = 0, k_pico = 0;
+    for (uint32_t k = 1; k < RESONANCIA_N / 2; k++) {
+        uint32_t p = fft_potencia(re[k], im[k]);
+        energia += p;
+        if (p > pico) {
+            pico = p;
+            k_pico = k;
+        }
+    }
+    if (frecuencia_hz) {
+        *frecuencia_hz = (k_pico * 1000000u) / (RESONANCIA_N * analog_periodo_us(ANALOG_TENSION));
+    }
+    return energia > UINT32_MAX ? UINT32_MAX : (uint32_t)energia;
+}
+
+int resonancia_detectar(const uint16_t *velocidades, const uint32_t *energias, int n) {
+    if (n > RESONANCIA_MAX_ESCALONES) n = RESONANCIA_MAX_ESCALONES;
+    num_bandas = 0;
+    if (n < 3) return 0;
+
+    // Mediana de las energías (ordenación por inserción de una copia)
+    uint32_t orden[RESONANCIA_MAX_ESCALONES];
+    for (int i = 0; i < n; i++) {
+        uint32_t e = energias[i];
+        int j = i;
+        for (; j > 0 && orden[j - 1] > e; j--) orden[j] = orden[j - 1];
+        orden[j] = e;
+    }
+    uint64_t umbral = (uint64_t)orden[n / 2] * RESONANCIA_FACTOR;
+    if (umbral < RESONANCIA_ENERGIA_MIN) umbral = RESONANCIA_ENERGIA_MIN;
+
+    // Escalones contiguos sobre el umbral forman una banda de medio paso a cada lado
+    uint16_t medio_paso = (uint16_t)((velocidades[1] - velocidades[0]) / 2);
+    for (int i = 0; i < n && num_bandas < RESONANCIA_MAX_BANDAS; i++) {
+        if (energias[i] <= umbral) continue;
+        int fin = i;
+        while (fin + 1 < n && energias[fin + 1] > umbral) fin++;
+        resonancia_banda_t *b = &bandas[num_bandas++];
+        b->desde = velocidades[i] > medio_paso ? velocidades[i] - medio_paso : 0;
+        b->hasta = velocidades[fin] + medio_paso;
+        i = fin;
+    }
+    return num_bandas;
+}
+
+void resonancia_restaurar(const resonancia_banda_t *b, int n) {
+    if (n < 0) n = 0;
+    if (n > RESONANCIA_MAX_BANDAS) n = RESONANCIA_MAX_BANDAS;
+    for (int i = 0; i < n; i++) {
+        bandas[i] = b[i];
+    }
+    num_bandas = n;
+}
+
+void resonancia_borrar(void) {
+    num_bandas = 0;
+}
+
+const resonancia_banda_t *resonancia_banda(uint16_t velocidad) {
+    for (int i = 0; i < num_bandas; i++) {
+        if (velocidad >= bandas[i].desde && velocidad <= bandas[i].hasta) return &bandas[i];
+    }
+    return NULL;
+}
+
+const resonancia_banda_t *resonancia_bandas(int *n) {
+    *n = num_bandas;
+    return bandas;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file resonancia.h
+ * @brief Mapa de bandas de velocidad resonantes, medido con la FFT durante un barrido.
+ *
+ * A ciertas velocidades la máquina resuena, la tensión oscila y salta la protección. Durante
+ * la calibración el tambor recorre su rango de velocidades; en cada escalón se capturan
+ * `RESONANCIA_N` muestras del canal analógico de tensión (1 kS/s; el HX711 a 80 muestras/s
+ * no alcanza la frecuencia de giro), se aplica ventana de Hann y FFT, y se guarda la energía
+ * de la oscilación y su frecuencia dominante. Los escalones cuya energía supera
+ * `RESONANCIA_FACTOR` veces la mediana forman las bandas prohibidas, que el planificador de
+ * velocidad cruza con rampa rápida y en las que nunca se detiene.
+ *
+ * Las velocidades se expresan en milésimas del PWM del motor (ver motor.h).
+ */
+
+#ifndef RESONANCIA_H
+#define RESONANCIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define RESONANCIA_LOG2_N 8                    ///< log2 de las muestras por medición.
+#define RESONANCIA_N (1u << RESONANCIA_LOG2_N) ///< Muestras por medición (256 ms a 1 kS/s).
+#define RESONANCIA_MAX_BANDAS 4                ///< Bandas prohibidas guardadas.
+#define RESONANCIA_MAX_ESCALONES 32            ///< Escalones máximos de un barrido.
+#define RESONANCIA_FACTOR 4                    ///< Energía, en veces la mediana, que marca una resonancia.
+
+/**
+ * @brief Banda de velocidades prohibida [desde, hasta].
+ */
+typedef struct {
+    uint16_t desde; ///< Velocidad inferior de la banda.
+    uint16_t hasta; ///< Velocidad superior de la banda.
+} resonancia_banda_t;
+
+/**
+ * @brief Inicia la FFT y engancha la captura al canal analógico de tensión.
+ *
+ * Debe llamarse después de `analog_iniciar()`.
+ */
+void resonancia_iniciar(void);
+
+/**
+ * @brief Comienza a capturar `RESONANCIA_N` muestras.
+ */
+void resonancia_capturar(void);
+
+/**
+ * @brief Indica si la captura en curso terminó.
+ */
+bool resonancia_captura_lista(void);
+
+/**
+ * @brief Analiza la captura terminada.
+ *
+ * @param frecuencia_hz Si no es nulo, recibe la frecuencia dominante de la oscilación.
+ * @return Energía de la oscilación (suma de potencias de los bins sin continua).
+ */
+uint32_t resonancia_analizar(uint32_t *frecuencia_hz);
+
+/**
+ * @brief Calcula y guarda las bandas prohibidas a partir de un barrido.
+ *
+ * Reemplaza las bandas anteriores.
+ * @param velocidades Velocidad de cada escalón, en orden creciente y paso constante.
+ * @param energias Energía medida en cada escalón.
+ * @param n Número de escalones (hasta `RESONANCIA_MAX_ESCALONES`).
+ * @return Número de bandas guardadas.
+ */
+int resonancia_detectar(const uint16_t *velocidades, const uint32_t *energias, int n);
+
+/**
+ * @brief Restaura bandas guardadas (p. ej. leídas de la flash al arrancar).
+ *
+ * @param b Bandas, en orden creciente.
+ * @param n Número de bandas (se limita a `RESONANCIA_MAX_BANDAS`).
+ */
+void resonancia_restaurar(const resonancia_banda_t *b, int n);
+
+/**
+ * @brief Borra las bandas (necesario antes de un barrido, para no saltarlas).
+ */
+void resonancia_borrar(void);
+
+/**
+ * @brief Devuelve la banda que contiene una velocidad, o `NULL`.
+ */
+const resonancia_banda_t *resonancia_banda(uint16_t velocidad);
+
+/**
+ * @brief Devuelve las bandas guardadas.
+ *
+ * @param n Recibe el número de bandas.
+ */
+const resonancia_banda_t *resonancia_bandas(int *n);
+
+#endif // RESONANCIA_H
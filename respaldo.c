@@ -0,0 +1,170 @@
+/**
+ * @file respaldo.c
+ * @brief Implementación del punto de control en flash.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "respaldo.h"
+#include <stddef.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "almacen.h"
+
+#define RESPALDO_MAGICO 0x50435245u ///< "ERCP": página de punto de control.
+#define RESPALDO_SECTORES 2
+#define PAGINAS_POR_SECTOR ((int)(FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE))
+#define RESPALDO_OFFSET (PICO_FLASH_SIZE_BYTES - (ALMACEN_SECTORES + RESPALDO_SECTORES) * FLASH_SECTOR_SIZE)
+
+/**
+ * @brief Formato de una página.
+ */
+typedef struct {
+    uint32_t magico;                  ///< `RESPALDO_MAGICO`.
+    uint32_t secuencia;               ///< Orden de escritura (creciente).
+    uint16_t longitud;                ///< Bytes válidos; 0 = punto de control anulado.
+    uint16_t reservado;
+    uint8_t datos[RESPALDO_DATOS_MAX]; ///< Datos.
+    uint32_t crc;                     ///< CRC-32 de la cabecera y los datos válidos.
+} pagina_t;
+
+_Static_assert(sizeof(pagina_t) == FLASH_PAGE_SIZE, "un punto de control ocupa una página");
+
+static int sector_activo = 0;   ///< Sector donde se escribe.
+static int siguiente = PAGINAS_POR_SECTOR; ///< Próxima página libre del sector activo.
+static uint32_t secuencia = 1;  ///< Secuencia del próximo punto de control.
+static int ultima = -1;         ///< Página (absoluta) del último registro válido, o -1.
+static pagina_t buffer;         ///< Página en RAM para programar.
+
+static const pagina_t *pagina(int n) {
+    return (const pagina_t *)(XIP_BASE + RESPALDO_OFFSET + (uint32_t)n * FLASH_PAGE_SIZE);
+}
+
+static uint32_t crc_pagina(const pagina_t *p) {
+    return almacen_crc32(p, offsetof(pagina_t, datos) + p->longitud);
+}
+
+static bool valida(const pagina_t *p) {
+    return p->magico == RESPALDO_MAGICO && p->longitud <= RESPALDO_DATOS_MAX && p->crc == crc_pagina(p);
+}
+
+static bool en_blanco(int n) {
+    const uint32_t *p = (const uint32_t *)pagina(n);
+    for (uint32_t i = 0; i < FLASH_PAGE_SIZE / 4; i++) {
+        if (p[i] != 0xFFFFFFFFu) return false;
+    }
+    return true;
+}
+
+static void borrar_en_ram(void *param) {
+    flash_range_erase((uint32_t)(uintptr_t)param, FLASH_SECTOR_SIZE);
+}
+
+static void programar_en_ram(void *param) {
+    flash_range_program((uint32_t)(uintptr_t)param, (const uint8_t *)&buffer, FLASH_PAGE_SIZE);
+}
+
+/**
+ * @brief Programa una página en la siguiente posición libre del sector activo.
+ */
+static bool escribir(const void *datos, uint16_t longitud) {
+    int n = sector_activo * PAGINAS_POR_SECTOR + siguiente;
+    while (siguiente < PAGINAS_POR_SECTOR && !en_blanco(n)) { // Página cortada por un apagón
+        siguiente++;
+        n++;
+    }
+    if (siguiente >= PAGINAS_POR_SECTOR) return false;
+
+    memset(&buffer, 0xFF, sizeof(buffer));
+    buffer.magico = RESPALDO_MAGICO;
+    buffer.secuencia = secuencia++;
+    buffer.longitud = longitud;
+    buffer.reservado = 0;
+    if (longitud) memcpy(buffer.datos, datos, longitud);
+    buffer.crc = crc_pagina(&buffer);
+    siguiente++;
+    if (flash_safe_execute(programar_en_ram, (void *)(uintptr_t)(RESPALDO_OFFSET + (uint32_t)n * FLASH_PAGE_SIZE),
+                           ALMACEN_PLAZO_MS) != PICO_OK || !valida(pagina(n))) {
+        return false;
+    }
+    ultima = n;
+    return true;
+}
+
+bool respaldo_iniciar(void) {
+    ultima = -1;
+    uint32_t max_secuencia = 0;
+    for (int n = 0; n < RESPALDO_SECTORES * PAGINAS_POR_SECTOR; n++) {
+        const pagina_t *p = pagina(n);
+        if (valida(p) && p->secuencia >= max_secuencia) {
+            max_secuencia = p->secuencia;
+            ultima = n;
+        }
+    }
+    secuencia = max_secuencia + 1;
+    if (ultima >= 0) {
+        sector_activo = ultima / PAGINAS_POR_SECTOR;
+        siguiente = ultima % PAGINAS_POR_SECTOR + 1;
+    } else {
+        sector_activo = 0;
+        siguiente = PAGINAS_POR_SECTOR; // Sin armar: el primer trabajo borra
+    }
+    return ultima >= 0 && pagina(ultima)->longitud > 0;
+}
+
+bool respaldo_armar(void) {
+    int sector = ultima >= 0 ? 1 - ultima / PAGINAS_POR_SECTOR : 0;
+    int primera = sector * PAGINAS_POR_SECTOR;
+    bool blanco = true;
+    for (int i = 0; i < PAGINAS_POR_SECTOR && blanco; i++) {
+        blanco = en_blanco(primera + i);
+    }
+    if (!blanco && flash_safe_execute(borrar_en_ram,
+            (void *)(uintptr_t)(RESPALDO_OFFSET + (uint32_t)sector * FLASH_SECTOR_SIZE),
+            ALMACEN_PLAZO_MS) != PICO_OK) {
+        return false;
+    }
+    sector_activo = sector;
+    siguiente = 0;
+    return true;
+}
+
+/**
+ * @brief Guarda un punto de control dejando libres las últimas `reservadas` páginas del sector.
+ */
+static bool guardar(const void *datos, uint16_t longitud, int reservadas) {
+    if (longitud == 0 || longitud > RESPALDO_DATOS_MAX) return false;
+    if (siguiente >= PAGINAS_POR_SECTOR - reservadas) return false;
+    uint32_t ints = save_and_disable_interrupts(); // El búfer se comparte con la interrupción de alimentación
+    bool ok = escribir(datos, longitud);
+    restore_interrupts(ints);
+    return ok;
+}
+
+bool respaldo_guardar(const void *datos, uint16_t longitud) {
+    return guardar(datos, longitud, 2); // Punto de control final y cierre
+}
+
+bool respaldo_guardar_final(const void *datos, uint16_t longitud) {
+    return guardar(datos, longitud, 1); // Cierre
+}
+
+bool respaldo_leer(void *datos, uint16_t longitud) {
+    if (ultima < 0) return false;
+    const pagina_t *p = pagina(ultima);
+    if (p->longitud == 0 || p->longitud != longitud) return false;
+    memcpy(datos, p->datos, longitud);
+    return true;
+}
+
+void respaldo_cerrar(void) {
+    if (ultima < 0 || pagina(ultima)->longitud == 0) return; // Nada que anular
+    if (siguiente >= PAGINAS_POR_SECTOR && !respaldo_armar()) return;
+    uint32_t ints = save_and_disable_interrupts();
+    escribir(NULL, 0);
+    restore_interrupts(ints);
+}
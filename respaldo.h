@@ -0,0 +1,76 @@
+/**
+ * @file respaldo.h
+ * @brief Punto de control del bobinado en curso en flash, para reanudarlo tras un apagón.
+ *
+ * Usa dos sectores propios justo antes del almacén, alternados: al empezar un trabajo
+ * (`respaldo_armar()`) se borra el sector que no tiene el último punto de control, y las
+ * escrituras posteriores programan páginas ya borradas de ese sector, lo que tarda menos
+ * de un milisegundo y puede hacerse desde una interrupción cuando cae la alimentación.
+ * Cada página lleva secuencia y CRC-32: vale la última página válida de los dos sectores.
+ * Un punto de control se anula escribiendo una página vacía (`respaldo_cerrar()`).
+ *
+ * Las dos últimas páginas de cada sector se reservan: la penúltima para el punto de control
+ * final, con el tambor ya detenido (`respaldo_guardar_final()`), y la última para la
+ * anulación. Así los puntos de control de una caída nunca dejan sin sitio a la posición
+ * final, y cerrar nunca necesita borrar durante un bobinado.
+ */
+
+#ifndef RESPALDO_H
+#define RESPALDO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define RESPALDO_DATOS_MAX 240 ///< Bytes de datos por punto de control.
+
+/**
+ * @brief Busca el último punto de control. Llamar al arrancar, antes de usar el módulo.
+ *
+ * @return `true` si hay un punto de control sin anular.
+ */
+bool respaldo_iniciar(void);
+
+/**
+ * @brief Prepara un sector borrado para los puntos de control del trabajo que empieza.
+ *
+ * Bloquea hasta ~50 ms si hay que borrar: llamar con el motor parado. El último punto de
+ * control, si lo hay, sigue siendo válido hasta que se escriba otro.
+ * @return `false` si no se pudo borrar.
+ */
+bool respaldo_armar(void);
+
+/**
+ * @brief Guarda un punto de control. Rápido y seguro desde interrupciones.
+ *
+ * @param datos Datos del punto de control.
+ * @param longitud Tamaño (1 .. `RESPALDO_DATOS_MAX`).
+ * @return `false` si no está armado o el sector está lleno (sin contar las páginas reservadas).
+ */
+bool respaldo_guardar(const void *datos, uint16_t longitud);
+
+/**
+ * @brief Guarda el punto de control final de un trabajo interrumpido.
+ *
+ * Puede usar la página reservada para él, de modo que cabe aunque `respaldo_guardar()`
+ * haya llenado el sector.
+ * @param datos Datos del punto de control.
+ * @param longitud Tamaño (1 .. `RESPALDO_DATOS_MAX`).
+ * @return `false` si no está armado, no queda página o la escritura falló.
+ */
+bool respaldo_guardar_final(const void *datos, uint16_t longitud);
+
+/**
+ * @brief Lee el último punto de control sin anular.
+ *
+ * @param datos Destino.
+ * @param longitud Tamaño esperado.
+ * @return `true` si se copió.
+ */
+bool respaldo_leer(void *datos, uint16_t longitud);
+
+/**
+ * @brief Anula el último punto de control (trabajo terminado o descartado).
+ */
+void respaldo_cerrar(void);
+
+#endif // RESPALDO_H
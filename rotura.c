@@ -0,0 +1,70 @@
+/**
+ * @file rotura.c
+ * @brief Implementación del sensor de rotura con filtro PIO e interrupción enclavada.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "rotura.h"
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "fallas.h"
+#include "rotura.pio.h"
+
+#define ROTURA_FREQ_SM 1000000u   ///< Frecuencia de la máquina de estados (1 us por ciclo).
+#define ROTURA_CICLOS_MUESTRA 9u  ///< Ciclos por muestra del bucle de filtro.
+
+static PIO rotura_pio;              ///< Bloque PIO utilizado.
+static uint rotura_sm;              ///< Máquina de estados asignada.
+static uint rotura_pin;             ///< Pin del fotointerruptor.
+static volatile bool armada = false; ///< La vigilancia está activa.
+
+/**
+ * @brief ISR de la PIO: rotura confirmada por el filtro.
+ */
+static void rotura_irq(void) {
+    pio_interrupt_clear(rotura_pio, rotura_sm);
+    if (!armada) return;
+    falla_reportar(FALLA_ROTURA, time_us_32());
+}
+
+void rotura_iniciar(PIO pio, uint pin, uint32_t filtro_us) {
+    rotura_pio = pio;
+    rotura_pin = pin;
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_IN);
+    gpio_pull_up(pin); // Sin sensor conectado se lee como hilo roto: falla segura
+
+    rotura_sm = (uint)pio_claim_unused_sm(pio, true);
+    uint offset = pio_add_program(pio, &rotura_program);
+    float div = (float)clock_get_hz(clk_sys) / ROTURA_FREQ_SM;
+    rotura_program_init(pio, rotura_sm, offset, pin, div);
+
+    // Y = muestras del filtro menos una (el bucle cuenta X + 1)
+    uint32_t muestras = filtro_us / ROTURA_CICLOS_MUESTRA;
+    pio_sm_put_blocking(pio, rotura_sm, muestras > 0 ? muestras - 1 : 0);
+    pio_sm_exec(pio, rotura_sm, pio_encode_pull(false, false));
+    pio_sm_exec(pio, rotura_sm, pio_encode_mov(pio_y, pio_osr));
+
+    // "irq 0 rel" usa la bandera con el número de la máquina de estados
+    pio_set_irq1_source_enabled(pio, (enum pio_interrupt_source)(pis_interrupt0 + rotura_sm), true);
+    uint irq = pio == pio0 ? PIO0_IRQ_1 : PIO1_IRQ_1;
+    irq_add_shared_handler(irq, rotura_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(irq, true);
+
+    pio_sm_set_enabled(pio, rotura_sm, true);
+}
+
+void rotura_armar(void) {
+    armada = true;
+    // Con el hilo ya roto la PIO está esperando el reposo y no volverá a avisar
+    if (gpio_get(rotura_pin)) {
+        falla_reportar(FALLA_ROTURA, time_us_32());
+    }
+}
+
+void rotura_desarmar(void) {
+    armada = false;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file rotura.h
+ * @brief Sensor de rotura/atasco del hilo (fotointerruptor) con filtrado por PIO.
+ *
+ * Una máquina de estados PIO filtra los pulsos espurios del fotointerruptor y solo
+ * levanta su interrupción cuando el nivel de "hilo roto" se mantiene el tiempo de filtro.
+ * La interrupción reporta `FALLA_ROTURA` al gestor de fallas, que corta el motor de
+ * inmediato y deja la falla enclavada.
+ */
+
+#ifndef ROTURA_H
+#define ROTURA_H
+
+#include "hardware/pio.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Inicializa el filtro PIO y su interrupción.
+ *
+ * El pin debe leer 1 con el hilo roto (haz libre) y 0 con el hilo presente.
+ * @param pio Bloque PIO a utilizar.
+ * @param pin Pin GPIO del fotointerruptor.
+ * @param filtro_us Tiempo que debe mantenerse la rotura para confirmarla.
+ */
+void rotura_iniciar(PIO pio, uint pin, uint32_t filtro_us);
+
+/**
+ * @brief Activa la vigilancia.
+ *
+ * Si el hilo ya está roto (o no está colocado) la falla se reporta en el acto.
+ */
+void rotura_armar(void);
+
+/**
+ * @brief Suspende la vigilancia (trabajo en pausa, con el hilo quizá fuera del sensor).
+ */
+void rotura_desarmar(void);
+
+#endif // ROTURA_H
@@ -0,0 +1,76 @@
+/**
+ * @file servo_pio.c
+ * @brief Implementación de la salida de servo por PIO.
+ *
+ * El programa `servo_pio` mantiene el pin en alto durante X + 1 ciclos y en bajo durante
+ * el valor cargado en ISR más 4 ciclos de sobrecarga. El marco dura por tanto
+ * "bajo + ancho": su frecuencia varía levemente con la posición, lo que no afecta al servo
+ * porque este solo mide el ancho del pulso.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "servo_pio.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "servo_pio.pio.h"
+
+#define SERVO_PIO_SOBRECARGA 4      ///< Ciclos fijos del bucle PIO fuera de los contadores.
+#define SERVO_PIO_ANCHO_CENTRO_NS 1500000 ///< Pulso de 1.5 ms (posición central).
+
+static PIO servo_pio;        ///< Bloque PIO utilizado.
+static uint servo_sm;        ///< Máquina de estados asignada.
+static uint32_t ns_por_ciclo_q16; ///< Nanosegundos por ciclo del sistema en formato Q16.
+static int servo_dma = -1;   ///< Canal DMA en uso (-1 si la salida es por CPU).
+
+uint32_t servo_pio_ns_a_cuentas(uint32_t ancho_ns) {
+    uint32_t ciclos = (uint32_t)(((uint64_t)ancho_ns << 16) / ns_por_ciclo_q16);
+    return ciclos > 0 ? ciclos - 1 : 0; // El bucle en alto dura X + 1 ciclos
+}
+
+void servo_pio_iniciar(PIO pio, uint pin, uint frecuencia_hz) {
+    uint32_t clk = clock_get_hz(clk_sys);
+    ns_por_ciclo_q16 = (uint32_t)((1000000000ull << 16) / clk);
+
+    servo_pio = pio;
+    servo_sm = (uint)pio_claim_unused_sm(pio, true);
+    uint offset = pio_add_program(pio, &servo_pio_program);
+    servo_pio_program_init(pio, servo_sm, offset, pin);
+
+    // Tiempo en bajo: periodo del marco menos el pulso central y la sobrecarga.
+    uint32_t periodo = clk / frecuencia_hz;
+    uint32_t bajo = periodo - servo_pio_ns_a_cuentas(SERVO_PIO_ANCHO_CENTRO_NS) - SERVO_PIO_SOBRECARGA;
+
+    // Carga ISR con el tiempo en bajo a través de la FIFO (pull + out isr).
+    pio_sm_put_blocking(pio, servo_sm, bajo);
+    pio_sm_exec(pio, servo_sm, pio_encode_pull(false, false));
+    pio_sm_exec(pio, servo_sm, pio_encode_out(pio_isr, 32));
+
+    pio_sm_put_blocking(pio, servo_sm, servo_pio_ns_a_cuentas(SERVO_PIO_ANCHO_CENTRO_NS));
+    pio_sm_set_enabled(pio, servo_sm, true);
+}
+
+void servo_pio_set_ancho_ns(uint32_t ancho_ns) {
+    // Vacía la FIFO para que el nuevo valor se aplique en el siguiente marco y no
+    // detrás de valores antiguos; la máquina repite el último ancho mientras tanto.
+    pio_sm_clear_fifos(servo_pio, servo_sm);
+    pio_sm_put(servo_pio, servo_sm, servo_pio_ns_a_cuentas(ancho_ns));
+}
+
+void servo_pio_usar_dma(const volatile uint32_t *cuentas) {
+    if (servo_dma < 0) {
+        servo_dma = dma_claim_unused_channel(true);
+    } else {
+        dma_channel_abort((uint)servo_dma);
+    }
+
+    dma_channel_config c = dma_channel_get_default_config((uint)servo_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, false);   // Siempre la misma variable
+    channel_config_set_write_increment(&c, false);  // Siempre la FIFO TX
+    channel_config_set_dreq(&c, pio_get_dreq(servo_pio, servo_sm, true));
+
+    // Conteo máximo: a 300 Hz el canal funciona durante meses sin recargarse.
+    dma_channel_configure((uint)servo_dma, &c, &servo_pio->txf[servo_sm], cuentas, 0xFFFFFFFFu, true);
+}
@@ -0,0 +1,60 @@
+/**
+ * @file servo_pio.h
+ * @brief Salida de servo generada por PIO con resolución de un ciclo de reloj.
+ *
+ * Alternativa al PWM por hardware para el servo: libera los slices PWM para el motor
+ * y el conteo, da 8 ns de resolución a 125 MHz y permite frecuencias de marco mayores
+ * (p. ej. 300 Hz para servos digitales). El ancho puede actualizarse desde la CPU o
+ * desde un canal DMA que copia continuamente una variable en RAM.
+ */
+
+#ifndef SERVO_PIO_H
+#define SERVO_PIO_H
+
+#include "hardware/pio.h"
+#include <stdint.h>
+
+/**
+ * @brief Inicializa la salida de servo por PIO.
+ *
+ * Carga el programa en `pio`, reserva una máquina de estados libre y arranca con un
+ * pulso de 1.5 ms (posición central).
+ *
+ * @param pio Bloque PIO a utilizar (`pio0` o `pio1`).
+ * @param pin Pin GPIO de la señal del servo.
+ * @param frecuencia_hz Frecuencia de marco (50 Hz para servos analógicos, hasta ~300 Hz para digitales).
+ */
+void servo_pio_iniciar(PIO pio, uint pin, uint frecuencia_hz);
+
+/**
+ * @brief Establece el ancho del pulso en nanosegundos.
+ *
+ * El nuevo ancho se aplica en el siguiente marco. No debe usarse mientras el modo DMA
+ * esté activo.
+ *
+ * @param ancho_ns Ancho del pulso en nanosegundos.
+ */
+void servo_pio_set_ancho_ns(uint32_t ancho_ns);
+
+/**
+ * @brief Convierte nanosegundos a cuentas del programa PIO.
+ *
+ * Útil para preparar el valor que leerá el DMA en `servo_pio_usar_dma()`.
+ * @param ancho_ns Ancho del pulso en nanosegundos.
+ * @return El valor a escribir en la FIFO para obtener ese ancho.
+ */
+uint32_t servo_pio_ns_a_cuentas(uint32_t ancho_ns);
+
+/**
+ * @brief Alimenta la FIFO del servo por DMA desde una variable en RAM.
+ *
+ * Un canal DMA, regulado por la DREQ de la FIFO TX, copia `*cuentas` en cada marco.
+ * Quien produce la posición solo escribe la variable, al ritmo que quiera y sin
+ * intervención de la CPU en la salida. La latencia máxima es la profundidad de la FIFO
+ * (4 marcos).
+ *
+ * @param cuentas Variable con el ancho ya convertido por `servo_pio_ns_a_cuentas()`.
+ */
+void servo_pio_usar_dma(const volatile uint32_t *cuentas);
+
+#endif // SERVO_PIO_H
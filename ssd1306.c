@@ -16,12 +16,17 @@
 #include "pico/stdlib.h"    // Funciones estándar de la Raspberry Pi Pico SDK
 #include <string.h>         // Para funciones de manipulación de memoria como memset y memcpy
 #include "font5x7.h"        // Incluye la definición de la fuente de caracteres 5x7
+#include "interpolador.h"   // Contador de direcciones por hardware para el dibujo de glifos
 
 /// Búfer de memoria estático para almacenar el estado de los píxeles de la pantalla.
 /// El tamaño es Ancho * Alto / 8 porque cada byte representa 8 píxeles verticales.
 static uint8_t buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
 /// Puntero estático a la instancia I2C utilizada para comunicarse con el SSD1306.
 static i2c_inst_t *ssd1306_i2c;
+/// Indica si alguna escritura I2C falló desde el inicio de la última actualización.
+static bool error_bus = false;
+/// Tiempo máximo de una escritura I2C; evita que un bus colgado bloquee el programa.
+#define SSD1306_TIMEOUT_US 20000
 
 /**
  * @brief Envía un comando de control al controlador SSD1306 a través de I2C.
@@ -35,7 +40,9 @@ static void ssd1306_write_cmd(uint8_t cmd) {
     uint8_t buf[] = {0x00, cmd}; // El primer byte es 0x00 para comandos
     // Envía el comando al controlador SSD1306. El último argumento 'false' indica
     // que la transacción I2C debe detenerse después de esta escritura.
-    i2c_write_blocking(ssd1306_i2c, SSD1306_I2C_ADDR, buf, 2, false);
+    if (i2c_write_timeout_us(ssd1306_i2c, SSD1306_I2C_ADDR, buf, 2, false, SSD1306_TIMEOUT_US) < 0) {
+        error_bus = true; // Sin reconocimiento o tiempo excedido
+    }
 }
 
 /**
@@ -53,7 +60,9 @@ static void ssd1306_write_data(uint8_t *data, size_t len) {
     memcpy(buf + 1, data, len); // Copia los datos proporcionados después del byte de control
     // Envía los datos al controlador SSD1306. El último argumento 'false' indica
     // que la transacción I2C debe detenerse después de esta escritura.
-    i2c_write_blocking(ssd1306_i2c, SSD1306_I2C_ADDR, buf, len + 1, false);
+    if (i2c_write_timeout_us(ssd1306_i2c, SSD1306_I2C_ADDR, buf, len + 1, false, SSD1306_TIMEOUT_US) < 0) {
+        error_bus = true; // Sin reconocimiento o tiempo excedido
+    }
 }
 
 /**
@@ -117,6 +126,8 @@ void ssd1306_init(i2c_inst_t *i2c, uint8_t sda, uint8_t scl) {
 
     ssd1306_clear(); // Limpia el búfer de la pantalla
     ssd1306_show();  // Muestra el búfer (pantalla en blanco)
+
+    interp_blit_config(); // Prepara el contador de direcciones usado por ssd1306_draw_char()
 }
 
 /**
@@ -137,6 +148,7 @@ void ssd1306_clear(void) {
  * y envía los datos correspondientes desde el búfer a la pantalla a través de I2C.
  */
 void ssd1306_show(void) {
+    error_bus = false;
     // La pantalla SSD1306 se organiza en 8 "páginas" (filas de 8 píxeles).
     for (uint8_t page = 0; page < 8; page++) {
         // Establece la dirección de la página a la que se va a escribir.
@@ -178,22 +190,37 @@ void ssd1306_draw_pixel(uint8_t x, uint8_t y, bool color) {
  * El carácter se dibuja en las coordenadas (x, y) especificadas.
  * Los datos de los píxeles se obtienen de la matriz `font5x7`.
  *
+ * Cada columna de 8 píxeles del glifo cae como mucho en dos bytes del búfer (la página
+ * de `y` y la siguiente), así que se escribe byte a byte en lugar de píxel a píxel.
+ * Las direcciones de los bytes las recorre el interpolador (interp0, carril 1).
+ *
  * @param x La coordenada X de inicio para el carácter.
  * @param y La coordenada Y de inicio para el carácter.
  * @param c El carácter ASCII a dibujar.
  */
 void ssd1306_draw_char(uint8_t x, uint8_t y, char c) {
+    if (y >= SSD1306_HEIGHT) return;
+
+    // Se resta 32 porque la fuente comienza en el carácter ASCII 32 (espacio).
+    const uint8_t *glifo = font5x7[c - 32];
+    uint8_t desp = y % 8;                      // Bit de inicio dentro de la página
+    bool dos_paginas = desp != 0 && y / 8 < 7; // La columna invade la página siguiente
+    uint8_t mascara_alta = 0xFF << desp;
+    uint8_t mascara_baja = 0xFF >> (8 - desp);
+
+    interp_blit_inicio(x + (y / 8) * SSD1306_WIDTH);
     // Itera a través de las 5 columnas del carácter de la fuente 5x7.
     for (uint8_t i = 0; i < 5; i++) {
-        // Obtiene la línea (columna de píxeles) para el carácter actual.
-        // Se resta 32 porque la fuente comienza en el carácter ASCII 32 (espacio).
-        uint8_t line = font5x7[c - 32][i];
-        // Itera a través de los 8 píxeles de alto de la columna.
-        for (uint8_t j = 0; j < 8; j++) {
-            // Dibuja cada píxel. Se verifica el bit menos significativo de 'line'
-            // para determinar si el píxel está encendido o apagado.
-            ssd1306_draw_pixel(x + i, y + j, line & 0x01);
-            line >>= 1; // Desplaza el bit para verificar el siguiente píxel en la columna
+        uint32_t indice = interp_blit_siguiente();
+        if (x + i >= SSD1306_WIDTH) break;     // Columna fuera de la pantalla
+
+        uint8_t line = glifo[i];
+        // Parte superior de la columna en la página de `y`
+        buffer[indice] = (buffer[indice] & ~mascara_alta) | (uint8_t)(line << desp);
+        // Resto de la columna en la página siguiente
+        if (dos_paginas) {
+            buffer[indice + SSD1306_WIDTH] = (buffer[indice + SSD1306_WIDTH] & ~mascara_baja)
+                                             | (uint8_t)(line >> (8 - desp));
         }
     }
 }
@@ -214,4 +241,13 @@ void ssd1306_draw_string(uint8_t x, uint8_t y, const char *str) {
         ssd1306_draw_char(x, y, *str++); // Dibuja el carácter actual y avanza al siguiente
         x += 6; // Avanza la posición X por el ancho del carácter (5 píxeles) más 1 píxel de espacio.
     }
+}
+
+/**
+ * @brief Indica si la última actualización de la pantalla se completó sin errores de I2C.
+ *
+ * @return `true` si todas las escrituras desde el último `ssd1306_show()` fueron reconocidas.
+ */
+bool ssd1306_ok(void) {
+    return !error_bus;
 }
\ No newline at end of file
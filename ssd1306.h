@@ -93,6 +93,13 @@ void ssd1306_draw_char(uint8_t x, uint8_t y, char c);
  */
 void ssd1306_draw_string(uint8_t x, uint8_t y, const char *str);
 
+/**
+ * @brief Indica si la última actualización de la pantalla se completó sin errores de I2C.
+ *
+ * @return `false` si alguna escritura de `ssd1306_show()` no fue reconocida o excedió su tiempo.
+ */
+bool ssd1306_ok(void);
+
 /** @} */ // fin de PublicFunctions
 
 #endif // SSD1306_H
\ No newline at end of file
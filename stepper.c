@@ -0,0 +1,193 @@
+/**
+ * @file stepper.c
+ * @brief Implementación del traslado paso a paso con cola de segmentos y rampas.
+ *
+ * El generador trabaja con la velocidad al cuadrado para evitar divisiones en la rampa:
+ * en cada paso v² crece como mucho 2·a y nunca supera el valor que permite frenar hasta
+ * la velocidad final del segmento en los pasos restantes (v_fin² + 2·a·restantes).
+ * La interrupción "FIFO TX no llena" de la PIO rellena la cola de pasos; se desactiva
+ * cuando no quedan segmentos.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "stepper.h"
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "stepper.pio.h"
+
+#define STEPPER_FREQ_SM 10000000u   ///< Frecuencia de la máquina de estados (100 ns por ciclo).
+#define STEPPER_CICLOS_FIJOS 30u    ///< Ciclos por paso fuera del contador en bajo.
+#define STEPPER_MAX_SEGMENTOS 16    ///< Capacidad de la cola de segmentos (potencia de 2).
+
+/**
+ * @brief Segmento de movimiento a velocidad de crucero constante.
+ */
+typedef struct {
+    int32_t pasos;      ///< Pasos con signo (el signo es el sentido).
+    uint32_t vel;       ///< Velocidad de crucero en pasos/s.
+} segmento_t;
+
+static PIO stepper_pio;             ///< Bloque PIO utilizado.
+static uint stepper_sm;             ///< Máquina de estados asignada.
+static stepper_config_t stepper_cfg; ///< Configuración activa.
+
+static segmento_t cola[STEPPER_MAX_SEGMENTOS]; ///< Cola circular de segmentos.
+static volatile uint32_t cola_ini = 0;         ///< Índice del segmento en ejecución.
+static volatile uint32_t cola_fin = 0;         ///< Índice del próximo segmento libre.
+
+static int32_t restantes = 0;       ///< Pasos pendientes del segmento en ejecución.
+static uint32_t v2 = 0;             ///< Velocidad actual al cuadrado (pasos²/s²).
+static int32_t objetivo_pasos = 0;  ///< Posición del último segmento encolado.
+static uint32_t ultima_orden_us = 0; ///< Instante de la última orden de movimiento.
+
+/**
+ * @brief Raíz cuadrada entera (método de bits).
+ */
+static uint32_t isqrt(uint32_t n) {
+    uint32_t raiz = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > n) bit >>= 2;
+    while (bit) {
+        if (n >= raiz + bit) {
+            n -= raiz + bit;
+            raiz = (raiz >> 1) + bit;
+        } else {
+            raiz >>= 1;
+        }
+        bit >>= 2;
+    }
+    return raiz;
+}
+
+/**
+ * @brief Velocidad final al cuadrado del segmento en ejecución.
+ *
+ * Si el siguiente segmento sigue en el mismo sentido se une sin frenar; si invierte
+ * se frena hasta `vel_min`. Sin segmento siguiente se asume continuidad a la misma
+ * velocidad, ya que el traslado envía órdenes continuamente mientras el tambor gira.
+ */
+static uint32_t v2_final(const segmento_t *seg) {
+    uint32_t v_min2 = stepper_cfg.vel_min * stepper_cfg.vel_min;
+    uint32_t sig = (cola_ini + 1) & (STEPPER_MAX_SEGMENTOS - 1);
+    if (sig == cola_fin) return seg->vel * seg->vel;
+    const segmento_t *s = &cola[sig];
+    if ((s->pasos > 0) != (seg->pasos > 0)) return v_min2;
+    uint32_t v = s->vel < seg->vel ? s->vel : seg->vel;
+    return v * v;
+}
+
+/**
+ * @brief Calcula la palabra del siguiente paso, o devuelve `false` si no hay más.
+ */
+static bool stepper_siguiente_paso(uint32_t *palabra) {
+    while (restantes == 0) {
+        if (cola_ini == cola_fin) return false;
+        // Segmento vacío (orden repetida): se descarta
+        if (cola[cola_ini].pasos != 0) {
+            restantes = cola[cola_ini].pasos > 0 ? cola[cola_ini].pasos : -cola[cola_ini].pasos;
+            break;
+        }
+        cola_ini = (cola_ini + 1) & (STEPPER_MAX_SEGMENTOS - 1);
+    }
+
+    const segmento_t *seg = &cola[cola_ini];
+    uint32_t v_min2 = stepper_cfg.vel_min * stepper_cfg.vel_min;
+    uint32_t v_max2 = seg->vel * seg->vel;
+
+    // Límite de frenado para llegar a la velocidad final en los pasos restantes.
+    uint64_t frenado = (uint64_t)v2_final(seg) + 2ull * stepper_cfg.accel * (uint32_t)(restantes - 1);
+    uint32_t limite = frenado < v_max2 ? (uint32_t)frenado : v_max2;
+
+    uint32_t nuevo = v2 + 2 * stepper_cfg.accel;
+    v2 = nuevo < limite ? nuevo : limite;
+    if (v2 < v_min2) v2 = v_min2;
+
+    uint32_t periodo = STEPPER_FREQ_SM / isqrt(v2);
+    uint32_t bajo = periodo > STEPPER_CICLOS_FIJOS ? periodo - STEPPER_CICLOS_FIJOS : 0;
+    *palabra = (bajo << 1) | (seg->pasos > 0 ? 1u : 0u);
+
+    if (--restantes == 0) {
+        cola_ini = (cola_ini + 1) & (STEPPER_MAX_SEGMENTOS - 1);
+    }
+    return true;
+}
+
+/**
+ * @brief ISR de la PIO: rellena la FIFO de pasos mientras tenga espacio.
+ */
+static void stepper_irq(void) {
+    uint32_t palabra;
+    while (!pio_sm_is_tx_fifo_full(stepper_pio, stepper_sm)) {
+        if (!stepper_siguiente_paso(&palabra)) {
+            // Sin segmentos: se apaga la interrupción hasta la próxima orden.
+            pio_set_irq0_source_enabled(stepper_pio, (enum pio_interrupt_source)(pis_sm0_tx_fifo_not_full + stepper_sm), false);
+            v2 = 0;
+            return;
+        }
+        pio_sm_put(stepper_pio, stepper_sm, palabra);
+    }
+}
+
+void stepper_iniciar(PIO pio, const stepper_config_t *cfg) {
+    stepper_cfg = *cfg;
+    stepper_pio = pio;
+    stepper_sm = (uint)pio_claim_unused_sm(pio, true);
+    uint offset = pio_add_program(pio, &stepper_program);
+    float div = (float)clock_get_hz(clk_sys) / STEPPER_FREQ_SM;
+    stepper_program_init(pio, stepper_sm, offset, cfg->pin_step, cfg->pin_dir, div);
+
+    uint irq = pio == pio0 ? PIO0_IRQ_0 : PIO1_IRQ_0;
+    irq_add_shared_handler(irq, stepper_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(irq, true);
+    pio_sm_set_enabled(pio, stepper_sm, true);
+}
+
+void stepper_fijar_origen(int32_t mgrad) {
+    uint32_t estado = save_and_disable_interrupts();
+    cola_ini = cola_fin = 0;
+    restantes = 0;
+    v2 = 0;
+    objetivo_pasos = (mgrad * stepper_cfg.pasos_por_grado) / 1000;
+    ultima_orden_us = time_us_32();
+    restore_interrupts(estado);
+}
+
+void stepper_mover_mgrados(int32_t mgrad) {
+    int32_t destino = (mgrad * stepper_cfg.pasos_por_grado) / 1000;
+    int32_t pasos = destino - objetivo_pasos;
+    if (pasos == 0) return;
+
+    uint32_t ahora = time_us_32();
+    uint32_t dt_us = ahora - ultima_orden_us;
+    ultima_orden_us = ahora;
+
+    // Velocidad de crucero = ritmo al que llegan las órdenes, limitada por el driver.
+    uint32_t n = (uint32_t)(pasos > 0 ? pasos : -pasos);
+    uint64_t vel = dt_us > 0 ? ((uint64_t)n * 1000000u) / dt_us : stepper_cfg.vel_max;
+    if (vel > stepper_cfg.vel_max) vel = stepper_cfg.vel_max;
+    if (vel < stepper_cfg.vel_min) vel = stepper_cfg.vel_min;
+
+    uint32_t estado = save_and_disable_interrupts();
+    uint32_t sig = (cola_fin + 1) & (STEPPER_MAX_SEGMENTOS - 1);
+    uint32_t ultimo = (cola_fin - 1) & (STEPPER_MAX_SEGMENTOS - 1);
+    if (sig == cola_ini) {
+        // Cola llena: se alarga el último segmento. No puede ser el que está en ejecución
+        // porque la cola tiene más de un segmento pendiente.
+        cola[ultimo].pasos += pasos;
+    } else {
+        cola[cola_fin].pasos = pasos;
+        cola[cola_fin].vel = (uint32_t)vel;
+        cola_fin = sig;
+    }
+    objetivo_pasos = destino;
+    pio_set_irq0_source_enabled(stepper_pio, (enum pio_interrupt_source)(pis_sm0_tx_fifo_not_full + stepper_sm), true);
+    restore_interrupts(estado);
+}
+
+bool stepper_en_movimiento(void) {
+    return cola_ini != cola_fin || restantes != 0 || !pio_sm_is_tx_fifo_empty(stepper_pio, stepper_sm);
+}
@@ -0,0 +1,64 @@
+/**
+ * @file stepper.h
+ * @brief Traslado con motor paso a paso (driver STEP/DIR) generado por PIO.
+ *
+ * Implementa la misma salida que el servo (`traslado_salida_t`): recibe posiciones en
+ * miligrados "equivalentes" y las convierte a pasos, de modo que el planificador de
+ * traslado, el paso del hilo y los patrones funcionan sin cambios. Cada posición nueva
+ * se encola como un segmento; un generador en interrupción recorre los segmentos con
+ * rampas de aceleración y entrega a la PIO el intervalo de cada paso.
+ */
+
+#ifndef STEPPER_H
+#define STEPPER_H
+
+#include "hardware/pio.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Parámetros del traslado paso a paso.
+ */
+typedef struct {
+    uint pin_step;           ///< Pin GPIO de la señal STEP.
+    uint pin_dir;            ///< Pin GPIO de la señal DIR.
+    int32_t pasos_por_grado; ///< Pasos del motor por grado equivalente del traslado.
+    uint32_t vel_min;        ///< Velocidad de arranque/parada sin rampa, en pasos/s.
+    uint32_t vel_max;        ///< Velocidad máxima, en pasos/s.
+    uint32_t accel;          ///< Aceleración de las rampas, en pasos/s².
+} stepper_config_t;
+
+/**
+ * @brief Inicializa el generador de pasos en una máquina de estados libre de `pio`.
+ *
+ * @param pio Bloque PIO a utilizar.
+ * @param cfg Parámetros del traslado (se copian).
+ */
+void stepper_iniciar(PIO pio, const stepper_config_t *cfg);
+
+/**
+ * @brief Declara la posición física actual del carro, en miligrados equivalentes.
+ *
+ * Sin final de carrera, el carro debe colocarse a mano en esta posición antes de bobinar.
+ * Descarta cualquier movimiento pendiente.
+ * @param mgrad Posición actual en miligrados equivalentes.
+ */
+void stepper_fijar_origen(int32_t mgrad);
+
+/**
+ * @brief Encola un movimiento hasta la posición indicada.
+ *
+ * Tiene la misma firma que `set_servo_mgrados()` para usarse como salida del traslado.
+ * La velocidad del segmento se deduce del tiempo transcurrido desde la orden anterior,
+ * limitada a `vel_max`; las rampas unen segmentos del mismo sentido sin detenerse.
+ * @param mgrad Posición objetivo en miligrados equivalentes.
+ */
+void stepper_mover_mgrados(int32_t mgrad);
+
+/**
+ * @brief Indica si quedan pasos por emitir.
+ * @return `true` mientras el carro se esté moviendo.
+ */
+bool stepper_en_movimiento(void);
+
+#endif // STEPPER_H
@@ -0,0 +1,182 @@
+/**
+ * @file telemetria.c
+ * @brief Implementación de la telemetría: cola de muestras, tramas COBS y envío por el CDC.
+ *
+ * La cola tiene un solo productor (la interrupción del temporizador) y un solo consumidor
+ * (el bucle principal): basta con que cada uno escriba solo su índice. Los índices corren
+ * libres y se enmascaran al acceder.
+ *
+ * El CDC lo atiende la interrupción de fondo de `stdio_usb` (`tud_task()`); las escrituras
+ * al FIFO se hacen con las interrupciones desactivadas para no intercalarse con ella.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "telemetria.h"
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "hardware/sync.h"
+#include "tusb.h"
+#include "cobs.h"
+#include "fallas.h"
+#include "registro.h"
+#include "traza.h"
+
+#define TELEMETRIA_TRAMA_MAX COBS_TRAMA_MAX(TELEMETRIA_DATOS_MAX)
+
+static telemetria_muestra_t cola[TELEMETRIA_COLA]; ///< Muestras pendientes de envío.
+static volatile uint32_t escritas = 0;  ///< Muestras puestas en la cola (productor).
+static volatile uint32_t leidas = 0;    ///< Muestras sacadas de la cola (consumidor).
+static volatile uint32_t perdidas = 0;  ///< Muestras descartadas por cola llena.
+static volatile bool activa = false;    ///< Hay un receptor: se muestrea.
+static uint16_t secuencia = 0;          ///< Número de la próxima muestra.
+static uint32_t fallas_enviadas = 0;    ///< Registros del historial de fallas ya enviados.
+static registro_entrada_t mensaje;      ///< Mensaje del registro sacado de su cola.
+static bool mensaje_pendiente = false;  ///< `mensaje` aún no cupo en el FIFO.
+static bool volcando = false;           ///< Se está enviando la traza de los sensores.
+static uint32_t traza_enviados = 0;     ///< Eventos de la traza ya enviados.
+static telemetria_fuente_t fuente_muestra; ///< Función que completa las muestras.
+static repeating_timer_t temporizador;  ///< Temporizador de muestreo.
+
+/**
+ * @brief Toma una muestra (interrupción del temporizador).
+ */
+static bool muestrear(repeating_timer_t *rt) {
+    if (!activa) return true;
+    uint32_t e = escritas;
+    if (e - leidas >= TELEMETRIA_COLA) {
+        perdidas++;
+        secuencia++; // El hueco queda a la vista en el receptor
+        return true;
+    }
+    telemetria_muestra_t *m = &cola[e % TELEMETRIA_COLA];
+    fuente_muestra(m);
+    m->t_us = time_us_32();
+    m->secuencia = secuencia++;
+    __compiler_memory_barrier(); // La muestra completa antes de publicarla
+    escritas = e + 1;
+    return true;
+}
+
+/**
+ * @brief Escribe un valor little-endian de `n` bytes.
+ */
+static uint8_t *poner(uint8_t *p, uint32_t v, int n) {
+    for (int i = 0; i < n; i++) {
+        *p++ = (uint8_t)(v >> (8 * i));
+    }
+    return p;
+}
+
+bool telemetria_enviar(const uint8_t *datos, size_t n) {
+    if (n > TELEMETRIA_DATOS_MAX) return false;
+    uint8_t trama[TELEMETRIA_TRAMA_MAX];
+    size_t largo = cobs_codificar(datos, n, trama);
+    uint32_t estado = save_and_disable_interrupts();
+    bool cabe = tud_cdc_write_available() >= largo;
+    if (cabe) {
+        tud_cdc_write(trama, largo);
+    }
+    restore_interrupts(estado);
+    return cabe;
+}
+
+bool telemetria_iniciar(uint32_t periodo_us, telemetria_fuente_t fuente) {
+    stdio_set_driver_enabled(&stdio_usb, false); // El CDC lleva solo tramas
+    fuente_muestra = fuente;
+    fallas_enviadas = fallas_reportadas();
+    return add_repeating_timer_us(-(int64_t)periodo_us, muestrear, NULL, &temporizador);
+}
+
+void telemetria_atender(void) {
+    bool conectado = tud_cdc_connected();
+    if (!conectado) {
+        activa = false;
+        leidas = escritas; // Lo muestreado sin receptor se descarta
+        fallas_enviadas = fallas_reportadas();
+        volcando = false;
+        return;
+    }
+    activa = true;
+
+    uint8_t datos[TELEMETRIA_DATOS_MAX];
+    while (fallas_enviadas != fallas_reportadas()) {
+        const falla_registro_t *r = falla_historial(fallas_enviadas);
+        if (r) {
+            uint8_t *p = datos;
+            *p++ = TELEMETRIA_FALLA;
+            *p++ = (uint8_t)r->tipo;
+            p = poner(p, r->deteccion_us, 4);
+            p = poner(p, r->reaccion_us, 4);
+            if (!telemetria_enviar(datos, p - datos)) break;
+        }
+        fallas_enviadas++;
+    }
+
+    while (mensaje_pendiente || registro_sacar(&mensaje)) {
+        uint8_t *p = datos;
+        *p++ = TELEMETRIA_REGISTRO;
+        p = poner(p, mensaje.id, 2);
+        p = poner(p, mensaje.t_us, 4);
+        for (int i = 0; i < mensaje.n; i++) {
+            p = poner(p, mensaje.args[i], 4);
+        }
+        mensaje_pendiente = !telemetria_enviar(datos, p - datos);
+        if (mensaje_pendiente) break;
+    }
+
+    while (leidas != escritas) {
+        const telemetria_muestra_t *m = &cola[leidas % TELEMETRIA_COLA];
+        uint8_t *p = datos;
+        *p++ = TELEMETRIA_MUESTRA;
+        p = poner(p, m->secuencia, 2);
+        p = poner(p, m->t_us, 4);
+        p = poner(p, (uint32_t)m->pulsos, 4);
+        p = poner(p, (uint32_t)m->traslado_mgrad, 4);
+        p = poner(p, (uint16_t)m->rpm, 2);
+        p = poner(p, (uint16_t)m->tension_g, 2);
+        p = poner(p, m->pwm, 2);
+        if (!telemetria_enviar(datos, p - datos)) break;
+        leidas++;
+    }
+
+    while (volcando && leidas == escritas) { // La traza espera a que se vacíe la cola
+        uint8_t *p = datos;
+        *p++ = TELEMETRIA_TRAZA;
+        p = poner(p, traza_enviados, 2);
+        traza_evento_t e;
+        uint32_t n = 0;
+        while (n < TELEMETRIA_TRAZA_EVENTOS && traza_leer(traza_enviados + n, &e)) {
+            p = poner(p, e.t_us, 4);
+            p = poner(p, e.dato, 4);
+            n++;
+        }
+        if (n == 0) {
+            volcando = false;
+        } else if (telemetria_enviar(datos, p - datos)) {
+            traza_enviados += n;
+        } else {
+            break;
+        }
+    }
+    uint32_t estado = save_and_disable_interrupts();
+    tud_cdc_write_flush(); // Sin nada escrito no hace nada
+    restore_interrupts(estado);
+}
+
+void telemetria_volcar_traza(void) {
+    traza_enviados = 0;
+    volcando = true;
+}
+
+uint32_t telemetria_leer(uint8_t *datos, uint32_t max) {
+    uint32_t estado = save_and_disable_interrupts();
+    uint32_t n = tud_cdc_available() ? tud_cdc_read(datos, max) : 0;
+    restore_interrupts(estado);
+    return n;
+}
+
+uint32_t telemetria_perdidas(void) {
+    return perdidas;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file telemetria.h
+ * @brief Telemetría binaria por el USB CDC, con tramas COBS.
+ *
+ * Un temporizador toma muestras de hasta 1 kHz en interrupción: solo copia unos pocos
+ * valores ya calculados a una cola circular, sin tocar el USB. El bucle principal vacía la
+ * cola en `telemetria_atender()`, codifica cada muestra en una trama COBS y la deja en el
+ * FIFO del CDC mientras haya sitio; las fallas nuevas del historial salen como eventos y
+ * los mensajes del registro diferido (registro.h), con su número de formato. La traza de
+ * los sensores (traza.h) se vuelca a pedido, detrás de las muestras.
+ * Si la cola se llena se pierden muestras, no se frena el control: el número de secuencia
+ * de las muestras delata los huecos.
+ *
+ * El CDC queda reservado a las tramas; `printf` sigue saliendo por la UART. Solo se
+ * muestrea con un receptor conectado (DTR activo). En sentido contrario llegan las órdenes
+ * del PC (remoto.h), que se leen con `telemetria_leer()`.
+ *
+ * Tramas, antes de COBS (little-endian; el primer byte es el tipo):
+ * - `TELEMETRIA_MUESTRA` (21 bytes): secuencia u16, t_us u32, pulsos i32, traslado_mgrad
+ *   i32, rpm i16, tension_g i16, pwm u16.
+ * - `TELEMETRIA_FALLA` (10 bytes): falla u8, deteccion_us u32, reaccion_us u32.
+ * - `TELEMETRIA_REGISTRO` (7 a 23 bytes): mensaje u16, t_us u32 y de 0 a 4 argumentos u32.
+ * - `TELEMETRIA_RESPUESTA` (4 a 36 bytes): respuesta a una orden del PC (ver remoto.h).
+ * - `TELEMETRIA_TRAZA` (11 a 35 bytes): posición u16 del primer evento y de 1 a
+ *   `TELEMETRIA_TRAZA_EVENTOS` eventos de la traza (t_us u32, dato u32).
+ */
+
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define TELEMETRIA_COLA 128 ///< Muestras en la cola (potencia de 2): 128 ms a 1 kHz.
+#define TELEMETRIA_DATOS_MAX 36 ///< Bytes de la trama más larga antes de COBS.
+#define TELEMETRIA_TRAZA_EVENTOS 4 ///< Eventos de la traza por trama.
+
+/**
+ * @brief Tipo de trama (primer byte).
+ */
+typedef enum {
+    TELEMETRIA_MUESTRA = 1, ///< Muestra periódica del bobinado.
+    TELEMETRIA_FALLA = 2,   ///< Falla registrada por el gestor de fallas.
+    TELEMETRIA_REGISTRO = 3, ///< Mensaje del registro diferido.
+    TELEMETRIA_RESPUESTA = 4, ///< Respuesta a una orden del PC.
+    TELEMETRIA_TRAZA = 5,   ///< Eventos de la traza de los sensores.
+} telemetria_tipo_t;
+
+/**
+ * @brief Muestra periódica.
+ */
+typedef struct {
+    uint32_t t_us;          ///< Instante de la muestra (time_us_32); lo pone el módulo.
+    int32_t pulsos;         ///< Pulsos del encoder del tambor (posición).
+    int32_t traslado_mgrad; ///< Ángulo comandado del traslado.
+    int16_t rpm;            ///< Velocidad filtrada del tambor.
+    int16_t tension_g;      ///< Tensión del hilo en gramos.
+    uint16_t pwm;           ///< Ciclo de trabajo del motor (milésimas).
+    uint16_t secuencia;     ///< Número de muestra; lo pone el módulo.
+} telemetria_muestra_t;
+
+/**
+ * @brief Función que completa una muestra. Se llama en interrupción: solo debe copiar.
+ */
+typedef void (*telemetria_fuente_t)(telemetria_muestra_t *m);
+
+/**
+ * @brief Inicia la telemetría.
+ *
+ * Llamar después de `stdio_init_all()`: desvía `printf` del CDC a la UART.
+ * @param periodo_us Periodo de muestreo (1000 = 1 kHz).
+ * @param fuente Función que completa cada muestra.
+ * @return `false` si no quedaba un temporizador libre.
+ */
+bool telemetria_iniciar(uint32_t periodo_us, telemetria_fuente_t fuente);
+
+/**
+ * @brief Envía las muestras y las fallas pendientes. No bloquea.
+ *
+ * Llamar desde los bucles del programa: lo que no cabe en el FIFO del CDC espera en la cola.
+ */
+void telemetria_atender(void);
+
+/**
+ * @brief Codifica una trama y la deja en el FIFO del CDC si cabe entera. No bloquea.
+ *
+ * @param datos Trama antes de COBS; el primer byte es su tipo.
+ * @param n Bytes (máx. `TELEMETRIA_DATOS_MAX`).
+ * @return `false` si no había sitio en el FIFO.
+ */
+bool telemetria_enviar(const uint8_t *datos, size_t n);
+
+/**
+ * @brief Lee los bytes recibidos por el CDC. No bloquea.
+ *
+ * @param datos Destino.
+ * @param max Capacidad del destino.
+ * @return Bytes leídos (0 si no hay).
+ */
+uint32_t telemetria_leer(uint8_t *datos, uint32_t max);
+
+/**
+ * @brief Empieza a volcar la traza de los sensores; `telemetria_atender()` la envía.
+ *
+ * Si se desconecta el receptor el volcado se cancela.
+ */
+void telemetria_volcar_traza(void);
+
+/**
+ * @brief Devuelve las muestras perdidas por cola llena desde el arranque.
+ */
+uint32_t telemetria_perdidas(void);
+
+#endif // TELEMETRIA_H
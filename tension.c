@@ -0,0 +1,174 @@
+/**
+ * @file tension.c
+ * @brief Implementación del estimador de tensión (Kalman escalar adaptativo en punto fijo).
+ *
+ * Modelo: la tensión real sigue un paseo aleatorio de varianza `q` por muestra, y la celda
+ * mide tensión real + tensión inercial + ruido de varianza `r`. Las tensiones se guardan en
+ * Q8 (g·256) y las varianzas en g²·256 con 64 bits.
+ *
+ * La aceleración del tambor se obtiene derivando dos veces el conteo del encoder entre
+ * muestras del HX711; ambas derivadas se suavizan con un promedio exponencial (alfa = 1/4)
+ * porque a 80 muestras/s solo entran unos pocos pulsos por muestra.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "tension.h"
+
+#define TENSION_SALTO_SIGMAS2 9 ///< Innovación (al cuadrado, en varianzas) que se acepta como salto.
+#define TENSION_DT_MIN_US 1000  ///< Intervalo mínimo entre muestras para derivar el conteo (el HX711 da 12.5 ms).
+#define TENSION_CALENTAMIENTO 12 ///< Muestras hasta que la velocidad y la aceleración suavizadas se asientan.
+
+static tension_config_t cfg_tension; ///< Calibración activa.
+static int32_t tara = 0;             ///< Lectura cruda sin carga.
+static bool iniciado = false;        ///< Ya se procesó la primera muestra.
+
+static int32_t x_q8 = 0;             ///< Tensión estimada (g, Q8).
+static int32_t medida_q8 = 0;        ///< Última medida compensada (g, Q8).
+static int64_t p = 0;                ///< Varianza del estimado.
+static int64_t q = 0;                ///< Varianza de proceso adaptada.
+static int64_t r = 0;                ///< Varianza del ruido de medida.
+static int64_t q_min = 0;            ///< Cota inferior de `q`.
+static int64_t q_max = 0;            ///< Cota superior de `q`.
+static int64_t var_innov = 0;        ///< Varianza de la innovación (promedio exponencial).
+
+static uint32_t muestras_cinematica = 0; ///< Muestras derivadas desde el reinicio (hasta `TENSION_CALENTAMIENTO`).
+static int32_t ultimo_pulso = 0;     ///< Conteo del encoder en la muestra anterior.
+static uint32_t ultimo_us = 0;       ///< Instante de la muestra anterior.
+static int32_t vel = 0;              ///< Velocidad del tambor (pulsos/s).
+static int32_t accel = 0;            ///< Aceleración del tambor (pulsos/s²).
+
+/**
+ * @brief Convierte una desviación en gramos a varianza en g²·256.
+ */
+static int64_t varianza(int32_t desviacion_g) {
+    return ((int64_t)desviacion_g * desviacion_g) << 8;
+}
+
+/**
+ * @brief Recorta un valor de 64 bits al rango de `int32_t`.
+ */
+static int32_t saturar(int64_t v) {
+    if (v > INT32_MAX) return INT32_MAX;
+    if (v < INT32_MIN) return INT32_MIN;
+    return (int32_t)v;
+}
+
+/**
+ * @brief Actualiza la velocidad y la aceleración del tambor con el conteo actual.
+ *
+ * La primera muestra tras un reinicio solo fija el punto de partida; la segunda fija la
+ * velocidad sin suavizar (partir de 0 daría una aceleración falsa enorme) y la aceleración
+ * se deriva desde la tercera. Dos muestras casi simultáneas no se derivan: se espera a que
+ * el intervalo llegue a `TENSION_DT_MIN_US`.
+ */
+static void tension_cinematica(int32_t pulsos, uint32_t ahora) {
+    if (muestras_cinematica == 0) {
+        ultimo_pulso = pulsos;
+        ultimo_us = ahora;
+        muestras_cinematica = 1;
+        return;
+    }
+    uint32_t dt_us = ahora - ultimo_us;
+    if (dt_us < TENSION_DT_MIN_US) return;
+    int32_t vel_nueva = saturar(((int64_t)(pulsos - ultimo_pulso) * 1000000) / dt_us);
+    if (muestras_cinematica == 1) {
+        vel = vel_nueva;
+    } else {
+        vel_nueva = saturar(vel + ((int64_t)vel_nueva - vel) / 4);
+        int32_t accel_nueva = saturar(((int64_t)vel_nueva - vel) * 1000000 / dt_us);
+        accel = saturar(accel + ((int64_t)accel_nueva - accel) / 4);
+        vel = vel_nueva;
+    }
+    if (muestras_cinematica < TENSION_CALENTAMIENTO) muestras_cinematica++;
+    ultimo_pulso = pulsos;
+    ultimo_us = ahora;
+}
+
+/**
+ * @brief Paso del filtro de Kalman con la medida compensada `z_q8`.
+ */
+static void tension_filtrar(int32_t z_q8) {
+    if (!iniciado) {
+        x_q8 = z_q8;
+        p = r;
+        var_innov = r;
+        iniciado = true;
+        return;
+    }
+
+    // Predicción: la tensión real puede haber cambiado con varianza q
+    int64_t p_anterior = p;
+    p += q;
+
+    int64_t e = (int64_t)z_q8 - x_q8;
+    int64_t s = p + r;
+    int64_t e2 = (e * e) >> 8;
+
+    if (e2 > TENSION_SALTO_SIGMAS2 * s) {
+        // Salto: se acepta la medida sin retardo y el filtro queda en modo rápido
+        x_q8 = z_q8;
+        p = r;
+        q = q_max;
+        var_innov = r + q_max; // Vuelve al suavizado en unas decenas de muestras
+        return;
+    }
+
+    int64_t k_q16 = (p << 16) / s;
+    x_q8 += (int32_t)((k_q16 * e) >> 16);
+    p -= (k_q16 * p) >> 16;
+
+    // Adaptación del ruido de proceso: lo que la varianza de la innovación excede a la
+    // esperada sin cambio real (ruido de medida + incertidumbre del estimado anterior)
+    var_innov += (e2 - var_innov) / 8;
+    q = var_innov - r - p_anterior;
+    if (q < q_min) q = q_min;
+    if (q > q_max) q = q_max;
+}
+
+void tension_iniciar(const tension_config_t *cfg) {
+    cfg_tension = *cfg;
+    r = varianza(cfg->ruido_g);
+    q_min = varianza(cfg->deriva_min_g);
+    q_max = varianza(cfg->deriva_max_g);
+    q = q_min;
+    iniciado = false;
+    tension_reiniciar();
+}
+
+void tension_reiniciar(void) {
+    vel = 0;
+    accel = 0;
+    muestras_cinematica = 0;
+}
+
+void tension_tarar(int64_t suma, uint32_t muestras) {
+    tara = (int32_t)(suma / muestras);
+    iniciado = false; // El estimado anterior usaba otra tara
+}
+
+void tension_procesar(int32_t crudo, int32_t pulsos, uint32_t t_us) {
+    tension_cinematica(pulsos, t_us);
+
+    int32_t z_q8 = (int32_t)((((int64_t)crudo - tara) << 8) / cfg_tension.cuentas_por_g);
+    int64_t inercial_q8 = ((int64_t)accel * cfg_tension.inercia_g_q16) >> 8;
+    medida_q8 = saturar(z_q8 - inercial_q8);
+    tension_filtrar(medida_q8);
+}
+
+int32_t tension_tara(void) {
+    return tara;
+}
+
+bool tension_calentando(void) {
+    return muestras_cinematica < TENSION_CALENTAMIENTO;
+}
+
+int32_t tension_gramos(void) {
+    return x_q8 >> 8;
+}
+
+int32_t tension_medida_gramos(void) {
+    return medida_q8 >> 8;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file tension.h
+ * @brief Estimador de la tensión del hilo: celda de carga fusionada con la aceleración del tambor.
+ *
+ * La lectura cruda del HX711 en una bobinadora que vibra es ruidosa, y filtrarla mucho
+ * retrasa la detección de una rotura. El estimador es un filtro de Kalman escalar
+ * adaptativo en punto fijo:
+ * - Antes de filtrar se resta de la medida la tensión inercial (proporcional a la
+ *   aceleración del tambor, medida con el encoder óptico), de modo que arranques y frenadas
+ *   no se confunden con cambios reales de tensión.
+ * - El ruido de proceso se adapta con la varianza de la innovación: con tensión estable el
+ *   filtro suaviza mucho; si la medida se aleja, el ruido de proceso sube y el filtro sigue
+ *   a la medida en pocas muestras.
+ * - Un salto mayor de 3 desviaciones de la innovación se acepta de inmediato (sin retardo),
+ *   que es la firma de una rotura o un enganche.
+ *
+ * Todas las tensiones se expresan en gramos-fuerza (g).
+ *
+ * El módulo no lee el HX711 ni el reloj: recibe cada lectura con su instante, así una
+ * traza grabada (traza.h) da los mismos resultados en el equipo y en el PC
+ * (tools/traza_reproducir.c).
+ */
+
+#ifndef TENSION_H
+#define TENSION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Calibración de la celda de carga y parámetros del estimador.
+ */
+typedef struct {
+    int32_t cuentas_por_g;     ///< Escala de la celda: cuentas del HX711 por gramo (con signo).
+    int32_t inercia_g_q16;     ///< Tensión inercial por unidad de aceleración del tambor, en g/(pulso/s²), Q16.
+    int32_t ruido_g;           ///< Desviación típica del ruido de la celda, en g.
+    int32_t deriva_min_g;      ///< Desviación mínima del cambio real de tensión entre muestras (máximo suavizado).
+    int32_t deriva_max_g;      ///< Desviación máxima del cambio real de tensión entre muestras (máxima rapidez).
+} tension_config_t;
+
+/**
+ * @brief Reinicia el estimador con una calibración.
+ *
+ * La velocidad del tambor parte de la primera muestra procesada (ver `tension_reiniciar()`).
+ * @param cfg Calibración (se copia).
+ */
+void tension_iniciar(const tension_config_t *cfg);
+
+/**
+ * @brief Fija la tara de la celda a partir de lecturas tomadas sin hilo cargado.
+ *
+ * @param suma Suma de las lecturas crudas.
+ * @param muestras Número de lecturas sumadas (mayor que 0).
+ */
+void tension_tarar(int64_t suma, uint32_t muestras);
+
+/**
+ * @brief Reinicia la velocidad y la aceleración del tambor.
+ *
+ * Llamar cuando el conteo del encoder salta (al empezar un trabajo se pone a 0 o al punto
+ * de reanudación): si no, la primera muestra lo tomaría como un movimiento del tambor y
+ * restaría una tensión inercial falsa. La cinemática vuelve a partir de la próxima muestra
+ * y no se compensa la inercia hasta la tercera (ver `tension_calentando()`).
+ */
+void tension_reiniciar(void);
+
+/**
+ * @brief Procesa una lectura cruda del HX711.
+ *
+ * Debe llamarse con cada lectura nueva (ver `hx711_listo()`), desde el bucle de control.
+ * La lectura puede venir también de una traza grabada (traza.h).
+ * @param crudo Lectura cruda del HX711.
+ * @param pulsos Conteo del encoder óptico del tambor al tomar la lectura.
+ * @param t_us Instante de la lectura (el grabado, si viene de una traza).
+ */
+void tension_procesar(int32_t crudo, int32_t pulsos, uint32_t t_us);
+
+/**
+ * @brief Devuelve la tara de la celda (lectura cruda sin carga).
+ */
+int32_t tension_tara(void);
+
+/**
+ * @brief Indica si la cinemática del tambor aún se está asentando tras un reinicio.
+ *
+ * Durante unas pocas muestras la compensación inercial es incompleta y la medida puede
+ * llevar un error de la tensión inercial del arranque.
+ */
+bool tension_calentando(void);
+
+/**
+ * @brief Devuelve la tensión estimada en gramos.
+ */
+int32_t tension_gramos(void);
+
+/**
+ * @brief Devuelve la última medida compensada (sin filtrar) en gramos, para diagnóstico.
+ */
+int32_t tension_medida_gramos(void);
+
+#endif // TENSION_H
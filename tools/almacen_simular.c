@@ -0,0 +1,137 @@
+/**
+ * @file almacen_simular.c
+ * @brief Simulación en el PC del almacén de registros (almacen.h) con apagones al azar.
+ *
+ * Escribe versiones nuevas de claves al azar, con datos al azar, sobre la flash simulada
+ * (flash_falsa.h). Algunas escrituras se cortan con un apagón en un byte al azar de lo que
+ * programan o borran, incluida la compactación de un sector. Tras cada apagón, y cada
+ * `REINICIO_CADA` escrituras, se "reinicia" el equipo (`almacen_iniciar()`) y se comprueba
+ * que ninguna clave perdió su última versión confirmada: debe leerse esa o, solo para la
+ * clave que se estaba escribiendo, la nueva.
+ *
+ * Al final muestra los apagones (en programación y en borrado), las versiones perdidas
+ * (debe ser 0) y los borrados de cada sector del almacén, que miden el reparto del desgaste.
+ *
+ * Uso: `almacen_simular [escrituras [semilla]]` (por defecto 200000 y 1).
+ *
+ * Compilar desde esta carpeta:
+ * `cc -O2 -I.. -I. -Isdk_falso -o almacen_simular almacen_simular.c flash_falsa.c ../almacen.c`
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "almacen.h"
+#include "flash_falsa.h"
+
+#define CORTE_UNO_EN 50     ///< Escrituras por apagón programado (de media).
+#define CORTE_LARGO_UNO_EN 8 ///< Apagones programados más allá de la primera página (de media).
+#define CORTE_BYTES_MAX 8192 ///< Bytes hasta un apagón largo: abarca copias y un borrado.
+#define REINICIO_CADA 997   ///< Escrituras entre reinicios sin apagón.
+
+static uint64_t estado_azar; ///< Estado del generador (xorshift64*).
+
+/**
+ * @brief Número al azar de 32 bits.
+ */
+static uint32_t azar(void) {
+    estado_azar ^= estado_azar >> 12;
+    estado_azar ^= estado_azar << 25;
+    estado_azar ^= estado_azar >> 27;
+    return (uint32_t)((estado_azar * 2685821657736338717ull) >> 32);
+}
+
+/**
+ * @brief Bytes hasta el próximo apagón, o -1 si la escritura no se corta.
+ *
+ * La mayoría caen en la página de la escritura; los largos, en la compactación.
+ */
+static int64_t bytes_hasta_corte(void) {
+    if (azar() % CORTE_UNO_EN != 0) return -1;
+    return azar() % CORTE_LARGO_UNO_EN == 0 ? azar() % CORTE_BYTES_MAX : azar() % 256;
+}
+
+/**
+ * @brief Longitud fija de los datos de cada clave.
+ */
+static uint16_t longitud(uint16_t clave) {
+    return (uint16_t)(4 + clave * 15 % (ALMACEN_DATOS_MAX - 3));
+}
+
+static uint8_t vigente[ALMACEN_CLAVES_MAX][ALMACEN_DATOS_MAX]; ///< Última versión confirmada.
+static bool escrita[ALMACEN_CLAVES_MAX];                       ///< La clave tiene una versión confirmada.
+
+/**
+ * @brief Reinicia el almacén y compara cada clave con lo confirmado.
+ *
+ * @param clave Clave que se estaba escribiendo al cortar (0 = ninguna).
+ * @param nuevos Datos que se estaban escribiendo.
+ * @return Claves perdidas o con datos que no son ni la versión confirmada ni la nueva.
+ */
+static uint32_t reiniciar_y_comprobar(uint16_t clave, const uint8_t *nuevos) {
+    almacen_iniciar();
+    uint32_t perdidas = 0;
+    for (uint16_t k = 1; k < ALMACEN_CLAVES_MAX; k++) {
+        uint8_t leido[ALMACEN_DATOS_MAX];
+        bool hay = almacen_leer(k, leido, longitud(k));
+        if (k == clave && hay && memcmp(leido, nuevos, longitud(k)) == 0) {
+            memcpy(vigente[k], nuevos, longitud(k)); // La escritura cortada llegó a confirmarse
+            escrita[k] = true;
+        } else if (hay != escrita[k] || (hay && memcmp(leido, vigente[k], longitud(k)) != 0)) {
+            perdidas++;
+        }
+    }
+    return perdidas;
+}
+
+int main(int argc, char **argv) {
+    uint32_t escrituras = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 200000;
+    estado_azar = 0x9E3779B97F4A7C15ull * (argc > 2 ? strtoull(argv[2], NULL, 10) : 1);
+    if (argc > 3 || escrituras == 0 || estado_azar == 0) {
+        fprintf(stderr, "uso: almacen_simular [escrituras [semilla]]\n");
+        return 2;
+    }
+
+    flash_falsa_iniciar();
+    almacen_iniciar();
+    uint32_t cortes_programando = 0, cortes_borrando = 0, perdidas = 0, rechazadas = 0;
+    for (uint32_t i = 0; i < escrituras; i++) {
+        uint16_t clave = (uint16_t)(1 + azar() % (ALMACEN_CLAVES_MAX - 1));
+        uint8_t datos[ALMACEN_DATOS_MAX];
+        for (uint16_t j = 0; j < longitud(clave); j++) datos[j] = (uint8_t)azar();
+        flash_falsa_cortar(bytes_hasta_corte());
+
+        if (setjmp(flash_falsa_apagon)) { // Apagón: el almacén quedó a medias
+            if (flash_falsa_corte_en_borrado()) cortes_borrando++;
+            else cortes_programando++;
+            perdidas += reiniciar_y_comprobar(clave, datos);
+            continue;
+        }
+        if (almacen_escribir(clave, datos, longitud(clave))) {
+            memcpy(vigente[clave], datos, longitud(clave));
+            escrita[clave] = true;
+        } else {
+            rechazadas++; // Sin apagón no debería fallar
+        }
+        flash_falsa_cortar(-1);
+        if (i % REINICIO_CADA == 0) perdidas += reiniciar_y_comprobar(0, NULL);
+    }
+    perdidas += reiniciar_y_comprobar(0, NULL);
+
+    printf("%u escrituras, %u apagones (%u programando, %u borrando)\n", escrituras,
+           cortes_programando + cortes_borrando, cortes_programando, cortes_borrando);
+    printf("versiones perdidas: %u, escrituras rechazadas sin apagón: %u\n", perdidas, rechazadas);
+    printf("borrados por sector:");
+    uint32_t min = UINT32_MAX, max = 0;
+    for (int s = FLASH_FALSA_SECTORES - ALMACEN_SECTORES; s < FLASH_FALSA_SECTORES; s++) {
+        printf(" %u", flash_falsa_borrados[s]);
+        if (flash_falsa_borrados[s] < min) min = flash_falsa_borrados[s];
+        if (flash_falsa_borrados[s] > max) max = flash_falsa_borrados[s];
+    }
+    printf(" (diferencia %u)\n", max - min);
+    return perdidas || rechazadas ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file anomalia_simular.c
+ * @brief Simulación en el PC del detector de anomalías (anomalia.h) con ruido normal.
+ *
+ * Mide, con el mismo código del equipo y varias semillas:
+ * - el plazo medio entre falsas alarmas (ARL0) con la señal estable;
+ * - el retardo medio de detección de una deriva de la media de 1 desviación y de una
+ *   varianza doble, aplicadas al terminar el aprendizaje y un tramo estable.
+ *
+ * Los parámetros por defecto son los del equipo (`control_anomalia_cfg`); se pueden
+ * cambiar por la línea de órdenes para ajustar el detector:
+ * `anomalia_simular [k_media h_media k_varianza h_varianza]` (en desviaciones típicas).
+ *
+ * Compilar desde esta carpeta:
+ * `cc -O2 -I.. -o anomalia_simular anomalia_simular.c ../anomalia.c ../control.c -lm`
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "anomalia.h"
+#include "control.h"
+
+#define SEMILLAS 8              ///< Semillas por medida.
+#define MUESTRAS_ARL0 2000000   ///< Muestras estables por semilla para medir las falsas alarmas.
+#define ENSAYOS_DETECCION 200   ///< Cambios aplicados por semilla para medir la detección.
+#define ESTABLE 2000            ///< Muestras estables entre el aprendizaje y el cambio.
+#define DETECCION_MAX 200000    ///< Muestras tras el cambio sin alarma que cuentan como no detectado.
+#define MEDIA 500.0             ///< Media de la señal simulada (g).
+#define DESVIACION 15.0         ///< Desviación de la señal simulada (g), la de la celda girando.
+
+static uint64_t estado_azar; ///< Estado del generador (xorshift64*).
+
+/**
+ * @brief Número uniforme en (0, 1).
+ */
+static double uniforme(void) {
+    estado_azar ^= estado_azar >> 12;
+    estado_azar ^= estado_azar << 25;
+    estado_azar ^= estado_azar >> 27;
+    return ((estado_azar * 2685821657736338717ull >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/**
+ * @brief Número con distribución normal estándar (Box-Muller).
+ */
+static double normal(void) {
+    return sqrt(-2.0 * log(uniforme())) * cos(6.283185307179586 * uniforme());
+}
+
+/**
+ * @brief Muestra de la señal: media y desviación en múltiplos de las nominales.
+ */
+static int32_t muestra(double desplazamiento, double escala) {
+    return (int32_t)lround(MEDIA + DESVIACION * (desplazamiento + escala * normal()));
+}
+
+/**
+ * @brief Reinicia el detector y le hace aprender la línea base.
+ */
+static void aprender(anomalia_t *a, const anomalia_config_t *cfg) {
+    anomalia_iniciar(a, cfg);
+    for (int i = 0; i < cfg->aprendizaje; i++) {
+        anomalia_actualizar(a, muestra(0, 1));
+    }
+}
+
+/**
+ * @brief Plazo medio entre falsas alarmas, en muestras.
+ */
+static double medir_arl0(const anomalia_config_t *cfg, uint32_t *alarmas) {
+    anomalia_t a;
+    aprender(&a, cfg);
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < MUESTRAS_ARL0; i++) {
+        if (anomalia_actualizar(&a, muestra(0, 1)) != ANOMALIA_NINGUNA) n++;
+    }
+    *alarmas = n;
+    return n ? (double)MUESTRAS_ARL0 / n : INFINITY;
+}
+
+/**
+ * @brief Retardo medio de detección de un cambio; cuenta los no detectados.
+ */
+static double medir_deteccion(const anomalia_config_t *cfg, double desplazamiento, double escala,
+                              anomalia_resultado_t esperada, uint32_t *perdidos) {
+    double suma = 0;
+    uint32_t detectados = 0;
+    *perdidos = 0;
+    for (int e = 0; e < ENSAYOS_DETECCION; e++) {
+        anomalia_t a;
+        aprender(&a, cfg);
+        for (int i = 0; i < ESTABLE; i++) {
+            anomalia_actualizar(&a, muestra(0, 1));
+        }
+        a.s_sube = a.s_baja = a.s_varianza = 0; // Cada ensayo parte de las sumas en 0
+        uint32_t i = 1;
+        while (i <= DETECCION_MAX && anomalia_actualizar(&a, muestra(desplazamiento, escala)) != esperada) i++;
+        if (i > DETECCION_MAX) {
+            (*perdidos)++;
+        } else {
+            suma += i;
+            detectados++;
+        }
+    }
+    return detectados ? suma / detectados : INFINITY;
+}
+
+int main(int argc, char **argv) {
+    anomalia_config_t cfg = control_anomalia_cfg;
+    if (argc == 5) {
+        cfg.k_media_q8 = (int32_t)lround(atof(argv[1]) * 256);
+        cfg.h_media_q8 = (int32_t)lround(atof(argv[2]) * 256);
+        cfg.k_varianza_q8 = (int32_t)lround(atof(argv[3]) * 256);
+        cfg.h_varianza_q8 = (int32_t)lround(atof(argv[4]) * 256);
+    } else if (argc != 1) {
+        fprintf(stderr, "uso: anomalia_simular [k_media h_media k_varianza h_varianza]\n");
+        return 2;
+    }
+    printf("media k = %.2f, h = %.2f; varianza k = %.2f, h = %.2f; base 2^%u, aprendizaje %u\n",
+           cfg.k_media_q8 / 256.0, cfg.h_media_q8 / 256.0, cfg.k_varianza_q8 / 256.0,
+           cfg.h_varianza_q8 / 256.0, cfg.log2_base, cfg.aprendizaje);
+    printf("semilla   ARL0   deriva 1 desv.   varianza doble\n");
+    for (int s = 1; s <= SEMILLAS; s++) {
+        estado_azar = 0x9E3779B97F4A7C15ull * (uint64_t)s;
+        uint32_t alarmas, perdidos_media, perdidos_varianza;
+        double arl0 = medir_arl0(&cfg, &alarmas);
+        double media = medir_deteccion(&cfg, 1.0, 1.0, ANOMALIA_SUBE, &perdidos_media);
+        double varianza = medir_deteccion(&cfg, 0.0, sqrt(2.0), ANOMALIA_VARIANZA, &perdidos_varianza);
+        printf("%7d %7.0f %9.1f (%u perd.) %9.1f (%u perd.)\n", s, arl0, media, perdidos_media,
+               varianza, perdidos_varianza);
+    }
+    return 0;
+}
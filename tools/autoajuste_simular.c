@@ -0,0 +1,166 @@
+/**
+ * @file autoajuste_simular.c
+ * @brief Simulación en el PC del autoajuste del lazo de velocidad sobre una planta de
+ * primer orden con retardo.
+ *
+ * El tambor se modela como `rpm' = (K·u - rpm) / tau` con un tiempo muerto `L` en la
+ * entrada, más el ruido de cuantización de la medida de rpm. La simulación repite lo que
+ * hace `tick_control()` en Final_dig.c cada `CONTROL_PERIODO_US`: filtra la velocidad,
+ * ejecuta el ensayo del relé con los mismos parámetros que `autoajustar_velocidad()` y,
+ * con las ganancias obtenidas, cierra el lazo como `regular_velocidad()`. Luego aplica un
+ * escalón de carga (la ganancia de la planta baja un 20 %) y mide cuánto tarda la velocidad
+ * en volver a la banda de ±2 % de la referencia.
+ *
+ * Uso: `autoajuste_simular [-z] [K tau_ms L_ms]` (K en rpm por milésima del PWM). Por defecto
+ * K = 0,43, tau = 400 ms y L = 60 ms, del orden de lo que se ve en el tambor. Con `-z` las
+ * ganancias salen de la regla de Ziegler-Nichols en vez de la de Tyreus-Luyben.
+ *
+ * Compilar desde esta carpeta:
+ * `cc -O2 -I.. -o autoajuste_simular autoajuste_simular.c ../autoajuste.c ../pid.c -lm`
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "autoajuste.h"
+#include "pid.h"
+
+#define CONTROL_PERIODO_US 20000   ///< Periodo del tick de control (como en Final_dig.c).
+#define SUBPASOS 20                ///< Pasos de integración de la planta por tick.
+#define RETARDO_MAX 256            ///< Ticks de tiempo muerto admitidos.
+#define MOTOR_VELOCIDAD_MAX 1000   ///< Salida máxima (milésimas del PWM).
+#define RUIDO_RPM 3.0              ///< Ruido de la medida de rpm (uniforme, ±).
+#define CARGA 0.8                  ///< Ganancia de la planta tras el escalón de carga.
+#define BANDA 0.02                 ///< Banda de recuperación, fracción de la referencia.
+#define REFERENCIA 700             ///< Referencia del lazo cerrado (milésimas del PWM).
+#define PLAZO_LAZO_S 10            ///< Duración del ensayo en lazo cerrado tras el escalón.
+
+/**
+ * @brief Planta de primer orden con tiempo muerto.
+ */
+typedef struct {
+    double k;                     ///< Ganancia estática (rpm por milésima).
+    double tau_s;                 ///< Constante de tiempo.
+    int retardo;                  ///< Tiempo muerto, en ticks.
+    int32_t entradas[RETARDO_MAX]; ///< Entradas aplicadas en los últimos ticks.
+    uint32_t tick;                ///< Ticks transcurridos.
+    double rpm;                   ///< Velocidad del tambor.
+} planta_t;
+
+static uint64_t estado_azar = 0x9E3779B97F4A7C15ull; ///< Estado del generador (xorshift64*).
+
+/**
+ * @brief Número uniforme en [-1, 1).
+ */
+static double ruido(void) {
+    estado_azar ^= estado_azar >> 12;
+    estado_azar ^= estado_azar << 25;
+    estado_azar ^= estado_azar >> 27;
+    return (double)(estado_azar * 2685821657736338717ull >> 11) / 4503599627370496.0 - 1.0;
+}
+
+/**
+ * @brief Aplica una entrada durante un tick y devuelve la velocidad medida al final.
+ */
+static int32_t planta_paso(planta_t *p, int32_t u) {
+    p->entradas[p->tick % RETARDO_MAX] = u;
+    int32_t efectiva = p->tick >= (uint32_t)p->retardo ? p->entradas[(p->tick - p->retardo) % RETARDO_MAX] : 0;
+    p->tick++;
+    double dt = CONTROL_PERIODO_US / 1e6 / SUBPASOS;
+    for (int i = 0; i < SUBPASOS; i++) {
+        p->rpm += (p->k * efectiva - p->rpm) * dt / p->tau_s;
+    }
+    return (int32_t)lround(p->rpm + RUIDO_RPM * ruido());
+}
+
+int main(int argc, char **argv) {
+    planta_t planta = { .k = 0.43, .tau_s = 0.4 };
+    double l_ms = 60;
+    autoajuste_regla_t regla = AUTOAJUSTE_TYREUS_LUYBEN;
+    if (argc > 1 && strcmp(argv[1], "-z") == 0) {
+        regla = AUTOAJUSTE_ZIEGLER_NICHOLS;
+        argc--;
+        argv++;
+    }
+    if (argc == 4) {
+        planta.k = atof(argv[1]);
+        planta.tau_s = atof(argv[2]) / 1000.0;
+        l_ms = atof(argv[3]);
+    } else if (argc != 1) {
+        fprintf(stderr, "uso: autoajuste_simular [-z] [K tau_ms L_ms]\n");
+        return 2;
+    }
+    planta.retardo = (int)lround(l_ms * 1000 / CONTROL_PERIODO_US);
+    if (planta.k <= 0 || planta.tau_s <= 0 || planta.retardo < 0 || planta.retardo >= RETARDO_MAX) {
+        fprintf(stderr, "planta fuera de rango\n");
+        return 2;
+    }
+    printf("planta: K = %.3f rpm/milésima, tau = %.0f ms, L = %d ms\n", planta.k, planta.tau_s * 1000,
+           planta.retardo * CONTROL_PERIODO_US / 1000);
+
+    // Ensayo del relé, con la configuración de autoajustar_velocidad()
+    const autoajuste_config_t cfg = {
+        .regla = regla,
+        .u0 = 700,
+        .d = 100,
+        .histeresis = 20,
+        .ciclos = 4,
+        .asentamiento_us = 2000000,
+        .plazo_us = 20000000,
+        .excursion_max = 600,
+    };
+    autoajuste_t a;
+    autoajuste_iniciar(&a, &cfg);
+    int32_t u = cfg.u0;
+    int32_t rpm_filtrada = 0;
+    uint32_t ticks = 0;
+    while (a.estado == AUTOAJUSTE_ASENTANDO || a.estado == AUTOAJUSTE_RELE) {
+        int32_t medida = planta_paso(&planta, u);
+        rpm_filtrada += (medida - rpm_filtrada) / 4;
+        u = autoajuste_paso(&a, rpm_filtrada, CONTROL_PERIODO_US);
+        ticks++;
+    }
+    pid_ganancias_t g;
+    int32_t rpm_por_milesima_q8;
+    if (!autoajuste_resultado(&a, &g, &rpm_por_milesima_q8)) {
+        printf("autoajuste fallido tras %.2f s (estado %d)\n", ticks * CONTROL_PERIODO_US / 1e6, a.estado);
+        return 1;
+    }
+    printf("autoajuste: %.2f s (%.2f s de relé), Tu = %.0f ms, Kp = %.3f, Ki = %.3f /s, K medida = %.3f\n",
+           ticks * CONTROL_PERIODO_US / 1e6, (ticks * CONTROL_PERIODO_US - cfg.asentamiento_us) / 1e6,
+           (double)a.suma_periodo_us / cfg.ciclos / 1000, g.kp_q16 / 65536.0, g.ki_q16 / 65536.0,
+           rpm_por_milesima_q8 / 256.0);
+
+    // Lazo cerrado como regular_velocidad(): la corrección se suma a la referencia
+    pid_lazo_t lazo;
+    pid_iniciar(&lazo, &g, -MOTOR_VELOCIDAD_MAX, MOTOR_VELOCIDAD_MAX);
+    int32_t rpm_ref = (int32_t)((REFERENCIA * rpm_por_milesima_q8) >> 8);
+    uint32_t escalon = 0, fuera = 0;
+    int32_t minima = INT32_MAX;
+    for (uint32_t t = 0; t < (uint32_t)(2 + PLAZO_LAZO_S) * 1000000 / CONTROL_PERIODO_US; t++) {
+        if (t == 2000000 / CONTROL_PERIODO_US) {
+            planta.k *= CARGA; // Escalón de carga tras 2 s estabilizado
+            escalon = t;
+        }
+        int32_t medida = planta_paso(&planta, u);
+        rpm_filtrada += (medida - rpm_filtrada) / 4;
+        u = REFERENCIA + pid_actualizar(&lazo, rpm_ref - rpm_filtrada, CONTROL_PERIODO_US);
+        if (u < 0) u = 0;
+        if (u > MOTOR_VELOCIDAD_MAX) u = MOTOR_VELOCIDAD_MAX;
+        if (escalon && rpm_filtrada < minima) minima = rpm_filtrada;
+        if (escalon && fabs((double)(rpm_filtrada - rpm_ref)) > BANDA * rpm_ref) fuera = t + 1;
+    }
+    if (fuera >= escalon + PLAZO_LAZO_S * 1000000 / CONTROL_PERIODO_US) {
+        printf("escalón de carga: sin recuperar en %d s (referencia %ld rpm)\n", PLAZO_LAZO_S, (long)rpm_ref);
+        return 1;
+    }
+    printf("escalón de carga del %.0f %%: mínimo %ld rpm de %ld, dentro de ±%.0f %% en %.2f s\n",
+           (1 - CARGA) * 100, (long)minima, (long)rpm_ref, BANDA * 100,
+           fuera > escalon ? (fuera - escalon) * CONTROL_PERIODO_US / 1e6 : 0.0);
+    return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file flash_falsa.c
+ * @brief Implementación de la flash simulada.
+ *
+ * Un borrado o una programación avanzan byte a byte en orden de direcciones, así que un
+ * apagón deja un sector borrado solo hasta cierto punto, o una página a medio programar.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "flash_falsa.h"
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+
+uint8_t flash_falsa[PICO_FLASH_SIZE_BYTES];
+uint32_t flash_falsa_borrados[FLASH_FALSA_SECTORES];
+jmp_buf flash_falsa_apagon;
+
+static int64_t corte = -1;        ///< Bytes hasta el apagón; negativo = sin apagón.
+static bool corte_en_borrado = false; ///< El último apagón cortó un borrado.
+
+void flash_falsa_iniciar(void) {
+    memset(flash_falsa, 0xFF, sizeof(flash_falsa));
+    memset(flash_falsa_borrados, 0, sizeof(flash_falsa_borrados));
+    corte = -1;
+}
+
+void flash_falsa_cortar(int64_t bytes) {
+    corte = bytes;
+}
+
+bool flash_falsa_corte_pendiente(void) {
+    return corte >= 0;
+}
+
+bool flash_falsa_corte_en_borrado(void) {
+    return corte_en_borrado;
+}
+
+/**
+ * @brief Cuenta un byte; salta a `flash_falsa_apagon` si toca el apagón.
+ */
+static void avanzar(bool borrando) {
+    if (corte < 0) return;
+    if (corte-- == 0) {
+        corte_en_borrado = borrando;
+        longjmp(flash_falsa_apagon, 1);
+    }
+}
+
+void flash_range_erase(uint32_t offset, size_t count) {
+    flash_falsa_borrados[offset / FLASH_SECTOR_SIZE]++;
+    for (size_t i = 0; i < count; i++) {
+        avanzar(true);
+        flash_falsa[offset + i] = 0xFF;
+    }
+}
+
+void flash_range_program(uint32_t offset, const uint8_t *data, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        avanzar(false);
+        flash_falsa[offset + i] &= data[i]; // Una NOR solo baja bits al programar
+    }
+}
+
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms) {
+    (void)enter_exit_timeout_ms;
+    func(param);
+    return PICO_OK;
+}
+
+uint32_t time_us_32(void) {
+    return 0;
+}
+
+uint32_t save_and_disable_interrupts(void) {
+    return 0;
+}
+
+void restore_interrupts(uint32_t estado) {
+    (void)estado;
+}
@@ -0,0 +1,50 @@
+/**
+ * @file flash_falsa.h
+ * @brief Flash simulada en el PC, con apagones, para ensayar almacen.c y respaldo.c.
+ *
+ * Reemplaza a las funciones del SDK que usan esos módulos (ver sdk_falso/): la flash es un
+ * arreglo en RAM "mapeado" en `XIP_BASE`. Como en una NOR, programar solo baja bits
+ * (`dato & anterior`) y borrar pone el sector a 0xFF.
+ *
+ * Un apagón se programa con `flash_falsa_cortar()`: tras ese número de bytes programados o
+ * borrados la operación se interrumpe a mitad (los bytes anteriores quedan hechos, los
+ * siguientes no) y se salta con `longjmp()` a `flash_falsa_apagon`, como si el equipo se
+ * reiniciara. El estado en RAM de los módulos queda a medias: hay que volver a iniciarlos.
+ */
+
+#ifndef FLASH_FALSA_H
+#define FLASH_FALSA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <setjmp.h>
+
+#define FLASH_FALSA_SECTORES 8 ///< Sectores simulados: los del almacén y los del respaldo, al final.
+
+extern uint8_t flash_falsa[];                            ///< Contenido de la flash.
+extern uint32_t flash_falsa_borrados[FLASH_FALSA_SECTORES]; ///< Borrados de cada sector.
+extern jmp_buf flash_falsa_apagon;                        ///< Destino del salto en un apagón.
+
+/**
+ * @brief Deja la flash borrada, sin apagón pendiente y con los contadores a 0.
+ */
+void flash_falsa_iniciar(void);
+
+/**
+ * @brief Programa un apagón.
+ *
+ * @param bytes Bytes que se programan o borran antes del corte; negativo = sin apagón.
+ */
+void flash_falsa_cortar(int64_t bytes);
+
+/**
+ * @brief Indica si el apagón programado sigue pendiente (la operación no llegó a él).
+ */
+bool flash_falsa_corte_pendiente(void);
+
+/**
+ * @brief Indica si el último apagón cortó un borrado (si no, una programación).
+ */
+bool flash_falsa_corte_en_borrado(void);
+
+#endif // FLASH_FALSA_H
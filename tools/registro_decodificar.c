@@ -0,0 +1,86 @@
+/**
+ * @file registro_decodificar.c
+ * @brief Decodificador en el PC del registro diferido que llega por el USB.
+ *
+ * Lee el flujo de tramas COBS de la telemetría (un puerto serie ya configurado, un archivo
+ * capturado o la entrada estándar), se queda con las tramas `TELEMETRIA_REGISTRO` y arma
+ * el texto de cada mensaje con el catálogo de `registro_formatos.h`: el mismo archivo que
+ * compila el equipo, así que los números siempre coinciden con los del firmware construido
+ * con esa versión del árbol.
+ *
+ * Compilar desde esta carpeta: `cc -O2 -I.. -o registro_decodificar registro_decodificar.c registro_texto.c ../cobs.c`
+ *
+ * Uso: `registro_decodificar [/dev/ttyACM0]` (sin argumento lee la entrada estándar).
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include <stdio.h>
+#include "cobs.h"
+#include "registro.h"
+#include "telemetria.h"
+#include "registro_texto.h"
+
+#define TRAMA_MAX 256 ///< Tramas más largas se descartan (ruido o desincronización).
+
+/**
+ * @brief Lee un valor little-endian de `n` bytes.
+ */
+static uint32_t tomar(const uint8_t *p, int n) {
+    uint32_t v = 0;
+    for (int i = 0; i < n; i++) {
+        v |= (uint32_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+/**
+ * @brief Muestra una trama decodificada si es un mensaje del registro.
+ */
+static void procesar(const uint8_t *datos, size_t n) {
+    if (n < 7 || datos[0] != TELEMETRIA_REGISTRO || (n - 7) % 4 != 0) return;
+    uint16_t id = (uint16_t)tomar(datos + 1, 2);
+    uint32_t t_us = tomar(datos + 3, 4);
+    uint32_t args[REGISTRO_ARGS_MAX];
+    int nargs = (int)((n - 7) / 4);
+    if (nargs > REGISTRO_ARGS_MAX) return;
+    for (int i = 0; i < nargs; i++) {
+        args[i] = tomar(datos + 7 + 4 * i, 4);
+    }
+    char texto[256];
+    registro_texto(texto, sizeof(texto), id, args, nargs);
+    printf("%10.6f  %s\n", t_us / 1e6, texto);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    FILE *entrada = stdin;
+    if (argc > 1) {
+        entrada = fopen(argv[1], "rb");
+        if (!entrada) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+    uint8_t trama[TRAMA_MAX];
+    uint8_t datos[TRAMA_MAX];
+    size_t largo = 0;
+    bool desbordada = false;
+    int c;
+    while ((c = fgetc(entrada)) != EOF) {
+        if (c != 0) {
+            if (largo < sizeof(trama)) {
+                trama[largo++] = (uint8_t)c;
+            } else {
+                desbordada = true;
+            }
+            continue;
+        }
+        size_t n = desbordada ? 0 : cobs_decodificar(trama, largo, datos);
+        if (n > 0) procesar(datos, n);
+        largo = 0;
+        desbordada = false;
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file registro_texto.c
+ * @brief Implementación del armado de los mensajes del registro en el PC.
+ *
+ * El catálogo se incluye tal cual lo compila el equipo. Las conversiones se aplican de a
+ * una con `snprintf`, quitando los modificadores de longitud: los argumentos viajan
+ * siempre como 32 bits.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "registro_texto.h"
+#include <stdio.h>
+#include <string.h>
+#include "registro.h"
+
+#define REGISTRO_FORMATO(nombre, formato) [nombre] = formato,
+/// Texto de cada mensaje, indexado por su número.
+static const char *const formatos[REGISTRO_NUM] = {
+#include "registro_formatos.h"
+};
+#undef REGISTRO_FORMATO
+
+/**
+ * @brief Aplica un formato del catálogo a los argumentos.
+ */
+static void formatear(char *salida, size_t tam, const char *formato, const uint32_t *args, int n) {
+    size_t len = 0;
+    int arg = 0;
+    for (const char *f = formato; *f && len + 1 < tam; f++) {
+        if (*f != '%') {
+            salida[len++] = *f;
+            continue;
+        }
+        if (f[1] == '%') {
+            salida[len++] = '%';
+            f++;
+            continue;
+        }
+        // Especificación sin los modificadores de longitud: banderas, ancho y precisión
+        char spec[16] = "%";
+        size_t k = 1;
+        f++;
+        while (*f && strchr("-+ #0123456789.", *f) && k < sizeof(spec) - 2) spec[k++] = *f++;
+        while (*f == 'l' || *f == 'h' || *f == 'z') f++;
+        if (!*f) break;
+        spec[k++] = *f;
+        spec[k] = '\0';
+        uint32_t v = arg < n ? args[arg] : 0;
+        arg++;
+        int escrito;
+        switch (*f) {
+        case 'd': case 'i':
+            escrito = snprintf(salida + len, tam - len, spec, (int)(int32_t)v);
+            break;
+        case 'f': case 'e': case 'g': {
+            union { uint32_t u; float f; } r = { .u = v };
+            escrito = snprintf(salida + len, tam - len, spec, (double)r.f);
+            break;
+        }
+        default: // u, x, X, o, c
+            escrito = snprintf(salida + len, tam - len, spec, (unsigned)v);
+            break;
+        }
+        if (escrito < 0) break;
+        len += (size_t)escrito < tam - len ? (size_t)escrito : tam - len - 1;
+    }
+    salida[len] = '\0';
+}
+
+void registro_texto(char *salida, size_t tam, uint16_t id, const uint32_t *args, int n) {
+    if (id >= REGISTRO_NUM) {
+        snprintf(salida, tam, "mensaje %u desconocido (firmware de otra versión)", id);
+        return;
+    }
+    formatear(salida, tam, formatos[id], args, n);
+}
@@ -0,0 +1,25 @@
+/**
+ * @file registro_texto.h
+ * @brief Texto de los mensajes del registro diferido, armado en el PC con el catálogo.
+ */
+
+#ifndef REGISTRO_TEXTO_H
+#define REGISTRO_TEXTO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Arma el texto de un mensaje como lo haría `printf` en el equipo.
+ *
+ * Cada conversión del formato toma el siguiente argumento; los que faltan valen 0. Un
+ * número fuera del catálogo (firmware de otra versión) se indica en el texto.
+ * @param salida Destino.
+ * @param tam Capacidad del destino.
+ * @param id Número del mensaje (`registro_id_t`).
+ * @param args Argumentos recibidos.
+ * @param n Número de argumentos.
+ */
+void registro_texto(char *salida, size_t tam, uint16_t id, const uint32_t *args, int n);
+
+#endif // REGISTRO_TEXTO_H
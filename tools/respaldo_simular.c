@@ -0,0 +1,169 @@
+/**
+ * @file respaldo_simular.c
+ * @brief Simulación en el PC del punto de control (respaldo.h) con apagones al azar.
+ *
+ * Repite trabajos sobre la flash simulada (flash_falsa.h), como los hace Final_dig.c:
+ * arma el respaldo, guarda puntos de control hasta llenar el sector (a veces), y termina
+ * de una de tres formas: cierre normal (`respaldo_cerrar()`), caída con el punto de control
+ * final (`respaldo_guardar_final()`) o reinicio a mitad del trabajo. Tras cada reinicio,
+ * un punto de control pendiente se reanuda (el trabajo siguiente vuelve a armar) o se
+ * descarta. Algunos ciclos se cortan con un apagón en un byte al azar de lo que programan
+ * o borran, incluido el borrado al armar.
+ *
+ * Tras cada reinicio se comprueba que `respaldo_iniciar()` y `respaldo_leer()` dan el último
+ * punto de control confirmado (o ninguno si se cerró); solo si el apagón cortó una
+ * escritura puede aparecer, en su lugar, la que se estaba haciendo. También se comprueba
+ * que con el sector lleno siempre caben el punto de control final y el cierre.
+ *
+ * Uso: `respaldo_simular [ciclos [semilla]]` (por defecto 100000 y 1).
+ *
+ * Compilar desde esta carpeta:
+ * `cc -O2 -I.. -I. -Isdk_falso -o respaldo_simular respaldo_simular.c flash_falsa.c ../respaldo.c ../almacen.c`
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "respaldo.h"
+#include "flash_falsa.h"
+
+#define LONGITUD 40          ///< Bytes de cada punto de control (del orden de `punto_control_t`).
+#define GUARDADOS_MAX 20     ///< Puntos de control por trabajo: a veces más de los que caben.
+#define CORTE_UNO_EN 5       ///< Ciclos por apagón programado (de media).
+#define CORTE_BYTES_MAX 8192 ///< Bytes hasta el apagón: abarca el borrado y las páginas del ciclo.
+
+/**
+ * @brief Operación en curso, que un apagón puede dejar a medias.
+ */
+typedef enum {
+    OPERACION_NINGUNA = 0,
+    OPERACION_GUARDAR,   ///< Guardando `en_curso`.
+    OPERACION_CERRAR,    ///< Anulando el punto de control.
+} operacion_t;
+
+static uint64_t estado_azar;           ///< Estado del generador (xorshift64*).
+static operacion_t operacion;          ///< Operación en curso.
+static uint8_t en_curso[LONGITUD];     ///< Datos que se están guardando.
+static bool hay_confirmado = false;    ///< Hay un punto de control confirmado sin anular.
+static uint8_t confirmado[LONGITUD];   ///< Último punto de control confirmado.
+static uint32_t errores = 0;           ///< Comprobaciones fallidas.
+static uint32_t llenos = 0;            ///< Trabajos que llenaron el sector.
+static uint32_t reanudados = 0;        ///< Puntos de control finales reanudados.
+
+/**
+ * @brief Número al azar de 32 bits.
+ */
+static uint32_t azar(void) {
+    estado_azar ^= estado_azar >> 12;
+    estado_azar ^= estado_azar << 25;
+    estado_azar ^= estado_azar >> 27;
+    return (uint32_t)((estado_azar * 2685821657736338717ull) >> 32);
+}
+
+/**
+ * @brief Guarda un punto de control con datos al azar y lo confirma si se escribió.
+ */
+static bool guardar(bool final) {
+    for (int i = 0; i < LONGITUD; i++) en_curso[i] = (uint8_t)azar();
+    operacion = OPERACION_GUARDAR;
+    bool ok = final ? respaldo_guardar_final(en_curso, LONGITUD) : respaldo_guardar(en_curso, LONGITUD);
+    if (ok) {
+        memcpy(confirmado, en_curso, LONGITUD);
+        hay_confirmado = true;
+    }
+    operacion = OPERACION_NINGUNA;
+    return ok;
+}
+
+/**
+ * @brief Anula el punto de control.
+ */
+static void cerrar(void) {
+    operacion = OPERACION_CERRAR;
+    respaldo_cerrar();
+    hay_confirmado = false;
+    operacion = OPERACION_NINGUNA;
+}
+
+/**
+ * @brief Reinicia el respaldo y compara lo que encuentra con lo confirmado.
+ *
+ * @return `true` si hay un punto de control pendiente.
+ */
+static bool reiniciar_y_comprobar(void) {
+    bool hay = respaldo_iniciar();
+    uint8_t leido[LONGITUD];
+    bool leyo = respaldo_leer(leido, LONGITUD);
+    if (hay != leyo) {
+        errores++;
+    } else if (operacion == OPERACION_GUARDAR && leyo && memcmp(leido, en_curso, LONGITUD) == 0) {
+        memcpy(confirmado, en_curso, LONGITUD); // La escritura cortada llegó a confirmarse
+        hay_confirmado = true;
+    } else if (operacion == OPERACION_CERRAR && !hay) {
+        hay_confirmado = false; // El cierre cortado llegó a escribirse
+    } else if (hay != hay_confirmado || (hay && memcmp(leido, confirmado, LONGITUD) != 0)) {
+        errores++;
+    }
+    operacion = OPERACION_NINGUNA;
+    return hay;
+}
+
+int main(int argc, char **argv) {
+    uint32_t ciclos = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 100000;
+    estado_azar = 0x9E3779B97F4A7C15ull * (argc > 2 ? strtoull(argv[2], NULL, 10) : 1);
+    if (argc > 3 || ciclos == 0 || estado_azar == 0) {
+        fprintf(stderr, "uso: respaldo_simular [ciclos [semilla]]\n");
+        return 2;
+    }
+
+    flash_falsa_iniciar();
+    respaldo_iniciar();
+    uint32_t cortes_programando = 0, cortes_borrando = 0;
+    for (uint32_t c = 0; c < ciclos; c++) {
+        flash_falsa_cortar(azar() % CORTE_UNO_EN == 0 ? (int64_t)(azar() % CORTE_BYTES_MAX) : -1);
+        if (setjmp(flash_falsa_apagon)) { // Apagón: el respaldo quedó a medias
+            if (flash_falsa_corte_en_borrado()) cortes_borrando++;
+            else cortes_programando++;
+            if (reiniciar_y_comprobar() && azar() % 2) cerrar(); // Descartado en el menú
+            continue;
+        }
+
+        if (!respaldo_armar()) errores++; // Sin apagón no debería fallar
+        uint32_t n = azar() % (GUARDADOS_MAX + 1);
+        bool lleno = false;
+        for (uint32_t i = 0; i < n && !lleno; i++) {
+            lleno = !guardar(false);
+        }
+        if (lleno) llenos++;
+
+        switch (azar() % 3) {
+        case 0: // Caída: punto de control final con el tambor detenido, aun con el sector lleno
+            if (!guardar(true)) errores++;
+            flash_falsa_cortar(-1);
+            if (!reiniciar_y_comprobar()) errores++;
+            reanudados++; // El ciclo siguiente vuelve a armar y sigue guardando
+            break;
+        case 1: // Trabajo terminado
+            cerrar();
+            flash_falsa_cortar(-1);
+            if (reiniciar_y_comprobar()) errores++;
+            break;
+        default: // Reinicio a mitad del trabajo (watchdog)
+            flash_falsa_cortar(-1);
+            if (reiniciar_y_comprobar() && azar() % 2) cerrar();
+            break;
+        }
+    }
+    flash_falsa_cortar(-1);
+    reiniciar_y_comprobar();
+
+    printf("%u ciclos, %u con el sector lleno, %u puntos de control finales reanudados\n", ciclos, llenos,
+           reanudados);
+    printf("%u apagones (%u programando, %u borrando), comprobaciones fallidas: %u\n",
+           cortes_programando + cortes_borrando, cortes_programando, cortes_borrando, errores);
+    return errores ? 1 : 0;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file flash.h
+ * @brief Sustituto en el PC de `hardware/flash.h` sobre la flash simulada (flash_falsa.h).
+ */
+
+#ifndef SDK_FALSO_HARDWARE_FLASH_H
+#define SDK_FALSO_HARDWARE_FLASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "flash_falsa.h"
+
+#define FLASH_PAGE_SIZE 256u    ///< Unidad de programación.
+#define FLASH_SECTOR_SIZE 4096u ///< Unidad de borrado.
+#define PICO_FLASH_SIZE_BYTES (FLASH_FALSA_SECTORES * FLASH_SECTOR_SIZE) ///< Solo los sectores simulados.
+#define XIP_BASE ((uintptr_t)flash_falsa) ///< La flash "mapeada" es el arreglo simulado.
+
+/**
+ * @brief Borra `count` bytes (sectores enteros) desde `offset`.
+ */
+void flash_range_erase(uint32_t offset, size_t count);
+
+/**
+ * @brief Programa `count` bytes (páginas enteras) desde `offset`.
+ */
+void flash_range_program(uint32_t offset, const uint8_t *data, size_t count);
+
+#endif // SDK_FALSO_HARDWARE_FLASH_H
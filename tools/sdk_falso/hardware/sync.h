@@ -0,0 +1,21 @@
+/**
+ * @file sync.h
+ * @brief Sustituto en el PC de `hardware/sync.h`: no hay interrupciones que desactivar.
+ */
+
+#ifndef SDK_FALSO_HARDWARE_SYNC_H
+#define SDK_FALSO_HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+/**
+ * @brief No hace nada; devuelve 0.
+ */
+uint32_t save_and_disable_interrupts(void);
+
+/**
+ * @brief No hace nada.
+ */
+void restore_interrupts(uint32_t estado);
+
+#endif // SDK_FALSO_HARDWARE_SYNC_H
@@ -0,0 +1,16 @@
+/**
+ * @file flash.h
+ * @brief Sustituto en el PC de `pico/flash.h`: la operación se ejecuta en el acto.
+ */
+
+#ifndef SDK_FALSO_PICO_FLASH_H
+#define SDK_FALSO_PICO_FLASH_H
+
+#include <stdint.h>
+
+/**
+ * @brief Ejecuta `func(param)`; siempre devuelve `PICO_OK`.
+ */
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms);
+
+#endif // SDK_FALSO_PICO_FLASH_H
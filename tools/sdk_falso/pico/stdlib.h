@@ -0,0 +1,19 @@
+/**
+ * @file stdlib.h
+ * @brief Sustituto en el PC de `pico/stdlib.h` para las simulaciones de la flash (flash_falsa.h).
+ */
+
+#ifndef SDK_FALSO_PICO_STDLIB_H
+#define SDK_FALSO_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define PICO_OK 0 ///< Resultado correcto de las funciones del SDK.
+
+/**
+ * @brief Reloj del equipo; en la simulación vale siempre 0.
+ */
+uint32_t time_us_32(void);
+
+#endif // SDK_FALSO_PICO_STDLIB_H
@@ -0,0 +1,782 @@
+/**
+ * @file telemetria_cli.c
+ * @brief Herramienta del PC para la telemetría: captura, decodificación, estadísticas y reproducción.
+ *
+ * Subórdenes:
+ * - `capturar [-o DIR] [-t SEG] DISPOSITIVO...`: abre los puertos USB de una o varias
+ *   bobinadoras (DTR activo: el equipo empieza a muestrear), guarda el flujo crudo de cada
+ *   una en `DIR/<nombre>.bin` y a la vez lo decodifica. Termina con Ctrl+C o a los SEG s.
+ * - `decodificar [-o DIR] ARCHIVO...`: decodifica capturas (`-` = entrada estándar, p. ej.
+ *   la salida de un simulador en el PC o de `reproducir`).
+ * - `reproducir [-x FACTOR] [-d SALIDA] ARCHIVO`: reenvía una captura con sus tiempos
+ *   originales (FACTOR veces más rápido; 0 = sin esperas) a la salida estándar o a SALIDA
+ *   (un pty o un puerto), como si fuera el equipo.
+ * - `traza volcar [-o DIR] DISPOSITIVO`: descarga la traza de los sensores del equipo
+ *   (traza.h) a `DIR/<nombre>_traza.csv`. Una línea `# tara=...,pulsos_por_vuelta=...` lleva
+ *   la cabecera de la traza (`traza_cabecera_t`), que usa tools/traza_reproducir.c.
+ * - `traza cargar DISPOSITIVO ARCHIVO.csv`: envía una traza descargada a un equipo (el del
+ *   banco) y le pide reproducirla en el próximo trabajo.
+ *
+ * Por cada entrada se escriben tablas CSV por columnas: `<nombre>_muestras.csv`,
+ * `<nombre>_fallas.csv`, `<nombre>_registro.csv` y `<nombre>_trabajos.csv`. La última
+ * tiene una fila por trabajo, delimitado por los mensajes de inicio y fin del registro:
+ * duración, avance (metros por minuto o vueltas por minuto), distribución de la tensión y
+ * muestras perdidas. Los tiempos se extienden a 64 bits (el reloj del equipo da la vuelta
+ * cada 71 minutos).
+ *
+ * Todas las entradas se atienden en un solo hilo con `poll()`: a 1 kHz cada equipo envía
+ * unos 23 kB/s, lejos del límite de un PC.
+ *
+ * Compilar desde esta carpeta:
+ * `cc -O2 -I.. -o telemetria telemetria_cli.c registro_texto.c ../cobs.c`
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <termios.h>
+#include "cobs.h"
+#include "telemetria.h"
+#include "registro.h"
+#include "fallas.h"
+#include "remoto.h"
+#include "traza.h"
+#include "registro_texto.h"
+
+#define ENTRADAS_MAX 16        ///< Equipos o archivos atendidos a la vez.
+#define TRAMA_MAX 256          ///< Tramas más largas se descartan (ruido o desincronización).
+#define TENSION_HISTOGRAMA 2048 ///< Gramos cubiertos por el histograma de la tensión (1 g por casilla).
+#define PULSOS_POR_KM_FABRICA 2273642 ///< Escala de fábrica (tambor de 1.4 cm).
+#define PULSOS_POR_VUELTA_FABRICA 100 ///< Pulsos del encoder por vuelta del tambor, de fábrica.
+#define ORDEN_ESPERA_MS 250    ///< Espera de la respuesta a una orden antes de reintentarla.
+#define ORDEN_INTENTOS 8       ///< Intentos de cada orden.
+#define VOLCADO_ESPERA_MS 2000 ///< Silencio que da por cortado el volcado de la traza.
+#define TRAZA_COLUMNAS "posicion,t_us,tipo,canal,valor" ///< Encabezado de la tabla de la traza.
+
+/// Nombre de cada falla en las tablas.
+static const char *const nombres_falla[FALLA_NUM] = {
+    [FALLA_NINGUNA] = "",
+    [FALLA_TENSION_ALTA] = "tension_alta",
+    [FALLA_TENSION_BAJA] = "tension_baja",
+    [FALLA_ROTURA] = "rotura",
+    [FALLA_ENCODER_DETENIDO] = "encoder_detenido",
+    [FALLA_ATASCO] = "atasco",
+    [FALLA_SOBRECARGA] = "sobrecarga",
+    [FALLA_BUS_PANTALLA] = "bus_pantalla",
+    [FALLA_WATCHDOG] = "watchdog",
+    [FALLA_ANOMALIA] = "anomalia",
+    [FALLA_ALIMENTACION] = "alimentacion",
+};
+
+/**
+ * @brief Estadísticas del trabajo en curso de un equipo.
+ */
+typedef struct {
+    bool activo;            ///< Entre el inicio y el fin del trabajo.
+    uint64_t inicio_us;     ///< Instante del inicio.
+    uint32_t tipo;          ///< `trabajo_tipo_t`.
+    uint32_t material;      ///< Material.
+    int32_t desde;          ///< Pulsos al empezar (al reanudar no es 0).
+    int32_t objetivo;       ///< Pulsos objetivo; 0 = continuo.
+    uint64_t muestras;      ///< Muestras recibidas durante el trabajo.
+    uint64_t huecos;        ///< Muestras perdidas durante el trabajo.
+    int64_t suma_tension;   ///< Suma de la tensión de las muestras.
+    int32_t tension_max;    ///< Máximo de la tensión.
+    uint32_t histograma[TENSION_HISTOGRAMA]; ///< Muestras por gramo de tensión.
+} trabajo_est_t;
+
+/**
+ * @brief Estado de una entrada (un equipo o una captura).
+ */
+typedef struct {
+    char nombre[64];        ///< Prefijo de los archivos de salida.
+    const char *dir;        ///< Carpeta de los archivos de salida.
+    int fd;                 ///< Descriptor de lectura; -1 = terminada.
+    FILE *crudo;            ///< Copia del flujo crudo (solo al capturar).
+    FILE *muestras;         ///< Tabla de muestras.
+    FILE *fallas;           ///< Tabla de fallas.
+    FILE *registro;         ///< Tabla de mensajes del registro.
+    FILE *trabajos;         ///< Tabla de trabajos.
+    FILE *traza;            ///< Tabla de la traza de los sensores (se abre con el primer evento).
+    uint32_t traza_recibidos; ///< Eventos de la traza recibidos.
+    bool con_respuesta;     ///< Llegó una respuesta a una orden.
+    uint8_t respuesta[REMOTO_RESPUESTA_MAX]; ///< Última respuesta (con el tipo).
+    size_t respuesta_largo; ///< Bytes de `respuesta`.
+    uint8_t trama[TRAMA_MAX]; ///< Bytes de la trama en curso.
+    size_t largo;           ///< Bytes en `trama`.
+    bool desbordada;        ///< La trama en curso no cabe: se descarta.
+    bool con_tiempo;        ///< Ya se recibió algún instante.
+    uint32_t ultimo_t;      ///< Último instante del equipo (32 bits).
+    uint64_t t_us;          ///< Último instante extendido a 64 bits.
+    bool con_secuencia;     ///< Ya se recibió alguna muestra.
+    uint16_t secuencia;     ///< Secuencia esperada de la próxima muestra.
+    uint64_t n_muestras;    ///< Muestras recibidas.
+    uint64_t huecos;        ///< Muestras perdidas (saltos de la secuencia).
+    uint64_t malas;         ///< Tramas mal formadas o desconocidas.
+    uint32_t pulsos_por_km; ///< Escala del tambor informada por el equipo.
+    uint32_t pulsos_por_vuelta; ///< Pulsos por vuelta informados por el equipo.
+    unsigned n_trabajos;    ///< Trabajos cerrados.
+    trabajo_est_t trabajo;  ///< Trabajo en curso.
+} entrada_t;
+
+static volatile sig_atomic_t detener = 0; ///< Ctrl+C recibido.
+
+/**
+ * @brief Marca la parada pedida con Ctrl+C.
+ */
+static void al_interrumpir(int senal) {
+    (void)senal;
+    detener = 1;
+}
+
+/**
+ * @brief Lee un valor little-endian de `n` bytes.
+ */
+static uint32_t tomar(const uint8_t *p, int n) {
+    uint32_t v = 0;
+    for (int i = 0; i < n; i++) {
+        v |= (uint32_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+/**
+ * @brief Extiende un instante del equipo a 64 bits.
+ *
+ * Los instantes llegan casi en orden (un mensaje del registro puede ser algo más antiguo
+ * que la última muestra): se toma la diferencia con signo respecto del último.
+ */
+static uint64_t extender(entrada_t *e, uint32_t t) {
+    if (!e->con_tiempo) {
+        e->con_tiempo = true;
+        e->ultimo_t = t;
+        e->t_us = t;
+        return t;
+    }
+    int32_t delta = (int32_t)(t - e->ultimo_t);
+    uint64_t ext = e->t_us + (int64_t)delta;
+    if (delta > 0) {
+        e->ultimo_t = t;
+        e->t_us = ext;
+    }
+    return ext;
+}
+
+/**
+ * @brief Termina si `snprintf` no pudo escribir el texto completo (ruta demasiado larga).
+ *
+ * @param escrito Valor devuelto por `snprintf`.
+ * @param tam Tamaño del destino.
+ * @param que Texto para el mensaje de error.
+ */
+static void exigir_completo(int escrito, size_t tam, const char *que) {
+    if (escrito < 0 || (size_t)escrito >= tam) {
+        fprintf(stderr, "%s: ruta demasiado larga\n", que);
+        exit(1);
+    }
+}
+
+/**
+ * @brief Abre una tabla de salida y escribe su encabezado.
+ */
+static FILE *abrir_tabla(const char *dir, const char *nombre, const char *sufijo, const char *encabezado) {
+    char ruta[512];
+    exigir_completo(snprintf(ruta, sizeof(ruta), "%s/%s_%s.csv", dir, nombre, sufijo), sizeof(ruta), dir);
+    FILE *f = fopen(ruta, "w");
+    if (!f) {
+        perror(ruta);
+        exit(1);
+    }
+    fprintf(f, "%s\n", encabezado);
+    return f;
+}
+
+/**
+ * @brief Prepara una entrada: nombre a partir de la ruta y tablas de salida.
+ */
+static void abrir_entrada(entrada_t *e, int fd, const char *ruta, const char *dir) {
+    memset(e, 0, sizeof(*e));
+    e->fd = fd;
+    e->dir = dir;
+    e->pulsos_por_km = PULSOS_POR_KM_FABRICA;
+    e->pulsos_por_vuelta = PULSOS_POR_VUELTA_FABRICA;
+    const char *base = strcmp(ruta, "-") == 0 ? "entrada" : strrchr(ruta, '/') ? strrchr(ruta, '/') + 1 : ruta;
+    exigir_completo(snprintf(e->nombre, sizeof(e->nombre), "%s", base), sizeof(e->nombre), ruta);
+    char *punto = strrchr(e->nombre, '.');
+    if (punto && punto != e->nombre) *punto = '\0';
+    if (!dir) return; // Solo órdenes: sin tablas
+
+    e->muestras = abrir_tabla(dir, e->nombre, "muestras",
+                              "t_s,secuencia,pulsos,traslado_mgrad,rpm,tension_g,pwm");
+    e->fallas = abrir_tabla(dir, e->nombre, "fallas", "t_s,falla,nombre,reaccion_us");
+    e->registro = abrir_tabla(dir, e->nombre, "registro", "t_s,mensaje,texto");
+    e->trabajos = abrir_tabla(dir, e->nombre, "trabajos",
+                              "inicio_s,duracion_s,tipo,material,resultado,falla,pulsos,metros,"
+                              "metros_min,vueltas_min,tension_media,tension_p50,tension_p95,"
+                              "tension_max,muestras,perdidas");
+}
+
+/**
+ * @brief Devuelve el percentil `p` (0-100) del histograma de la tensión.
+ */
+static int percentil(const trabajo_est_t *w, unsigned p) {
+    uint64_t objetivo = (w->muestras * p + 99) / 100;
+    uint64_t acumulado = 0;
+    for (int g = 0; g < TENSION_HISTOGRAMA; g++) {
+        acumulado += w->histograma[g];
+        if (acumulado >= objetivo && acumulado > 0) return g;
+    }
+    return TENSION_HISTOGRAMA - 1;
+}
+
+/**
+ * @brief Cierra el trabajo en curso y escribe su fila.
+ *
+ * @param resultado `trabajo_resultado_t`, o -1 si la captura terminó antes que el trabajo.
+ */
+static void cerrar_trabajo(entrada_t *e, int resultado, int32_t pulsos, uint32_t falla, uint64_t fin_us) {
+    trabajo_est_t *w = &e->trabajo;
+    if (!w->activo) return;
+    w->activo = false;
+    e->n_trabajos++;
+
+    double duracion_s = (fin_us - w->inicio_us) / 1e6;
+    int32_t avance = pulsos - w->desde;
+    double metros = avance * 1000.0 / e->pulsos_por_km;
+    double minutos = duracion_s / 60.0;
+    double vueltas_min = minutos > 0 ? (double)avance / e->pulsos_por_vuelta / minutos : 0;
+    double metros_min = minutos > 0 ? metros / minutos : 0;
+    double media = w->muestras ? (double)w->suma_tension / w->muestras : 0;
+    fprintf(e->trabajos, "%.6f,%.3f,%u,%u,%d,%u,%d,%.3f,%.3f,%.1f,%.1f,%d,%d,%d,%llu,%llu\n",
+            w->inicio_us / 1e6, duracion_s, w->tipo, w->material, resultado, falla, avance, metros,
+            metros_min, vueltas_min, media, percentil(w, 50), percentil(w, 95), w->tension_max,
+            (unsigned long long)w->muestras, (unsigned long long)w->huecos);
+    fprintf(stderr, "%s: trabajo %u, %.1f s, %.2f m (%.2f m/min), tension %.0f g (p95 %d g), %llu perdidas\n",
+            e->nombre, e->n_trabajos, duracion_s, metros, metros_min, media, percentil(w, 95),
+            (unsigned long long)w->huecos);
+}
+
+/**
+ * @brief Procesa una muestra.
+ */
+static void procesar_muestra(entrada_t *e, const uint8_t *d) {
+    uint16_t secuencia = (uint16_t)tomar(d + 1, 2);
+    uint64_t t = extender(e, tomar(d + 3, 4));
+    int32_t pulsos = (int32_t)tomar(d + 7, 4);
+    int32_t traslado = (int32_t)tomar(d + 11, 4);
+    int16_t rpm = (int16_t)tomar(d + 15, 2);
+    int16_t tension = (int16_t)tomar(d + 17, 2);
+    uint16_t pwm = (uint16_t)tomar(d + 19, 2);
+
+    uint16_t huecos = e->con_secuencia ? (uint16_t)(secuencia - e->secuencia) : 0;
+    e->con_secuencia = true;
+    e->secuencia = secuencia + 1;
+    e->huecos += huecos;
+    e->n_muestras++;
+    fprintf(e->muestras, "%.6f,%u,%d,%d,%d,%d,%u\n", t / 1e6, secuencia, pulsos, traslado, rpm, tension, pwm);
+
+    trabajo_est_t *w = &e->trabajo;
+    if (w->activo) {
+        w->muestras++;
+        w->huecos += huecos;
+        w->suma_tension += tension;
+        if (tension > w->tension_max) w->tension_max = tension;
+        int casilla = tension < 0 ? 0 : tension >= TENSION_HISTOGRAMA ? TENSION_HISTOGRAMA - 1 : tension;
+        w->histograma[casilla]++;
+    }
+}
+
+/**
+ * @brief Procesa un mensaje del registro; los de inicio y fin delimitan los trabajos.
+ */
+static void procesar_registro(entrada_t *e, const uint8_t *d, size_t n) {
+    uint16_t id = (uint16_t)tomar(d + 1, 2);
+    uint64_t t = extender(e, tomar(d + 3, 4));
+    uint32_t args[REGISTRO_ARGS_MAX] = { 0 };
+    int nargs = (int)((n - 7) / 4);
+    for (int i = 0; i < nargs; i++) {
+        args[i] = tomar(d + 7 + 4 * i, 4);
+    }
+    char texto[256];
+    registro_texto(texto, sizeof(texto), id, args, nargs);
+    fprintf(e->registro, "%.6f,%u,\"", t / 1e6, id);
+    for (const char *c = texto; *c; c++) { // Comillas dobladas (CSV)
+        if (*c == '"') fputc('"', e->registro);
+        fputc(*c, e->registro);
+    }
+    fputs("\"\n", e->registro);
+
+    trabajo_est_t *w = &e->trabajo;
+    switch (id) {
+    case REG_TRABAJO_INICIO:
+        cerrar_trabajo(e, -1, w->desde, 0, t); // Fin perdido: se cierra sin resultado
+        memset(w, 0, sizeof(*w));
+        w->activo = true;
+        w->inicio_us = t;
+        w->tipo = args[0];
+        w->material = args[1];
+        w->desde = (int32_t)args[2];
+        w->objetivo = (int32_t)args[3];
+        break;
+    case REG_TRABAJO_ESCALA:
+        if (args[0]) e->pulsos_por_km = args[0];
+        if (args[1]) e->pulsos_por_vuelta = args[1];
+        break;
+    case REG_TRABAJO_FIN:
+        cerrar_trabajo(e, (int)args[0], (int32_t)args[1], args[2], t);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Procesa una trama del volcado de la traza.
+ */
+static void procesar_traza(entrada_t *e, const uint8_t *d, size_t n) {
+    if (!e->traza) {
+        e->traza = abrir_tabla(e->dir, e->nombre, "traza", TRAZA_COLUMNAS);
+    }
+    uint32_t posicion = tomar(d + 1, 2);
+    for (size_t i = 3; i + 8 <= n; i += 8, posicion++) {
+        traza_evento_t ev = { tomar(d + i, 4), tomar(d + i + 4, 4) };
+        fprintf(e->traza, "%u,%u,%u,%u,%d\n", posicion, ev.t_us, traza_tipo(&ev), traza_canal(&ev),
+                traza_valor(&ev));
+        e->traza_recibidos = posicion + 1;
+    }
+}
+
+/**
+ * @brief Procesa una trama decodificada según su tipo.
+ */
+static void procesar_trama(entrada_t *e, const uint8_t *d, size_t n) {
+    if (n >= 4 && n <= REMOTO_RESPUESTA_MAX && d[0] == TELEMETRIA_RESPUESTA) {
+        memcpy(e->respuesta, d, n);
+        e->respuesta_largo = n;
+        e->con_respuesta = true;
+    } else if (!e->muestras) {
+        // Solo órdenes: el resto de la telemetría no interesa
+    } else if (n == 21 && d[0] == TELEMETRIA_MUESTRA) {
+        procesar_muestra(e, d);
+    } else if (n == 10 && d[0] == TELEMETRIA_FALLA) {
+        uint8_t falla = d[1];
+        uint64_t t = extender(e, tomar(d + 2, 4));
+        fprintf(e->fallas, "%.6f,%u,%s,%u\n", t / 1e6, falla,
+                falla < FALLA_NUM ? nombres_falla[falla] : "", tomar(d + 6, 4));
+    } else if (n >= 7 && (n - 7) % 4 == 0 && (n - 7) / 4 <= REGISTRO_ARGS_MAX && d[0] == TELEMETRIA_REGISTRO) {
+        procesar_registro(e, d, n);
+    } else if (n >= 11 && (n - 3) % 8 == 0 && d[0] == TELEMETRIA_TRAZA) {
+        procesar_traza(e, d, n);
+    } else {
+        e->malas++;
+    }
+}
+
+/**
+ * @brief Separa en tramas los bytes recibidos y las procesa.
+ */
+static void alimentar(entrada_t *e, const uint8_t *bytes, size_t n) {
+    if (e->crudo) fwrite(bytes, 1, n, e->crudo);
+    for (size_t i = 0; i < n; i++) {
+        if (bytes[i] != 0) {
+            if (e->largo < sizeof(e->trama)) {
+                e->trama[e->largo++] = bytes[i];
+            } else {
+                e->desbordada = true;
+            }
+            continue;
+        }
+        uint8_t datos[TRAMA_MAX];
+        size_t largo = e->desbordada ? 0 : cobs_decodificar(e->trama, e->largo, datos);
+        if (largo > 0) {
+            procesar_trama(e, datos, largo);
+        } else if (e->largo > 0) {
+            e->malas++;
+        }
+        e->largo = 0;
+        e->desbordada = false;
+    }
+}
+
+/**
+ * @brief Cierra una entrada: trabajo inconcluso, tablas y resumen.
+ */
+static void cerrar_entrada(entrada_t *e) {
+    cerrar_trabajo(e, -1, e->trabajo.desde, 0, e->t_us);
+    if (!e->muestras) return;
+    FILE *tablas[] = { e->crudo, e->muestras, e->fallas, e->registro, e->trabajos, e->traza };
+    for (size_t i = 0; i < sizeof(tablas) / sizeof(tablas[0]); i++) {
+        if (tablas[i]) fclose(tablas[i]);
+    }
+    fprintf(stderr, "%s: %llu muestras, %llu perdidas, %llu tramas malas, %u trabajos\n", e->nombre,
+            (unsigned long long)e->n_muestras, (unsigned long long)e->huecos,
+            (unsigned long long)e->malas, e->n_trabajos);
+}
+
+/**
+ * @brief Abre un puerto serie en modo crudo. Abrirlo activa DTR: el equipo empieza a enviar.
+ */
+static int abrir_puerto(const char *ruta) {
+    int fd = open(ruta, O_RDWR | O_NOCTTY);
+    if (fd < 0) return -1;
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tio.c_cflag |= CLOCAL | CREAD;
+        cfsetspeed(&tio, B115200); // El CDC ignora la velocidad
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+/**
+ * @brief Atiende todas las entradas hasta que terminen, se pulse Ctrl+C o pase el plazo.
+ */
+static void atender(entrada_t *entradas, int n, double plazo_s) {
+    struct pollfd fds[ENTRADAS_MAX];
+    struct timespec inicio, ahora;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    int abiertas = n;
+    while (abiertas > 0 && !detener) {
+        for (int i = 0; i < n; i++) {
+            fds[i].fd = entradas[i].fd;
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+        }
+        int listos = poll(fds, (nfds_t)n, 200);
+        if (listos < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            if (entradas[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            uint8_t bytes[4096];
+            ssize_t leidos = read(entradas[i].fd, bytes, sizeof(bytes));
+            if (leidos > 0) {
+                alimentar(&entradas[i], bytes, (size_t)leidos);
+            } else if (leidos == 0 || (errno != EINTR && errno != EAGAIN)) {
+                if (entradas[i].fd != STDIN_FILENO) close(entradas[i].fd);
+                entradas[i].fd = -1; // poll() ignora los descriptores negativos
+                abiertas--;
+            }
+        }
+        if (plazo_s > 0) {
+            clock_gettime(CLOCK_MONOTONIC, &ahora);
+            if ((ahora.tv_sec - inicio.tv_sec) + (ahora.tv_nsec - inicio.tv_nsec) / 1e9 >= plazo_s) break;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        if (entradas[i].fd >= 0 && entradas[i].fd != STDIN_FILENO) close(entradas[i].fd);
+        cerrar_entrada(&entradas[i]);
+    }
+}
+
+/**
+ * @brief Subórdenes `capturar` y `decodificar`.
+ */
+static int ejecutar_entradas(int argc, char **argv, bool capturar) {
+    const char *dir = ".";
+    double plazo_s = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "o:t:")) != -1) {
+        if (opt == 'o') dir = optarg;
+        else if (opt == 't') plazo_s = atof(optarg);
+        else return 2;
+    }
+    int n = argc - optind;
+    if (n < 1 || n > ENTRADAS_MAX) {
+        fprintf(stderr, "de 1 a %d entradas\n", ENTRADAS_MAX);
+        return 2;
+    }
+    static entrada_t entradas[ENTRADAS_MAX];
+    for (int i = 0; i < n; i++) {
+        const char *ruta = argv[optind + i];
+        int fd = strcmp(ruta, "-") == 0 ? STDIN_FILENO : capturar ? abrir_puerto(ruta) : open(ruta, O_RDONLY);
+        if (fd < 0) {
+            perror(ruta);
+            return 1;
+        }
+        abrir_entrada(&entradas[i], fd, ruta, dir);
+        if (capturar) {
+            char crudo[512];
+            exigir_completo(snprintf(crudo, sizeof(crudo), "%s/%s.bin", dir, entradas[i].nombre),
+                            sizeof(crudo), dir);
+            entradas[i].crudo = fopen(crudo, "wb");
+            if (!entradas[i].crudo) {
+                perror(crudo);
+                return 1;
+            }
+        }
+    }
+    signal(SIGINT, al_interrumpir);
+    atender(entradas, n, plazo_s);
+    return 0;
+}
+
+/**
+ * @brief Suborden `reproducir`: reenvía una captura respetando sus tiempos.
+ */
+static int reproducir(int argc, char **argv) {
+    double factor = 1.0;
+    const char *destino = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "x:d:")) != -1) {
+        if (opt == 'x') factor = atof(optarg);
+        else if (opt == 'd') destino = optarg;
+        else return 2;
+    }
+    if (optind >= argc) return 2;
+    FILE *f = fopen(argv[optind], "rb");
+    if (!f) {
+        perror(argv[optind]);
+        return 1;
+    }
+    int salida = destino ? open(destino, O_WRONLY | O_NOCTTY) : STDOUT_FILENO;
+    if (salida < 0) {
+        perror(destino);
+        return 1;
+    }
+    signal(SIGINT, al_interrumpir);
+
+    entrada_t reloj; // Solo para extender los instantes
+    memset(&reloj, 0, sizeof(reloj));
+    uint64_t t0 = 0;
+    bool con_t0 = false;
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    uint8_t trama[TRAMA_MAX + 1];
+    size_t largo = 0;
+    int c;
+    while ((c = fgetc(f)) != EOF && !detener) {
+        if (largo < sizeof(trama)) trama[largo++] = (uint8_t)c;
+        if (c != 0) continue;
+
+        // Instante de la trama: muestras, fallas y registro lo llevan
+        uint8_t datos[TRAMA_MAX];
+        size_t n = largo > 1 && largo <= TRAMA_MAX ? cobs_decodificar(trama, largo - 1, datos) : 0;
+        int desp = n == 21 && datos[0] == TELEMETRIA_MUESTRA ? 3
+                 : n == 10 && datos[0] == TELEMETRIA_FALLA ? 2
+                 : n >= 7 && datos[0] == TELEMETRIA_REGISTRO ? 3 : 0;
+        if (desp && factor > 0) {
+            uint64_t t = extender(&reloj, tomar(datos + desp, 4));
+            if (!con_t0) {
+                con_t0 = true;
+                t0 = t;
+            }
+            double espera_s = t > t0 ? (t - t0) / 1e6 / factor : 0;
+            struct timespec objetivo = inicio;
+            objetivo.tv_sec += (time_t)espera_s;
+            objetivo.tv_nsec += (long)((espera_s - (time_t)espera_s) * 1e9);
+            if (objetivo.tv_nsec >= 1000000000L) {
+                objetivo.tv_sec++;
+                objetivo.tv_nsec -= 1000000000L;
+            }
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &objetivo, NULL);
+        }
+        if (write(salida, trama, largo) < 0) {
+            perror("write");
+            break;
+        }
+        largo = 0;
+    }
+    fclose(f);
+    if (salida != STDOUT_FILENO) close(salida);
+    return 0;
+}
+
+/**
+ * @brief Lee lo que haya llegado de un equipo, esperando hasta `ms` milisegundos.
+ *
+ * @return `false` si el puerto se cerró.
+ */
+static bool recibir(entrada_t *e, int ms) {
+    struct pollfd pfd = { e->fd, POLLIN, 0 };
+    if (poll(&pfd, 1, ms) <= 0) return true;
+    uint8_t bytes[4096];
+    ssize_t leidos = read(e->fd, bytes, sizeof(bytes));
+    if (leidos > 0) alimentar(e, bytes, (size_t)leidos);
+    return leidos > 0 || (leidos < 0 && (errno == EINTR || errno == EAGAIN));
+}
+
+/**
+ * @brief Envía una orden (remoto.h) y espera su respuesta; la reintenta si no llega.
+ *
+ * @param valores Recibe los valores de la respuesta (puede ser `NULL`).
+ * @return Resultado (`remoto_resultado_t`), o -1 si el equipo no contestó.
+ */
+static int ordenar(entrada_t *e, uint8_t orden, const int32_t *args, int n, int32_t *valores) {
+    static uint8_t secuencia = 0;
+    static bool sembrada = false;
+    if (!sembrada) { // Otra ejecución no repite la secuencia de la anterior: el equipo la tomaría por un reintento
+        secuencia = (uint8_t)(time(NULL) ^ getpid());
+        sembrada = true;
+    }
+    uint8_t datos[REMOTO_DATOS_MAX];
+    uint8_t *p = datos;
+    *p++ = orden;
+    *p++ = ++secuencia;
+    for (int i = 0; i < n; i++) {
+        for (int b = 0; b < 4; b++) *p++ = (uint8_t)((uint32_t)args[i] >> (8 * b));
+    }
+    uint8_t trama[COBS_TRAMA_MAX(REMOTO_DATOS_MAX)];
+    size_t largo = cobs_codificar(datos, (size_t)(p - datos), trama);
+    for (int intento = 0; intento < ORDEN_INTENTOS && !detener; intento++) {
+        if (write(e->fd, trama, largo) != (ssize_t)largo) return -1;
+        struct timespec inicio, ahora;
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        do {
+            e->con_respuesta = false;
+            if (!recibir(e, 20)) return -1;
+            if (e->con_respuesta && e->respuesta[1] == orden && e->respuesta[2] == secuencia) {
+                for (size_t i = 4; valores && i + 4 <= e->respuesta_largo; i += 4) {
+                    valores[(i - 4) / 4] = (int32_t)tomar(e->respuesta + i, 4);
+                }
+                return e->respuesta[3];
+            }
+            clock_gettime(CLOCK_MONOTONIC, &ahora);
+        } while ((ahora.tv_sec - inicio.tv_sec) * 1000 + (ahora.tv_nsec - inicio.tv_nsec) / 1000000 < ORDEN_ESPERA_MS);
+    }
+    return -1;
+}
+
+/**
+ * @brief Suborden `traza volcar`: descarga la traza de los sensores de un equipo.
+ */
+static int volcar_traza(entrada_t *e) {
+    int32_t args[1] = { REMOTO_TRAZA_VOLCAR };
+    int32_t valores[REMOTO_VALORES_MAX] = { 0 }; // Sin cabecera: 0 = desconocida
+    int r = ordenar(e, REMOTO_TRAZA, args, 1, valores);
+    if (r != REMOTO_OK) {
+        fprintf(stderr, "%s: el equipo no aceptó el volcado (%d)\n", e->nombre, r);
+        return 1;
+    }
+    if (!e->traza) {
+        e->traza = abrir_tabla(e->dir, e->nombre, "traza", TRAZA_COLUMNAS);
+    }
+    fprintf(e->traza, "# tara=%ld,pulsos_por_vuelta=%ld\n", (long)valores[3], (long)valores[4]);
+    uint32_t total = (uint32_t)valores[0];
+    struct timespec ultimo, ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ultimo);
+    uint32_t recibidos = 0;
+    while (e->traza_recibidos < total && !detener) {
+        if (!recibir(e, 100)) break;
+        clock_gettime(CLOCK_MONOTONIC, &ahora);
+        if (e->traza_recibidos != recibidos) {
+            recibidos = e->traza_recibidos;
+            ultimo = ahora;
+        } else if ((ahora.tv_sec - ultimo.tv_sec) * 1000 + (ahora.tv_nsec - ultimo.tv_nsec) / 1000000
+                   > VOLCADO_ESPERA_MS) {
+            break;
+        }
+    }
+    fprintf(stderr, "%s: traza de %u eventos, %u recibidos\n", e->nombre, total, e->traza_recibidos);
+    return e->traza_recibidos == total ? 0 : 1;
+}
+
+/**
+ * @brief Suborden `traza cargar`: envía una traza a un equipo y le pide reproducirla.
+ */
+static int cargar_traza(entrada_t *e, const char *ruta) {
+    FILE *f = fopen(ruta, "r");
+    if (!f) {
+        perror(ruta);
+        return 1;
+    }
+    char linea[128];
+    int32_t n = 0;
+    int r = REMOTO_OK;
+    while (r == REMOTO_OK && fgets(linea, sizeof(linea), f) && !detener) {
+        unsigned posicion, t_us, tipo, canal;
+        int valor;
+        if (sscanf(linea, "%u,%u,%u,%u,%d", &posicion, &t_us, &tipo, &canal, &valor) != 5) continue; // Encabezado
+        traza_evento_t ev = traza_evento((traza_tipo_t)tipo, (uint8_t)canal, valor, t_us);
+        int32_t args[3] = { n, (int32_t)ev.t_us, (int32_t)ev.dato };
+        r = ordenar(e, REMOTO_CARGAR_TRAZA, args, 3, NULL);
+        if (r == REMOTO_OK) n++;
+    }
+    fclose(f);
+    if (r == REMOTO_OK && n > 0) {
+        int32_t args[1] = { REMOTO_TRAZA_REPRODUCIR };
+        r = ordenar(e, REMOTO_TRAZA, args, 1, NULL);
+    }
+    if (r != REMOTO_OK || n == 0) {
+        fprintf(stderr, "%s: carga fallida en el evento %d (%d)\n", e->nombre, n, r);
+        return 1;
+    }
+    fprintf(stderr, "%s: %d eventos cargados; el próximo trabajo los reproduce\n", e->nombre, n);
+    return 0;
+}
+
+/**
+ * @brief Suborden `traza`.
+ */
+static int traza(int argc, char **argv) {
+    if (argc < 2) return 2;
+    bool volcar = strcmp(argv[1], "volcar") == 0;
+    if (!volcar && strcmp(argv[1], "cargar") != 0) return 2;
+    const char *dir = ".";
+    int opt;
+    optind = 2;
+    while ((opt = getopt(argc, argv, "o:")) != -1) {
+        if (opt == 'o') dir = optarg;
+        else return 2;
+    }
+    if (argc - optind != (volcar ? 1 : 2)) return 2;
+    const char *ruta = argv[optind];
+    int fd = abrir_puerto(ruta);
+    if (fd < 0) {
+        perror(ruta);
+        return 1;
+    }
+    static entrada_t e;
+    abrir_entrada(&e, fd, ruta, volcar ? dir : NULL);
+    signal(SIGINT, al_interrumpir);
+    int r = volcar ? volcar_traza(&e) : cargar_traza(&e, argv[optind + 1]);
+    close(fd);
+    if (volcar) cerrar_entrada(&e);
+    return r;
+}
+
+/**
+ * @brief Muestra el uso.
+ */
+static void uso(void) {
+    fprintf(stderr,
+            "uso: telemetria capturar [-o DIR] [-t SEG] DISPOSITIVO...\n"
+            "     telemetria decodificar [-o DIR] ARCHIVO...   (- = entrada estándar)\n"
+            "     telemetria reproducir [-x FACTOR] [-d SALIDA] ARCHIVO\n"
+            "     telemetria traza volcar [-o DIR] DISPOSITIVO\n"
+            "     telemetria traza cargar DISPOSITIVO ARCHIVO.csv\n");
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        uso();
+        return 2;
+    }
+    const char *orden = argv[1];
+    int r = 2;
+    if (strcmp(orden, "capturar") == 0) {
+        r = ejecutar_entradas(argc - 1, argv + 1, true);
+    } else if (strcmp(orden, "decodificar") == 0) {
+        r = ejecutar_entradas(argc - 1, argv + 1, false);
+    } else if (strcmp(orden, "reproducir") == 0) {
+        r = reproducir(argc - 1, argv + 1);
+    } else if (strcmp(orden, "traza") == 0) {
+        r = traza(argc - 1, argv + 1);
+    }
+    if (r == 2) uso();
+    return r;
+}
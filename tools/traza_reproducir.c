@@ -0,0 +1,156 @@
+/**
+ * @file traza_reproducir.c
+ * @brief Reproducción en el PC de una traza de sensores grabada en el equipo (traza.h).
+ *
+ * Lee la tabla que deja `telemetria traza volcar` (posicion,t_us,tipo,canal,valor), la carga
+ * en la traza y la reproduce en orden por el mismo código de control del equipo, con los
+ * instantes grabados:
+ * - cada flanco del encoder cuenta un pulso y mide la velocidad (`control_rpm()`);
+ * - cada lectura de la celda principal pasa por el estimador de tensión (tension.h), con la
+ *   calibración del equipo (`control_tension_cfg`);
+ * - cada `CONTROL_PERIODO_US` de la traza, la vigilancia de anomalías (`control_vigilar()`)
+ *   ve la medida de tensión y la velocidad, como `vigilar_anomalias()` en Final_dig.c.
+ *
+ * El resultado es determinista: la misma traza da siempre la misma tabla. Escribe en la
+ * salida estándar una fila por lectura de la celda principal:
+ * `t_s,pulsos,rpm,crudo,medida_g,tension_g,calentando,anomalia`. `calentando` vale 1
+ * mientras la cinemática del estimador se asienta (`tension_calentando()`): esas medidas
+ * no están compensadas del todo. `anomalia` es la detectada desde la fila anterior
+ * (`anomalia_resultado_t`). Las celdas de los hilos y SW no se procesan.
+ *
+ * La tara y los pulsos por vuelta salen de la cabecera que escribe `telemetria traza
+ * volcar` (`# tara=...,pulsos_por_vuelta=...`); `-t` y `-p` los reemplazan. La traza no
+ * guarda el planificador de velocidad: la vigilancia de anomalías solo espera
+ * `ANOMALIA_ESPERA_MS` al empezar y tras cada anomalía, sin rampas.
+ *
+ * Uso: `traza_reproducir [-t TARA] [-p PULSOS_POR_VUELTA] TRAZA.csv`
+ *
+ * Compilar desde esta carpeta:
+ * `cc -O2 -I.. -o traza_reproducir traza_reproducir.c ../traza.c ../tension.c ../anomalia.c ../control.c`
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "traza.h"
+#include "tension.h"
+#include "control.h"
+
+#define PULSOS_POR_VUELTA_FABRICA 100 ///< Pulsos del encoder por vuelta del tambor, de fábrica.
+
+/**
+ * @brief Carga la tabla de una traza y su cabecera; devuelve los eventos cargados o -1.
+ *
+ * @param ruta Tabla de `telemetria traza volcar`.
+ * @param cabecera Recibe la cabecera; queda en 0 (desconocida) si la tabla no la trae.
+ */
+static int32_t cargar(const char *ruta, traza_cabecera_t *cabecera) {
+    FILE *f = fopen(ruta, "r");
+    if (!f) {
+        perror(ruta);
+        return -1;
+    }
+    char linea[128];
+    int32_t n = 0;
+    *cabecera = (traza_cabecera_t){ 0, 0 };
+    while (fgets(linea, sizeof(linea), f)) {
+        unsigned posicion, t_us, tipo, canal;
+        int valor;
+        long tara, pulsos_por_vuelta;
+        if (sscanf(linea, "# tara=%ld,pulsos_por_vuelta=%ld", &tara, &pulsos_por_vuelta) == 2) {
+            cabecera->tara = (int32_t)tara;
+            cabecera->pulsos_por_vuelta = (uint16_t)pulsos_por_vuelta;
+            continue;
+        }
+        if (sscanf(linea, "%u,%u,%u,%u,%d", &posicion, &t_us, &tipo, &canal, &valor) != 5) continue; // Encabezado
+        traza_evento_t e = traza_evento((traza_tipo_t)tipo, (uint8_t)canal, valor, t_us);
+        if (posicion != (unsigned)n || !traza_cargar((uint32_t)n, &e)) {
+            fprintf(stderr, "%s: evento %u fuera de orden o de más (máximo %d)\n", ruta, posicion, TRAZA_EVENTOS);
+            fclose(f);
+            return -1;
+        }
+        n++;
+    }
+    fclose(f);
+    return n;
+}
+
+int main(int argc, char **argv) {
+    long tara = 0, pulsos_por_vuelta = -1; // -1 = los de la cabecera
+    bool con_tara = false;                 // -t: no se usa la de la cabecera
+    int opt;
+    while ((opt = getopt(argc, argv, "t:p:")) != -1) {
+        if (opt == 't') {
+            tara = atol(optarg);
+            con_tara = true;
+        } else if (opt == 'p') {
+            pulsos_por_vuelta = atol(optarg);
+        } else {
+            return 2;
+        }
+    }
+    if (optind != argc - 1 || pulsos_por_vuelta == 0) {
+        fprintf(stderr, "uso: traza_reproducir [-t TARA] [-p PULSOS_POR_VUELTA] TRAZA.csv\n");
+        return 2;
+    }
+    traza_cabecera_t cabecera;
+    if (cargar(argv[optind], &cabecera) <= 0 || !traza_reproducir()) {
+        fprintf(stderr, "%s: traza vacía\n", argv[optind]);
+        return 1;
+    }
+    if (!con_tara) {
+        if (cabecera.pulsos_por_vuelta == 0) {
+            fprintf(stderr, "%s: sin cabecera; tara 0 (indíquela con -t)\n", argv[optind]);
+        }
+        tara = cabecera.tara;
+    }
+    if (pulsos_por_vuelta < 0) {
+        pulsos_por_vuelta = cabecera.pulsos_por_vuelta ? cabecera.pulsos_por_vuelta : PULSOS_POR_VUELTA_FABRICA;
+    }
+
+    traza_evento_t e;
+    traza_proximo(&e);
+    uint32_t inicio = e.t_us;
+    tension_iniciar(&control_tension_cfg); // La cinemática parte de la primera lectura de la celda
+    tension_tarar(tara, 1);
+    control_vigilancia_t vigilancia;
+    control_vigilancia_reiniciar(&vigilancia, inicio);
+    uint32_t proximo_control_us = inicio + CONTROL_PERIODO_US;
+    anomalia_resultado_t anomalia = ANOMALIA_NINGUNA;
+    int32_t pulsos = 0;
+    uint32_t ultimo_pulso_us = inicio, periodo_pulso_us = 0; // Como armar_protecciones()
+
+    printf("t_s,pulsos,rpm,crudo,medida_g,tension_g,calentando,anomalia\n");
+    while (traza_siguiente(&e)) {
+        while ((int32_t)(e.t_us - proximo_control_us) >= 0) { // Ticks hasta este evento
+            int32_t rpm = control_rpm(periodo_pulso_us, (uint32_t)pulsos_por_vuelta);
+            anomalia_resultado_t r = control_vigilar(&vigilancia, proximo_control_us, tension_medida_gramos(), rpm);
+            if (r != ANOMALIA_NINGUNA) anomalia = r;
+            proximo_control_us += CONTROL_PERIODO_US;
+        }
+        switch (traza_tipo(&e)) {
+        case TRAZA_ENCODER:
+            pulsos++;
+            periodo_pulso_us = e.t_us - ultimo_pulso_us;
+            ultimo_pulso_us = e.t_us;
+            break;
+        case TRAZA_CELDA:
+            if (traza_canal(&e) != 0) break; // Hilos en paralelo: no se procesan
+            tension_procesar(traza_valor(&e), pulsos, e.t_us);
+            printf("%.6f,%ld,%ld,%ld,%ld,%ld,%d,%d\n", (e.t_us - inicio) / 1e6, (long)pulsos,
+                   (long)control_rpm(periodo_pulso_us, (uint32_t)pulsos_por_vuelta), (long)traza_valor(&e),
+                   (long)tension_medida_gramos(), (long)tension_gramos(), tension_calentando(), anomalia);
+            anomalia = ANOMALIA_NINGUNA;
+            break;
+        default:
+            break;
+        }
+    }
+    traza_terminar();
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file trabajo.h
+ * @brief Descripción de un trabajo de bobinado para el motor de trabajos.
+ *
+ * Todos los bobinados (hilo por metros o continuo, cobre por vueltas) y los ensayos que
+ * hacen girar el tambor (autoajuste) se describen con un `trabajo_t` y los ejecuta un único
+ * bucle (`ejecutar_trabajo()` en el programa principal): armado de protecciones, rampa de
+ * velocidad, traslado, tick de control, fallas, pausa y parada por el usuario y pantallas.
+ *
+ * Un trabajo puede dividirse en segmentos (devanados de un transformador, tomas de una
+ * inductancia), cada uno con su material y su patrón de traslado. Entre segmentos del mismo
+ * hilo que no piden parada el tambor no se detiene; una toma o un cambio de hilo frenan
+ * justo en el límite y esperan al operario como en una pausa.
+ */
+
+#ifndef TRABAJO_H
+#define TRABAJO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "traslado.h"
+
+/**
+ * @brief Tipo de trabajo.
+ */
+typedef enum {
+    TRABAJO_BOBINADO = 0, ///< Bobinado normal hasta el objetivo (o continuo).
+    TRABAJO_AUTOAJUSTE,   ///< Ensayo del relé para ajustar el lazo de velocidad.
+} trabajo_tipo_t;
+
+/**
+ * @brief Unidad en que se muestra el avance.
+ */
+typedef enum {
+    TRABAJO_METROS = 0, ///< Metros de hilo (cada 100 pulsos).
+    TRABAJO_VUELTAS,    ///< Vueltas del tambor (cada 20 pulsos).
+} trabajo_unidad_t;
+
+/**
+ * @brief Resultado de un trabajo.
+ */
+typedef enum {
+    TRABAJO_COMPLETO = 0, ///< Se alcanzó el objetivo.
+    TRABAJO_DETENIDO,     ///< El usuario lo detuvo.
+    TRABAJO_FALLA,        ///< Lo detuvo una falla (ya mostrada en el OLED).
+} trabajo_resultado_t;
+
+/**
+ * @brief Cómo se entra en un segmento.
+ */
+typedef enum {
+    SEGMENTO_SEGUIR = 0, ///< Sin detener el tambor (solo si el material no cambia).
+    SEGMENTO_TOMA,       ///< Parada para sacar una toma; sigue el mismo hilo.
+    SEGMENTO_CAMBIO,     ///< Parada para cambiar de hilo.
+} segmento_inicio_t;
+
+/**
+ * @brief Segmento de un trabajo.
+ */
+typedef struct {
+    uint8_t material;    ///< Perfil de material (`material_t`).
+    uint8_t inicio;      ///< `segmento_inicio_t`; se ignora en el primer segmento.
+    uint8_t invertir;    ///< Empieza invirtiendo el sentido del traslado.
+    uint8_t reservado;
+    int32_t pulsos;      ///< Pulsos del encoder del segmento.
+    int32_t paso_mgrad;  ///< Avance del traslado por vuelta; 0 = el de fábrica.
+} trabajo_segmento_t;
+
+/**
+ * @brief Descripción de un trabajo.
+ */
+typedef struct {
+    trabajo_tipo_t tipo;       ///< Tipo de trabajo.
+    const char *titulo;        ///< Primera línea del OLED durante el trabajo.
+    int material;              ///< Perfil de material (`material_t`).
+    int32_t objetivo_pulsos;   ///< Pulsos del encoder a bobinar; 0 = continuo hasta detenerlo.
+    trabajo_unidad_t unidad;   ///< Unidad del avance en pantalla.
+    uint16_t velocidad;        ///< Velocidad objetivo (milésimas del PWM).
+    bool detenible;            ///< SW pausa/reanuda el trabajo y mantenido lo termina (un autoajuste termina).
+    const char *fin_titulo;    ///< Mensaje al completarse.
+    const char *fin_detalle;   ///< Segunda línea al completarse; `NULL` = total bobinado.
+    int32_t pulsos_inicio;     ///< Pulsos ya bobinados al reanudar; 0 = trabajo nuevo.
+    traslado_posicion_t posicion_inicio; ///< Posición del traslado al reanudar.
+    const trabajo_segmento_t *segmentos; ///< Segmentos; `NULL` = uno solo con `material`.
+    uint8_t n_segmentos;       ///< Número de segmentos; `objetivo_pulsos` debe ser su suma.
+} trabajo_t;
+
+#endif // TRABAJO_H
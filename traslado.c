@@ -0,0 +1,142 @@
+/**
+ * @file traslado.c
+ * @brief Implementación del planificador de traslado con pausa en bordes y compensaciones.
+ *
+ * La posición nominal avanza con los pulsos del encoder (engranaje electrónico). Al llegar
+ * a un borde se invierte el sentido y se mantiene la posición durante la pausa configurada.
+ * Sobre la posición nominal se aplican dos correcciones antes de enviarla a la salida:
+ * - Adelanto por retardo del servo: se comanda la posición que tendrá el traslado dentro de
+ *   `retardo_servo_us`, limitada al borde. Así el servo llega al borde a tiempo y no redondea
+ *   la esquina de la capa.
+ * - Juego mecánico: se desplaza el comando medio juego en el sentido de avance, de modo que
+ *   en cada inversión el juego completo se recupera durante la pausa del borde.
+ *
+ * El engranaje electrónico (avance por pulso con resto) se acumula en interp1, sin
+ * divisiones en el bucle por pulso.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "traslado.h"
+#include "pico/stdlib.h"
+#include "interpolador.h"
+
+/**
+ * @brief Limita un valor al rango [min, max].
+ */
+static int32_t limitar(int32_t v, int32_t min, int32_t max) {
+    if (v < min) return min;
+    if (v > max) return max;
+    return v;
+}
+
+/**
+ * @brief Calcula el comando compensado y lo envía a la salida si cambió.
+ */
+static void traslado_comandar(traslado_t *t) {
+    const traslado_config_t *cfg = &t->cfg;
+    int32_t objetivo = t->pos_mgrad;
+
+    // Durante la pausa el traslado debe quedarse quieto en el borde: sin adelanto.
+    if (t->pausa_restante == 0) {
+        int32_t adelanto = (int32_t)(((int64_t)t->vel_mgrad_s * cfg->retardo_servo_us) / 1000000);
+        objetivo += t->dir * adelanto;
+    }
+    // Mirada hacia adelante: el adelanto nunca sobrepasa el borde siguiente.
+    objetivo = limitar(objetivo, cfg->min_mgrad, cfg->max_mgrad);
+
+    // Compensación de juego: medio juego en el sentido de avance.
+    objetivo += t->dir * (cfg->juego_mgrad / 2);
+
+    if (objetivo != t->comando_mgrad) {
+        t->comando_mgrad = objetivo;
+        cfg->salida(objetivo);
+    }
+}
+
+void traslado_iniciar(traslado_t *t, const traslado_config_t *cfg, int32_t pulsos) {
+    t->cfg = *cfg;
+    t->pos_mgrad = cfg->min_mgrad;
+    interp_engranaje_config(cfg->paso_mgrad_vuelta, cfg->pulsos_por_vuelta);
+    t->dir = 1;
+    t->pausa_restante = 0;
+    t->ultimo_pulso = pulsos;
+    t->ultimo_us = time_us_32();
+    t->vel_mgrad_s = 0;
+    t->comando_mgrad = cfg->min_mgrad - 1; // Fuerza el primer envío
+    traslado_comandar(t);
+}
+
+void traslado_reanudar(traslado_t *t, const traslado_config_t *cfg, int32_t pulsos,
+                       const traslado_posicion_t *p) {
+    t->cfg = *cfg;
+    t->pos_mgrad = limitar(p->pos_mgrad, cfg->min_mgrad, cfg->max_mgrad);
+    interp_engranaje_config(cfg->paso_mgrad_vuelta, cfg->pulsos_por_vuelta);
+    t->dir = p->dir < 0 ? -1 : 1;
+    t->pausa_restante = p->pausa_restante > 0 ? p->pausa_restante : 0;
+    t->ultimo_pulso = pulsos;
+    t->ultimo_us = time_us_32();
+    t->vel_mgrad_s = 0;
+    t->comando_mgrad = t->pos_mgrad - 1; // Fuerza el primer envío
+    traslado_comandar(t);
+}
+
+void traslado_posicion(const traslado_t *t, traslado_posicion_t *p) {
+    p->pos_mgrad = t->pos_mgrad;
+    p->dir = t->dir;
+    p->pausa_restante = t->pausa_restante;
+}
+
+void traslado_patron(traslado_t *t, int32_t paso_mgrad_vuelta, bool invertir) {
+    t->cfg.paso_mgrad_vuelta = paso_mgrad_vuelta;
+    interp_engranaje_config(paso_mgrad_vuelta, t->cfg.pulsos_por_vuelta); // También reinicia el acumulador
+    if (invertir) {
+        t->dir = -t->dir;
+        t->pausa_restante = t->cfg.pausa_borde_pulsos;
+    }
+    traslado_comandar(t);
+}
+
+void traslado_actualizar(traslado_t *t, int32_t pulsos) {
+    const traslado_config_t *cfg = &t->cfg;
+    int32_t delta = pulsos - t->ultimo_pulso;
+    if (delta <= 0) return; // Tambor detenido: se mantiene el último comando
+
+    uint32_t ahora = time_us_32();
+    uint32_t dt_us = ahora - t->ultimo_us;
+    t->ultimo_pulso = pulsos;
+    t->ultimo_us = ahora;
+
+    // Estimación de la velocidad de traslado a partir de la velocidad del tambor,
+    // filtrada con un promedio exponencial (alfa = 1/4).
+    if (dt_us > 0) {
+        int32_t vel = (int32_t)(((int64_t)delta * cfg->paso_mgrad_vuelta * 1000000)
+                                / ((int64_t)cfg->pulsos_por_vuelta * dt_us));
+        t->vel_mgrad_s += (vel - t->vel_mgrad_s) / 4;
+    }
+
+    // Avance pulso a pulso para que la pausa y la inversión caigan en el pulso exacto.
+    for (int32_t i = 0; i < delta; i++) {
+        if (t->pausa_restante > 0) {
+            t->pausa_restante--;
+            continue;
+        }
+
+        t->pos_mgrad += t->dir * interp_engranaje_pulso();
+
+        if (t->dir > 0 && t->pos_mgrad >= cfg->max_mgrad) {
+            t->pos_mgrad = cfg->max_mgrad;
+            t->dir = -1;
+            t->pausa_restante = cfg->pausa_borde_pulsos;
+            interp_engranaje_reiniciar();
+        } else if (t->dir < 0 && t->pos_mgrad <= cfg->min_mgrad) {
+            t->pos_mgrad = cfg->min_mgrad;
+            t->dir = 1;
+            t->pausa_restante = cfg->pausa_borde_pulsos;
+            interp_engranaje_reiniciar();
+        }
+    }
+
+    traslado_comandar(t);
+}
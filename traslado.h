@@ -0,0 +1,114 @@
+/**
+ * @file traslado.h
+ * @brief Planificador del traslado (guiado del hilo) sincronizado con el tambor.
+ *
+ * El traslado deja de oscilar por tiempo y pasa a ser función del ángulo del tambor,
+ * medido con el encoder óptico (engranaje electrónico). El planificador mira por
+ * adelantado cada inversión en los bordes, aplica una pausa configurable medida en
+ * pulsos del encoder, adelanta el comando para compensar el retardo mecánico del servo
+ * según la velocidad de traslado y corrige el juego mecánico al cambiar de sentido.
+ *
+ * Todas las posiciones se expresan en miligrados (mgrad) del servo.
+ */
+
+#ifndef TRASLADO_H
+#define TRASLADO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Función de salida del traslado.
+ *
+ * Recibe la posición comandada en miligrados. Permite usar el servo PWM u otro
+ * actuador sin cambiar el planificador.
+ */
+typedef void (*traslado_salida_t)(int32_t mgrad);
+
+/**
+ * @brief Parámetros del planificador de traslado.
+ */
+typedef struct {
+    int32_t min_mgrad;          ///< Borde inferior del traslado en miligrados.
+    int32_t max_mgrad;          ///< Borde superior del traslado en miligrados.
+    int32_t paso_mgrad_vuelta;  ///< Avance del traslado por vuelta del tambor (paso del hilo).
+    int32_t pulsos_por_vuelta;  ///< Pulsos del encoder óptico por vuelta del tambor.
+    int32_t pausa_borde_pulsos; ///< Pausa en cada borde, medida en pulsos del encoder (ángulo del tambor).
+    int32_t retardo_servo_us;   ///< Retardo mecánico del servo a compensar adelantando el comando.
+    int32_t juego_mgrad;        ///< Juego mecánico (backlash) a recuperar en cada inversión.
+    traslado_salida_t salida;   ///< Función que aplica la posición comandada.
+} traslado_config_t;
+
+/**
+ * @brief Estado del planificador de traslado.
+ */
+typedef struct {
+    traslado_config_t cfg;      ///< Copia de la configuración activa.
+    int32_t pos_mgrad;          ///< Posición nominal (sin compensaciones) en miligrados.
+    int32_t dir;                ///< Sentido actual del traslado (+1 o -1).
+    int32_t pausa_restante;     ///< Pulsos de pausa pendientes en el borde actual.
+    int32_t ultimo_pulso;       ///< Último conteo del encoder procesado.
+    uint32_t ultimo_us;         ///< Instante del último avance procesado.
+    int32_t vel_mgrad_s;        ///< Velocidad de traslado estimada (filtrada) en mgrad/s.
+    int32_t comando_mgrad;      ///< Último comando enviado a la salida.
+} traslado_t;
+
+/**
+ * @brief Posición del traslado dentro de la capa, para reanudar un bobinado.
+ */
+typedef struct {
+    int32_t pos_mgrad;      ///< Posición nominal en miligrados.
+    int32_t dir;            ///< Sentido del traslado (+1 o -1).
+    int32_t pausa_restante; ///< Pulsos de pausa pendientes en el borde.
+} traslado_posicion_t;
+
+/**
+ * @brief Inicia el traslado en el borde inferior.
+ *
+ * @param t Estado del planificador.
+ * @param cfg Configuración a utilizar (se copia).
+ * @param pulsos Conteo actual del encoder óptico.
+ */
+void traslado_iniciar(traslado_t *t, const traslado_config_t *cfg, int32_t pulsos);
+
+/**
+ * @brief Avanza el traslado según los pulsos del encoder recibidos desde la última llamada.
+ *
+ * Debe llamarse con frecuencia desde el bucle de bobinado; no bloquea.
+ *
+ * @param t Estado del planificador.
+ * @param pulsos Conteo actual del encoder óptico.
+ */
+void traslado_actualizar(traslado_t *t, int32_t pulsos);
+
+/**
+ * @brief Inicia el traslado en una posición guardada (reanudación de un bobinado).
+ *
+ * @param t Estado del planificador.
+ * @param cfg Configuración a utilizar (se copia).
+ * @param pulsos Conteo actual del encoder óptico.
+ * @param p Posición guardada con `traslado_posicion()`.
+ */
+void traslado_reanudar(traslado_t *t, const traslado_config_t *cfg, int32_t pulsos,
+                       const traslado_posicion_t *p);
+
+/**
+ * @brief Copia la posición actual del traslado.
+ *
+ * @param t Estado del planificador.
+ * @param p Recibe la posición.
+ */
+void traslado_posicion(const traslado_t *t, traslado_posicion_t *p);
+
+/**
+ * @brief Cambia el patrón del traslado en marcha (segmento nuevo de un trabajo).
+ *
+ * El nuevo paso rige desde el pulso siguiente. Al invertir el sentido se hace una pausa
+ * como en un borde, para recuperar el juego mecánico.
+ * @param t Traslado.
+ * @param paso_mgrad_vuelta Nuevo avance del traslado por vuelta del tambor.
+ * @param invertir Invierte el sentido del traslado.
+ */
+void traslado_patron(traslado_t *t, int32_t paso_mgrad_vuelta, bool invertir);
+
+#endif // TRASLADO_H
@@ -0,0 +1,100 @@
+/**
+ * @file traza.c
+ * @brief Implementación de la traza de los sensores.
+ *
+ * `escritos` cuenta todos los eventos grabados desde `traza_iniciar()`: el más antiguo
+ * conservado está en `escritos - cantidad`, de modo que grabar nunca mueve los demás.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "traza.h"
+
+static traza_evento_t eventos[TRAZA_EVENTOS]; ///< Cola circular de eventos.
+static volatile uint32_t escritos = 0;        ///< Eventos grabados o cargados.
+static volatile bool congelada = false;       ///< No se graba.
+static volatile bool cargando = false;        ///< Se está cargando una traza del PC.
+static volatile bool reproduciendo = false;   ///< Los eventos reemplazan a los sensores.
+static volatile uint32_t reproducidos = 0;    ///< Eventos ya entregados en la reproducción.
+static traza_cabecera_t cabecera_traza;       ///< Calibración con que se grabó.
+
+void traza_iniciar(const traza_cabecera_t *cabecera) {
+    reproduciendo = false;
+    cargando = false;
+    escritos = 0;
+    cabecera_traza = *cabecera;
+    congelada = false;
+}
+
+traza_cabecera_t traza_cabecera(void) {
+    return cabecera_traza;
+}
+
+void traza_anotar(traza_tipo_t tipo, uint8_t canal, int32_t valor, uint32_t t_us) {
+    if (congelada || reproduciendo) return;
+    uint32_t e = escritos;
+    eventos[e % TRAZA_EVENTOS] = traza_evento(tipo, canal, valor, t_us);
+    escritos = e + 1;
+}
+
+void traza_congelar(void) {
+    congelada = true;
+}
+
+bool traza_congelada(void) {
+    return congelada;
+}
+
+uint32_t traza_cantidad(void) {
+    uint32_t e = escritos;
+    return e < TRAZA_EVENTOS ? e : TRAZA_EVENTOS;
+}
+
+bool traza_leer(uint32_t n, traza_evento_t *e) {
+    uint32_t cantidad = traza_cantidad();
+    if (n >= cantidad) return false;
+    *e = eventos[(escritos - cantidad + n) % TRAZA_EVENTOS];
+    return true;
+}
+
+bool traza_cargar(uint32_t n, const traza_evento_t *e) {
+    if (reproduciendo || n >= TRAZA_EVENTOS) return false;
+    if (n == 0) {
+        congelada = true;
+        cargando = true;
+        escritos = 0;
+        cabecera_traza = (traza_cabecera_t){ 0, 0 };
+    }
+    if (!cargando || n > escritos) return false; // La posición 0 no llegó o falta una anterior
+    eventos[n] = *e;
+    if (n == escritos) escritos = n + 1;
+    return true;
+}
+
+bool traza_reproducir(void) {
+    if (traza_cantidad() == 0) return false;
+    congelada = true;
+    cargando = false;
+    reproducidos = 0;
+    reproduciendo = true;
+    return true;
+}
+
+bool traza_reproduciendo(void) {
+    return reproduciendo;
+}
+
+bool traza_proximo(traza_evento_t *e) {
+    return reproduciendo && traza_leer(reproducidos, e);
+}
+
+bool traza_siguiente(traza_evento_t *e) {
+    if (!traza_proximo(e)) return false;
+    reproducidos++;
+    return true;
+}
+
+void traza_terminar(void) {
+    reproduciendo = false;
+}
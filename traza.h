@@ -0,0 +1,177 @@
+/**
+ * @file traza.h
+ * @brief Traza de los sensores crudos, para grabar en planta y reproducir en el banco.
+ *
+ * Guarda en la RAM los eventos de los sensores tal como llegan: cada flanco del encoder
+ * óptico, cada lectura cruda de los HX711 y cada cambio del interruptor SW, con su
+ * instante. La cola es circular: se conservan los últimos `TRAZA_EVENTOS` y al congelarla
+ * (al disparar una falla) quedan los segundos que llevaron a ella. El PC la descarga por el
+ * USB (`TELEMETRIA_TRAZA`) y puede volver a cargarla (`REMOTO_CARGAR_TRAZA`).
+ *
+ * La traza lleva una cabecera con la calibración con que se grabó (tara de la celda
+ * principal, pulsos por vuelta), que va con el volcado: sin ella las tensiones y
+ * velocidades de la reproducción en el PC no coincidirían con las del equipo.
+ *
+ * Al reproducir, los eventos se entregan en orden con sus instantes originales y reemplazan
+ * a los sensores: el mismo código de control ve las mismas entradas que en planta.
+ *
+ * tools/traza_reproducir.c reproduce una traza descargada en el PC, con los mismos módulos de
+ * control que no dependen del SDK.
+ *
+ * El módulo no depende del SDK ni se protege solo:
+ * quien escriba desde el bucle principal y desde interrupciones debe hacerlo con las
+ * interrupciones desactivadas (ver `trazar()` en Final_dig.c).
+ */
+
+#ifndef TRAZA_H
+#define TRAZA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TRAZA_EVENTOS 4096 ///< Eventos guardados (potencia de 2): 32 KB, unos 8 s de bobinado a 300 rpm.
+
+/**
+ * @brief Sensor que originó el evento.
+ */
+typedef enum {
+    TRAZA_ENCODER = 1, ///< Flanco del encoder óptico del tambor (sin valor).
+    TRAZA_CELDA,       ///< Lectura cruda de un HX711: canal 0 = celda principal, 1 a 4 = hilos.
+    TRAZA_SW,          ///< Cambio del interruptor SW: valor 1 = presionado.
+} traza_tipo_t;
+
+/**
+ * @brief Evento guardado (8 bytes).
+ */
+typedef struct {
+    uint32_t t_us; ///< Instante del evento.
+    uint32_t dato; ///< Tipo (4 bits altos), canal (4 bits) y valor con signo (24 bits bajos).
+} traza_evento_t;
+
+/**
+ * @brief Calibración con que se grabó la traza.
+ */
+typedef struct {
+    int32_t tara;               ///< Lectura cruda sin carga de la celda principal.
+    uint16_t pulsos_por_vuelta; ///< Pulsos del encoder por vuelta del tambor (0 = desconocida).
+} traza_cabecera_t;
+
+/**
+ * @brief Arma un evento.
+ */
+static inline traza_evento_t traza_evento(traza_tipo_t tipo, uint8_t canal, int32_t valor, uint32_t t_us) {
+    traza_evento_t e = { t_us, (uint32_t)tipo << 28 | (uint32_t)(canal & 0xF) << 24 | ((uint32_t)valor & 0xFFFFFF) };
+    return e;
+}
+
+/**
+ * @brief Devuelve el tipo de un evento (`traza_tipo_t`).
+ */
+static inline uint8_t traza_tipo(const traza_evento_t *e) {
+    return (uint8_t)(e->dato >> 28);
+}
+
+/**
+ * @brief Devuelve el canal de un evento.
+ */
+static inline uint8_t traza_canal(const traza_evento_t *e) {
+    return (uint8_t)((e->dato >> 24) & 0xF);
+}
+
+/**
+ * @brief Devuelve el valor de un evento, con signo (las lecturas del HX711 son de 24 bits).
+ */
+static inline int32_t traza_valor(const traza_evento_t *e) {
+    return (int32_t)(e->dato << 8) >> 8;
+}
+
+/**
+ * @brief Vacía la traza y empieza a grabar.
+ *
+ * @param cabecera Calibración actual (se copia).
+ */
+void traza_iniciar(const traza_cabecera_t *cabecera);
+
+/**
+ * @brief Devuelve la cabecera de la traza guardada.
+ */
+traza_cabecera_t traza_cabecera(void);
+
+/**
+ * @brief Graba un evento; no hace nada con la traza congelada o reproduciéndose.
+ *
+ * @param tipo Sensor.
+ * @param canal Canal del sensor (0 a 15).
+ * @param valor Valor (se guardan los 24 bits bajos).
+ * @param t_us Instante del evento.
+ */
+void traza_anotar(traza_tipo_t tipo, uint8_t canal, int32_t valor, uint32_t t_us);
+
+/**
+ * @brief Deja de grabar y conserva lo grabado hasta `traza_iniciar()`.
+ */
+void traza_congelar(void);
+
+/**
+ * @brief Indica si la traza está congelada.
+ */
+bool traza_congelada(void);
+
+/**
+ * @brief Devuelve los eventos guardados.
+ */
+uint32_t traza_cantidad(void);
+
+/**
+ * @brief Lee un evento guardado.
+ *
+ * @param n Posición, desde el más antiguo (0).
+ * @param e Recibe el evento.
+ * @return `false` si no hay tantos eventos.
+ */
+bool traza_leer(uint32_t n, traza_evento_t *e);
+
+/**
+ * @brief Carga un evento de una traza enviada por el PC; congela la traza.
+ *
+ * La carga empieza en la posición 0, que vacía la traza y deja la cabecera desconocida, y
+ * sigue en orden. Volver a cargar una posición ya cargada la reemplaza (el PC reintenta las
+ * órdenes sin respuesta).
+ * @param n Posición del evento.
+ * @param e Evento.
+ * @return `false` si la posición no sigue a las cargadas o se está reproduciendo.
+ */
+bool traza_cargar(uint32_t n, const traza_evento_t *e);
+
+/**
+ * @brief Empieza a reproducir la traza desde el evento más antiguo; la congela.
+ *
+ * @return `false` si la traza está vacía.
+ */
+bool traza_reproducir(void);
+
+/**
+ * @brief Indica si se está reproduciendo la traza.
+ */
+bool traza_reproduciendo(void);
+
+/**
+ * @brief Consulta el próximo evento de la reproducción sin sacarlo.
+ *
+ * @return `false` si ya se reprodujeron todos.
+ */
+bool traza_proximo(traza_evento_t *e);
+
+/**
+ * @brief Saca el próximo evento de la reproducción.
+ *
+ * @return `false` si ya se reprodujeron todos.
+ */
+bool traza_siguiente(traza_evento_t *e);
+
+/**
+ * @brief Termina la reproducción; la traza sigue congelada y se puede volver a reproducir.
+ */
+void traza_terminar(void);
+
+#endif // TRAZA_H
@@ -0,0 +1,68 @@
+/**
+ * @file velocidad.c
+ * @brief Implementación del planificador de velocidad con bandas prohibidas.
+ *
+ * La velocidad comandada se lleva escalada por 10⁶ (rampa en milésimas/s por tick en µs)
+ * para que las rampas lentas avancen aunque el tick sea corto.
+ *
+ * @authors Gabriel Restrepo, Andrés Rodríguez, Alejandro Petit
+ * @date 17 de julio de 2025
+ */
+
+#include "velocidad.h"
+#include <stddef.h>
+#include "motor.h"
+#include "resonancia.h"
+
+#define VELOCIDAD_ESCALA 1000000 ///< Escala interna de la velocidad comandada.
+
+static velocidad_config_t cfg_velocidad; ///< Parámetros del planificador.
+static int64_t actual = 0;               ///< Velocidad comandada (escalada).
+static uint16_t objetivo_vel = 0;        ///< Velocidad objetivo ajustada a las bandas.
+
+void velocidad_iniciar(const velocidad_config_t *cfg) {
+    cfg_velocidad = *cfg;
+}
+
+uint16_t velocidad_permitida(uint16_t objetivo, bool por_encima) {
+    if (objetivo > MOTOR_VELOCIDAD_MAX) objetivo = MOTOR_VELOCIDAD_MAX;
+    const resonancia_banda_t *b = resonancia_banda(objetivo);
+    if (b == NULL) return objetivo;
+    if (por_encima && b->hasta < MOTOR_VELOCIDAD_MAX) return b->hasta + 1;
+    return b->desde > 0 ? b->desde - 1 : 0; // Nunca se trabaja dentro de una banda
+}
+
+void velocidad_objetivo(uint16_t objetivo) {
+    objetivo_vel = velocidad_permitida(objetivo, false);
+}
+
+void velocidad_arrancar(uint16_t objetivo) {
+    velocidad_objetivo(objetivo);
+    uint16_t inicio = cfg_velocidad.arranque < objetivo_vel ? cfg_velocidad.arranque : objetivo_vel;
+    actual = (int64_t)inicio * VELOCIDAD_ESCALA;
+    motor_encender(inicio);
+}
+
+uint16_t velocidad_objetivo_actual(void) {
+    return objetivo_vel;
+}
+
+bool velocidad_en_rampa(void) {
+    return actual != (int64_t)objetivo_vel * VELOCIDAD_ESCALA;
+}
+
+uint16_t velocidad_actualizar(uint32_t dt_us) {
+    int64_t meta = (int64_t)objetivo_vel * VELOCIDAD_ESCALA;
+    if (actual == meta) return objetivo_vel;
+
+    uint16_t comandada = (uint16_t)(actual / VELOCIDAD_ESCALA);
+    uint32_t rampa = resonancia_banda(comandada) ? cfg_velocidad.rampa_rapida : cfg_velocidad.rampa;
+    int64_t paso = (int64_t)rampa * dt_us;
+
+    if (actual < meta) {
+        actual = (meta - actual > paso) ? actual + paso : meta;
+    } else {
+        actual = (actual - meta > paso) ? actual - paso : meta;
+    }
+    return (uint16_t)(actual / VELOCIDAD_ESCALA);
+}
@@ -0,0 +1,81 @@
+/**
+ * @file velocidad.h
+ * @brief Planificador de velocidad del tambor: rampas y bandas resonantes prohibidas.
+ *
+ * El motor ya no salta a su velocidad final: arranca a una velocidad mínima de giro y
+ * sube en rampa hasta el objetivo. Dentro de una banda resonante (ver resonancia.h) la
+ * rampa es rápida, y un objetivo que cae dentro de una banda se rebaja a su borde inferior,
+ * de modo que el tambor cruza las resonancias sin detenerse en ellas y puede trabajar por
+ * encima de la primera.
+ *
+ * Las velocidades se expresan en milésimas del PWM del motor (ver motor.h).
+ */
+
+#ifndef VELOCIDAD_H
+#define VELOCIDAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Parámetros del planificador.
+ */
+typedef struct {
+    uint16_t arranque;      ///< Velocidad inicial de la rampa (mínima que mueve el tambor).
+    uint16_t rampa;         ///< Rampa normal en milésimas por segundo.
+    uint16_t rampa_rapida;  ///< Rampa dentro de una banda resonante en milésimas por segundo.
+} velocidad_config_t;
+
+/**
+ * @brief Configura el planificador.
+ *
+ * @param cfg Parámetros (se copian).
+ */
+void velocidad_iniciar(const velocidad_config_t *cfg);
+
+/**
+ * @brief Enciende el motor a la velocidad de arranque y fija el objetivo.
+ *
+ * @param objetivo Velocidad final deseada.
+ */
+void velocidad_arrancar(uint16_t objetivo);
+
+/**
+ * @brief Saca una velocidad de las bandas resonantes.
+ *
+ * @param objetivo Velocidad deseada (se limita a `MOTOR_VELOCIDAD_MAX`).
+ * @param por_encima Si cae en una banda, pasar a su borde superior en lugar del inferior
+ *        (si la banda llega al máximo se usa igualmente el inferior).
+ * @return La velocidad fuera de toda banda.
+ */
+uint16_t velocidad_permitida(uint16_t objetivo, bool por_encima);
+
+/**
+ * @brief Cambia la velocidad objetivo; la rampa la alcanzará en los próximos ticks.
+ *
+ * Un objetivo dentro de una banda resonante se rebaja a su borde inferior.
+ * @param objetivo Velocidad deseada.
+ */
+void velocidad_objetivo(uint16_t objetivo);
+
+/**
+ * @brief Devuelve la velocidad objetivo vigente (ya ajustada a las bandas).
+ */
+uint16_t velocidad_objetivo_actual(void);
+
+/**
+ * @brief Indica si la rampa aún no alcanzó el objetivo.
+ */
+bool velocidad_en_rampa(void);
+
+/**
+ * @brief Avanza la rampa; se llama en cada tick de control.
+ *
+ * No escribe en el motor: la velocidad devuelve la referencia que el lazo de velocidad
+ * corrige (o que se aplica tal cual en lazo abierto).
+ * @param dt_us Tiempo desde el tick anterior.
+ * @return Velocidad de referencia en milésimas.
+ */
+uint16_t velocidad_actualizar(uint32_t dt_us);
+
+#endif // VELOCIDAD_H